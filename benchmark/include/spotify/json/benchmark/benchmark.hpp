@@ -18,6 +18,9 @@
 
 #include <chrono>
 #include <iostream>
+#include <string>
+
+#include <spotify/json/instruction_set.hpp>
 
 template <typename test_fn>
 void benchmark(const char *name, const size_t count, const test_fn &test) {
@@ -41,3 +44,27 @@ void benchmark(const char *name, const size_t count, const test_fn &test) {
 
 #define JSON_BENCHMARK(n, test) \
   benchmark(typeid(*this).name(), static_cast<size_t>(n), (test))
+
+/**
+ * Run the benchmark once for each instruction set that is supported on this
+ * machine, so that the kernels for them can be compared side by side.
+ */
+template <typename test_fn>
+void benchmark_each_instruction_set(const char *name, const size_t count, const test_fn &test) {
+  using namespace spotify::json;
+  const auto original = active_instruction_set();
+  for (const auto isa : {
+      instruction_set::scalar,
+      instruction_set::sse42,
+      instruction_set::avx2,
+      instruction_set::avx512bw }) {
+    if (use_instruction_set(isa)) {
+      const auto isa_name = std::string(name) + " [" + instruction_set_name(isa) + "]";
+      benchmark(isa_name.c_str(), count, test);
+    }
+  }
+  use_instruction_set(original);
+}
+
+#define JSON_BENCHMARK_EACH_INSTRUCTION_SET(n, test) \
+  benchmark_each_instruction_set(typeid(*this).name(), static_cast<size_t>(n), (test))
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/chunked_decoder.hpp>
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/codec/map.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/decode.hpp>
+
+#include <spotify/json/benchmark/benchmark.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+
+namespace {
+
+using value_type = std::vector<std::map<std::string, std::string>>;
+
+/**
+ * A document of about 100 kB, split into chunks of the size of the payload of
+ * an Ethernet frame, the way it would arrive from a network stream.
+ */
+std::vector<std::string> generate_chunks() {
+  std::string json = "[";
+  for (size_t i = 0; i < 1000; i++) {
+    json += (i ? "," : "");
+    json += "{\"uri\":\"spotify:track:" + std::to_string(i) + "\",";
+    json += "\"name\":\"Track \\\"" + std::to_string(i) + "\\\"\",";
+    json += "\"album\":\"spotify:album:" + std::to_string(i / 10) + "\"}";
+  }
+  json += "]";
+
+  std::vector<std::string> chunks;
+  for (size_t offset = 0; offset < json.size(); offset += 1460) {
+    chunks.push_back(json.substr(offset, 1460));
+  }
+  return chunks;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(benchmark_json_chunked_decoder_concatenate_and_decode) {
+  const auto chunks = generate_chunks();
+  const auto codec = default_codec<value_type>();
+  volatile size_t n = 0;
+  JSON_BENCHMARK_EACH_INSTRUCTION_SET(1e3, [&]{
+    std::string json;
+    for (const auto &chunk : chunks) {
+      json += chunk;
+    }
+    n += json::decode(codec, json).size();
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_chunked_decoder_append) {
+  const auto chunks = generate_chunks();
+  const auto codec = default_codec<value_type>();
+  volatile size_t n = 0;
+  JSON_BENCHMARK_EACH_INSTRUCTION_SET(1e3, [&]{
+    auto decoder = make_chunked_decoder(codec);
+    for (const auto &chunk : chunks) {
+      decoder.append(chunk);
+    }
+    decoder.finish();
+    n += decoder.value().size();
+  });
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
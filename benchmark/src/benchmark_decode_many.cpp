@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/map.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/decode.hpp>
+#include <spotify/json/decode_many.hpp>
+#include <spotify/json/thread_pool.hpp>
+
+#include <spotify/json/benchmark/benchmark.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+
+namespace {
+
+using message_type = std::map<std::string, std::string>;
+
+/**
+ * A batch of small messages of different sizes, like those of a Kafka topic.
+ */
+std::vector<std::string> generate_batch() {
+  std::vector<std::string> batch;
+  for (size_t i = 0; i < 5000; i++) {
+    batch.push_back(
+        "{\"uri\":\"spotify:track:" + std::to_string(i) + "\"," +
+        "\"event\":\"play\",\"payload\":\"" + std::string(i % 500, 'x') + "\"}");
+  }
+  return batch;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(benchmark_json_decode_many_sequential) {
+  const auto batch = generate_batch();
+  const auto codec = default_codec<message_type>();
+  volatile size_t n = 0;
+  JSON_BENCHMARK(100, [&]{
+    std::vector<message_type> results;
+    results.reserve(batch.size());
+    for (const auto &message : batch) {
+      results.push_back(json::decode(codec, message));
+    }
+    n += results.size();
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_decode_many) {
+  const auto batch = generate_batch();
+  const auto codec = default_codec<message_type>();
+  thread_pool pool;
+  volatile size_t n = 0;
+  JSON_BENCHMARK(100, [&]{
+    n += decode_many(codec, batch, pool).size();
+  });
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/codec/map.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/decode.hpp>
+#include <spotify/json/decode_parallel.hpp>
+#include <spotify/json/thread_pool.hpp>
+
+#include <spotify/json/benchmark/benchmark.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+
+namespace {
+
+using message_type = std::map<std::string, std::string>;
+
+/**
+ * One large array of small objects, like an export of a table.
+ */
+std::string generate_export() {
+  std::string json = "[";
+  for (size_t i = 0; i < 50000; i++) {
+    json += (i ? ",\n" : "");
+    json += "{\"uri\":\"spotify:track:" + std::to_string(i) + "\"," +
+        "\"event\":\"play\",\"payload\":\"" + std::string(i % 500, 'x') + "\"}";
+  }
+  return json + "]";
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(benchmark_json_decode_parallel_sequential) {
+  const auto json = generate_export();
+  const auto codec = default_codec<std::vector<message_type>>();
+  volatile size_t n = 0;
+  JSON_BENCHMARK(10, [&]{
+    n += json::decode(codec, json).size();
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_decode_parallel) {
+  const auto json = generate_export();
+  const auto codec = default_codec<std::vector<message_type>>();
+  thread_pool pool;
+  volatile size_t n = 0;
+  JSON_BENCHMARK(10, [&]{
+    n += decode_parallel(codec, json, pool).size();
+  });
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
@@ -56,59 +56,25 @@ BOOST_AUTO_TEST_CASE(benchmark_json_detail_write_escaped_simple_string) {
   const auto begin = input.data();
 
   volatile size_t n = 0;
-  JSON_BENCHMARK(1e5, [&] {
+  JSON_BENCHMARK_EACH_INSTRUCTION_SET(1e5, [&] {
     encode_context context;
-    *const_cast<bool *>(&context.has_sse42) = false;
     write_escaped(context, begin, begin + input.size());
     n += context.size();
   });
 }
 
-#if defined(json_arch_x86_sse42)
-
-BOOST_AUTO_TEST_CASE(benchmark_json_detail_write_escaped_simple_string_sse42) {
-  const auto input = generate_string(8192, false);
-  const auto begin = input.data();
-
-  volatile size_t n = 0;
-  JSON_BENCHMARK(1e5, [&] {
-    encode_context context;
-    write_escaped(context, begin, begin + input.size());
-    n += context.size();
-  });
-}
-
-#endif  // defined(json_arch_x86_sse42)
-
 BOOST_AUTO_TEST_CASE(benchmark_json_detail_write_escaped_complex_string) {
   const auto input = generate_string(8192, true);
   const auto begin = input.data();
 
   volatile size_t n = 0;
-  JSON_BENCHMARK(1e5, [&] {
+  JSON_BENCHMARK_EACH_INSTRUCTION_SET(1e5, [&] {
     encode_context context;
-    *const_cast<bool *>(&context.has_sse42) = false;
     write_escaped(context, begin, begin + input.size());
     n += context.size();
   });
 }
 
-#if defined(json_arch_x86_sse42)
-
-BOOST_AUTO_TEST_CASE(benchmark_json_detail_write_escaped_complex_string_sse42) {
-  const auto input = generate_string(8192, true);
-  const auto begin = input.data();
-
-  volatile size_t n = 0;
-  JSON_BENCHMARK(1e5, [&] {
-    encode_context context;
-    write_escaped(context, begin, begin + input.size());
-    n += context.size();
-  });
-}
-
-#endif  // defined(json_arch_x86_sse42)
-
 BOOST_AUTO_TEST_SUITE_END()  // detail
 BOOST_AUTO_TEST_SUITE_END()  // json
 BOOST_AUTO_TEST_SUITE_END()  // spotify
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/map.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/decode.hpp>
+#include <spotify/json/ndjson_reader.hpp>
+
+#include <spotify/json/benchmark/benchmark.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+
+namespace {
+
+using record_type = std::map<std::string, std::string>;
+
+const char *const ndjson_path = "json_benchmark_ndjson_reader.ndjson";
+
+/**
+ * Write a log file of about 20 MB, with one small object per line.
+ */
+void write_log_file() {
+  std::ofstream file(ndjson_path, std::ios::binary);
+  for (size_t i = 0; i < 200000; i++) {
+    file << "{\"uri\":\"spotify:track:" << i << "\",";
+    file << "\"event\":\"play\",\"client\":\"desktop " << (i % 7) << "\"}\n";
+  }
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(benchmark_json_ndjson_read_file_and_getline) {
+  write_log_file();
+  const auto codec = default_codec<record_type>();
+  volatile size_t n = 0;
+  JSON_BENCHMARK(10, [&]{
+    std::ifstream file(ndjson_path, std::ios::binary);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    std::string line;
+    while (std::getline(contents, line)) {
+      n += json::decode(codec, line).size();
+    }
+  });
+  std::remove(ndjson_path);
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_ndjson_reader) {
+  write_log_file();
+  const auto codec = default_codec<record_type>();
+  volatile size_t n = 0;
+  JSON_BENCHMARK(10, [&]{
+    ndjson_reader<decltype(codec)> reader(codec, ndjson_path);
+    record_type record;
+    while (reader.next(record)) {
+      n += record.size();
+    }
+  });
+  std::remove(ndjson_path);
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
@@ -14,12 +14,17 @@
  * the License.
  */
 
+#include <cstdio>
+#include <random>
 #include <string>
+#include <vector>
 
 #include <boost/test/unit_test.hpp>
 
+#include <spotify/json/codec/fixed_precision.hpp>
 #include <spotify/json/codec/number.hpp>
 #include <spotify/json/decode.hpp>
+#include <spotify/json/decode_context.hpp>
 #include <spotify/json/encode.hpp>
 #include <spotify/json/encode_context.hpp>
 
@@ -40,6 +45,17 @@ BOOST_AUTO_TEST_CASE(benchmark_json_codec_number_encode_positive_int32_t) {
   });
 }
 
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_number_encode_small_int32_t) {
+  const auto codec = number<int32_t>();
+  JSON_BENCHMARK(1e6, [=]{
+    auto context = encode_context();
+    for (int32_t i = -500; i < 1000; i += 7) {
+      codec.encode(context, i);
+      context.clear();
+    }
+  });
+}
+
 BOOST_AUTO_TEST_CASE(benchmark_json_codec_number_encode_positive_uint32_t) {
   const auto codec = number<uint32_t>();
   JSON_BENCHMARK(1e6, [=]{
@@ -73,6 +89,164 @@ BOOST_AUTO_TEST_CASE(benchmark_json_codec_number_encode_positive_uint64_t) {
   });
 }
 
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_number_encode_negative_int64_t) {
+  const auto codec = number<int64_t>();
+  JSON_BENCHMARK(1e6, [=]{
+    auto context = encode_context();
+    for (int64_t i = -10000000; i < 10000000; i += 96142) {
+      codec.encode(context, i);
+      context.clear();
+    }
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_number_encode_timestamp_int64_t) {
+  const auto codec = number<int64_t>();
+  JSON_BENCHMARK(1e6, [=]{
+    auto context = encode_context();
+    for (int64_t i = 1700000000000; i < 1700010000000; i += 48071) {
+      codec.encode(context, i);
+      context.clear();
+    }
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_number_encode_id_uint64_t) {
+  const auto codec = number<uint64_t>();
+  JSON_BENCHMARK(1e6, [=]{
+    auto context = encode_context();
+    for (uint64_t i = 1000000000000000000; i < 1000000000010000000; i += 48071) {
+      codec.encode(context, i);
+      context.clear();
+    }
+  });
+}
+
+namespace {
+
+/**
+ * Decode all of the comma-terminated numbers in json.
+ */
+template <typename codec_type>
+size_t decode_all(const codec_type &codec, const std::string &json) {
+  size_t n = 0;
+  auto context = decode_context(json.data(), json.data() + json.size());
+  for (; context.remaining(); context.position++) {  // Skip the ','
+    n += (codec.decode(context) > 0);
+  }
+  return n;
+}
+
+/**
+ * Comma-terminated floating point numbers of the kinds that are common in
+ * real-world JSON: coordinates, prices, ratios, numbers in scientific notation
+ * and doubles written with all of their digits.
+ */
+std::string floating_point_corpus() {
+  std::mt19937 random(1);
+  std::uniform_real_distribution<double> uniform(0.0, 1.0);
+  std::string json;
+  char buffer[32];
+  for (int i = 0; i < 10000; i++) {
+    const auto x = uniform(random);
+    switch (i % 5) {
+      case 0: std::snprintf(buffer, sizeof(buffer), "%.7f,", x * 360.0 - 180.0); break;
+      case 1: std::snprintf(buffer, sizeof(buffer), "%.2f,", x * 1000.0); break;
+      case 2: std::snprintf(buffer, sizeof(buffer), "%.4f,", x); break;
+      case 3: std::snprintf(buffer, sizeof(buffer), "%.5e,", x * 1e-3); break;
+      case 4: std::snprintf(buffer, sizeof(buffer), "%.17g,", x); break;
+    }
+    json += buffer;
+  }
+  return json;
+}
+
+template <typename T>
+std::vector<T> floating_point_corpus_values() {
+  const auto codec = number<T>();
+  const auto json = floating_point_corpus();
+  std::vector<T> values;
+  auto context = decode_context(json.data(), json.data() + json.size());
+  for (; context.remaining(); context.position++) {  // Skip the ','
+    values.push_back(codec.decode(context));
+  }
+  return values;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_number_decode_small_int32_t) {
+  const auto codec = number<int32_t>();
+  const std::string json = "1,22,333,4444,55555,666666,7777777,88888888,4,42,17,100,";
+  volatile size_t n = 0;
+  JSON_BENCHMARK(1e6, [&]{ n += decode_all(codec, json); });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_number_decode_timestamp_int64_t) {
+  const auto codec = number<int64_t>();
+  const std::string json =
+      "1700000000000,1700000000001,1700000012345,1700000123456,"
+      "1700001234567,1700012345678,1700123456789,1701234567890,";
+  volatile size_t n = 0;
+  JSON_BENCHMARK(1e6, [&]{ n += decode_all(codec, json); });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_number_decode_id_uint64_t) {
+  const auto codec = number<uint64_t>();
+  const std::string json =
+      "1234567890123456789,9876543210987654321,1111111111111111111,"
+      "5555555555555555555,1000000000000000000,9999999999999999999,";
+  volatile size_t n = 0;
+  JSON_BENCHMARK(1e6, [&]{ n += decode_all(codec, json); });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_number_decode_corpus_float) {
+  const auto codec = number<float>();
+  const auto json = floating_point_corpus();
+  volatile size_t n = 0;
+  JSON_BENCHMARK(1e3, [&]{ n += decode_all(codec, json); });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_number_decode_corpus_double) {
+  const auto codec = number<double>();
+  const auto json = floating_point_corpus();
+  volatile size_t n = 0;
+  JSON_BENCHMARK(1e3, [&]{ n += decode_all(codec, json); });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_number_encode_corpus_float) {
+  const auto codec = number<float>();
+  const auto values = floating_point_corpus_values<float>();
+  JSON_BENCHMARK(1e3, [&]{
+    auto context = encode_context();
+    for (const auto value : values) {
+      codec.encode(context, value);
+    }
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_number_encode_corpus_double) {
+  const auto codec = number<double>();
+  const auto values = floating_point_corpus_values<double>();
+  JSON_BENCHMARK(1e3, [&]{
+    auto context = encode_context();
+    for (const auto value : values) {
+      codec.encode(context, value);
+    }
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_fixed_precision_encode_corpus_double) {
+  const auto codec = fixed_precision<double>(6);
+  const auto values = floating_point_corpus_values<double>();
+  JSON_BENCHMARK(1e3, [&]{
+    auto context = encode_context();
+    for (const auto value : values) {
+      codec.encode(context, value);
+    }
+  });
+}
+
 BOOST_AUTO_TEST_SUITE_END()  // codec
 BOOST_AUTO_TEST_SUITE_END()  // json
 BOOST_AUTO_TEST_SUITE_END()  // spotify
@@ -84,6 +84,15 @@ BOOST_AUTO_TEST_CASE(benchmark_json_codec_object_decode_with_many_required_field
   });
 }
 
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_object_decode_minified) {
+  const auto codec = required_codec(50);
+  const auto json = make_json(50);
+
+  JSON_BENCHMARK(1e5, [=]{
+    decode(codec, json);
+  });
+}
+
 BOOST_AUTO_TEST_SUITE_END()  // codec
 BOOST_AUTO_TEST_SUITE_END()  // json
 BOOST_AUTO_TEST_SUITE_END()  // spotify
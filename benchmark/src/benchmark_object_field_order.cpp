@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2018 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/codec/object.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/decode_context.hpp>
+
+#include <spotify/json/benchmark/benchmark.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+BOOST_AUTO_TEST_SUITE(codec)
+
+namespace {
+
+struct track_t {
+  std::string uri;
+  std::string name;
+  std::string album_uri;
+  std::string artist_uri;
+  int64_t duration_ms = 0;
+  int64_t disc_number = 0;
+  int64_t track_number = 0;
+  int64_t popularity = 0;
+  std::string preview_url;
+  std::string isrc;
+  int64_t added_at = 0;
+  std::string added_by;
+};
+
+object_t<track_t> track_codec() {
+  auto codec = object<track_t>();
+  codec.optional("uri", &track_t::uri);
+  codec.optional("name", &track_t::name);
+  codec.optional("album_uri", &track_t::album_uri);
+  codec.optional("artist_uri", &track_t::artist_uri);
+  codec.optional("duration_ms", &track_t::duration_ms);
+  codec.optional("disc_number", &track_t::disc_number);
+  codec.optional("track_number", &track_t::track_number);
+  codec.optional("popularity", &track_t::popularity);
+  codec.optional("preview_url", &track_t::preview_url);
+  codec.optional("isrc", &track_t::isrc);
+  codec.optional("added_at", &track_t::added_at);
+  codec.optional("added_by", &track_t::added_by);
+  return codec;
+}
+
+const std::vector<std::string> &track_fields() {
+  static const std::vector<std::string> fields = {
+    R"("uri":"spotify:track:6rqhFgbbKwnb9MLmUQDhG6")",
+    R"("name":"Speak to Me")",
+    R"("album_uri":"spotify:album:4LH4d3cOWNNsVw41Gqt2kv")",
+    R"("artist_uri":"spotify:artist:0k17h0D3J5VfsdmQ1iZtE9")",
+    R"("duration_ms":90173)",
+    R"("disc_number":1)",
+    R"("track_number":1)",
+    R"("popularity":61)",
+    R"("preview_url":"https://p.scdn.co/mp3-preview/a2d2")",
+    R"("isrc":"GBN9Y1100088")",
+    R"("added_at":1514764800000)",
+    R"("added_by":"spotify")"
+  };
+  return fields;
+}
+
+std::string make_json(const std::vector<size_t> &order) {
+  std::string json = "{";
+  for (const auto idx : order) {
+    json += track_fields()[idx];
+    json += ',';
+  }
+  json.back() = '}';
+  return json;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_object_decode_fields_in_order) {
+  const auto codec = track_codec();
+  const auto json = make_json({ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11 });
+
+  JSON_BENCHMARK(1e6, [=]{
+    auto context = decode_context(json.data(), json.data() + json.size());
+    codec.decode(context);
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_object_decode_fields_shuffled) {
+  const auto codec = track_codec();
+  const auto json = make_json({ 7, 2, 10, 0, 5, 11, 3, 8, 1, 6, 9, 4 });
+
+  JSON_BENCHMARK(1e6, [=]{
+    auto context = decode_context(json.data(), json.data() + json.size());
+    codec.decode(context);
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_object_decode_fields_sparse) {
+  const auto codec = track_codec();
+  const auto json = make_json({ 0, 3, 4, 8, 11 });
+
+  JSON_BENCHMARK(1e6, [=]{
+    auto context = decode_context(json.data(), json.data() + json.size());
+    codec.decode(context);
+  });
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // codec
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
@@ -19,8 +19,8 @@
 #include <boost/test/unit_test.hpp>
 
 #include <spotify/json/decode_context.hpp>
-#include <spotify/json/detail/macros.hpp>
 #include <spotify/json/detail/skip_chars.hpp>
+#include <spotify/json/detail/skip_value.hpp>
 
 #include <spotify/json/benchmark/benchmark.hpp>
 
@@ -45,27 +45,36 @@ std::string generate_simple_string(size_t size) {
 BOOST_AUTO_TEST_CASE(benchmark_json_detail_skip_any_simple_characters) {
   const auto json = generate_simple_string(8192);
   volatile size_t n = 0;
-  JSON_BENCHMARK(1e6, [&]{
+  JSON_BENCHMARK_EACH_INSTRUCTION_SET(1e6, [&]{
     auto context = decode_context(json.data(), json.data() + json.size());
-    *const_cast<bool *>(&context.has_sse42) = false;
     detail::skip_any_simple_characters(context);
     n += context.offset();
   });
 }
 
-#if defined(json_arch_x86_sse42)
-
-BOOST_AUTO_TEST_CASE(benchmark_json_detail_skip_any_simple_characters_sse42) {
-  const auto json = generate_simple_string(8192);
+/**
+ * Most strings are short, so the vector loop hardly runs and most bytes are
+ * read by the scalar code for the tail, unless the input is padded.
+ */
+BOOST_AUTO_TEST_CASE(benchmark_json_detail_skip_any_simple_characters_short) {
+  const auto json = generate_simple_string(20) + std::string(decode_padding, '"');
   volatile size_t n = 0;
-  JSON_BENCHMARK(1e6, [&]{
-    auto context = decode_context(json.data(), json.data() + json.size());
+  JSON_BENCHMARK_EACH_INSTRUCTION_SET(1e7, [&]{
+    auto context = decode_context(json.data(), json.data() + 20);
     detail::skip_any_simple_characters(context);
     n += context.offset();
   });
 }
 
-#endif  // defined(json_arch_x86_sse42)
+BOOST_AUTO_TEST_CASE(benchmark_json_detail_skip_any_simple_characters_short_padded) {
+  const auto json = generate_simple_string(20) + std::string(decode_padding, '"');
+  volatile size_t n = 0;
+  JSON_BENCHMARK_EACH_INSTRUCTION_SET(1e7, [&]{
+    auto context = decode_context(json.data(), json.data() + 20, decode_context::padded_input_t());
+    detail::skip_any_simple_characters(context);
+    n += context.offset();
+  });
+}
 
 std::string generate_whitespace_string(size_t size) {
   std::string string;
@@ -85,27 +94,44 @@ std::string generate_whitespace_string(size_t size) {
 BOOST_AUTO_TEST_CASE(benchmark_json_detail_skip_any_whitespace) {
   const auto json = generate_whitespace_string(8192);
   volatile size_t n = 0;
-  JSON_BENCHMARK(1e6, [&]{
+  JSON_BENCHMARK_EACH_INSTRUCTION_SET(1e6, [&]{
     auto context = decode_context(json.data(), json.data() + json.size());
-    *const_cast<bool *>(&context.has_sse42) = false;
     detail::skip_any_whitespace(context);
     n += context.offset();
   });
 }
 
-#if defined(json_arch_x86_sse42)
+std::string generate_nested_value(size_t objects) {
+  std::string json = "[";
+  for (size_t i = 0; i < objects; i++) {
+    json += (i ? "," : "");
+    json += R"({"id":)" + std::to_string(i) + R"(,"name":"item \")" + std::to_string(i) + R"(\"",)";
+    json += R"("tags":["a","b]"],"size":{"w":1.5,"h":-2e3},"ok":true,"next":null})";
+  }
+  json += "]";
+  return json;
+}
 
-BOOST_AUTO_TEST_CASE(benchmark_json_detail_skip_any_whitespace_sse42) {
-  const auto json = generate_whitespace_string(8192);
+BOOST_AUTO_TEST_CASE(benchmark_json_detail_skip_value) {
+  const auto json = generate_nested_value(100);
   volatile size_t n = 0;
-  JSON_BENCHMARK(1e6, [&]{
+  JSON_BENCHMARK(1e4, [&]{
     auto context = decode_context(json.data(), json.data() + json.size());
-    detail::skip_any_whitespace(context);
+    detail::skip_value(context);
     n += context.offset();
   });
 }
 
-#endif  // defined(json_arch_x86_sse42)
+BOOST_AUTO_TEST_CASE(benchmark_json_detail_skip_value_trusted) {
+  const auto json = generate_nested_value(100);
+  volatile size_t n = 0;
+  JSON_BENCHMARK_EACH_INSTRUCTION_SET(1e4, [&]{
+    auto context = decode_context(json.data(), json.data() + json.size());
+    context.trusted_input = true;
+    detail::skip_value(context);
+    n += context.offset();
+  });
+}
 
 BOOST_AUTO_TEST_SUITE_END()  // detail
 BOOST_AUTO_TEST_SUITE_END()  // json
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2018 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/codec/object.hpp>
+#include <spotify/json/codec/static_object.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/decode_context.hpp>
+#include <spotify/json/encode_context.hpp>
+
+#include <spotify/json/benchmark/benchmark.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+BOOST_AUTO_TEST_SUITE(codec)
+
+namespace {
+
+struct track_t {
+  std::string uri;
+  std::string name;
+  std::string album_uri;
+  int64_t duration_ms = 0;
+  int64_t disc_number = 0;
+  int64_t track_number = 0;
+  int64_t popularity = 0;
+  std::string isrc;
+};
+
+object_t<track_t> track_object_codec() {
+  auto codec = object<track_t>();
+  codec.required("uri", &track_t::uri);
+  codec.optional("name", &track_t::name);
+  codec.optional("album_uri", &track_t::album_uri);
+  codec.optional("duration_ms", &track_t::duration_ms);
+  codec.optional("disc_number", &track_t::disc_number);
+  codec.optional("track_number", &track_t::track_number);
+  codec.optional("popularity", &track_t::popularity);
+  codec.optional("isrc", &track_t::isrc);
+  return codec;
+}
+
+auto track_static_codec() -> decltype(static_object<track_t>(
+    required_field(json_static_key("uri"), &track_t::uri),
+    optional_field(json_static_key("name"), &track_t::name),
+    optional_field(json_static_key("album_uri"), &track_t::album_uri),
+    optional_field(json_static_key("duration_ms"), &track_t::duration_ms),
+    optional_field(json_static_key("disc_number"), &track_t::disc_number),
+    optional_field(json_static_key("track_number"), &track_t::track_number),
+    optional_field(json_static_key("popularity"), &track_t::popularity),
+    optional_field(json_static_key("isrc"), &track_t::isrc))) {
+  return static_object<track_t>(
+      required_field(json_static_key("uri"), &track_t::uri),
+      optional_field(json_static_key("name"), &track_t::name),
+      optional_field(json_static_key("album_uri"), &track_t::album_uri),
+      optional_field(json_static_key("duration_ms"), &track_t::duration_ms),
+      optional_field(json_static_key("disc_number"), &track_t::disc_number),
+      optional_field(json_static_key("track_number"), &track_t::track_number),
+      optional_field(json_static_key("popularity"), &track_t::popularity),
+      optional_field(json_static_key("isrc"), &track_t::isrc));
+}
+
+const std::string track_json = R"({)"
+    R"("uri":"spotify:track:6rqhFgbbKwnb9MLmUQDhG6",)"
+    R"("name":"Speak to Me",)"
+    R"("album_uri":"spotify:album:4LH4d3cOWNNsVw41Gqt2kv",)"
+    R"("duration_ms":90173,)"
+    R"("disc_number":1,)"
+    R"("track_number":1,)"
+    R"("popularity":61,)"
+    R"("isrc":"GBN9Y1100088")"
+    R"(})";
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_object_decode_track) {
+  const auto codec = track_object_codec();
+  const auto json = track_json;
+  JSON_BENCHMARK(1e6, [=]{
+    auto context = decode_context(json.data(), json.data() + json.size());
+    codec.decode(context);
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_static_object_decode_track) {
+  const auto codec = track_static_codec();
+  const auto json = track_json;
+  JSON_BENCHMARK(1e6, [=]{
+    auto context = decode_context(json.data(), json.data() + json.size());
+    codec.decode(context);
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_object_encode_track) {
+  const auto codec = track_object_codec();
+  auto context = decode_context(track_json.data(), track_json.data() + track_json.size());
+  const auto track = codec.decode(context);
+  JSON_BENCHMARK(1e6, [=]{
+    encode_context context;
+    codec.encode(context, track);
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_static_object_encode_track) {
+  const auto codec = track_static_codec();
+  auto context = decode_context(track_json.data(), track_json.data() + track_json.size());
+  const auto track = codec.decode(context);
+  JSON_BENCHMARK(1e6, [=]{
+    encode_context context;
+    codec.encode(context, track);
+  });
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // codec
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
@@ -19,6 +19,7 @@
 #include <boost/test/unit_test.hpp>
 
 #include <spotify/json/codec/string.hpp>
+#include <spotify/json/codec/string_view.hpp>
 #include <spotify/json/decode.hpp>
 #include <spotify/json/decode_exception.hpp>
 #include <spotify/json/encode.hpp>
@@ -76,6 +77,32 @@ BOOST_AUTO_TEST_CASE(benchmark_json_codec_string_decode_simple_tiny_string) {
   });
 }
 
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_string_view_decode_simple_long_string) {
+  const auto codec = default_codec<json::string_view>();
+  const auto json = generate_simple_json_string(10000);
+  const auto json_begin = json.data();
+  const auto json_end = json.data() + json.size();
+  volatile size_t n = 0;
+  JSON_BENCHMARK(1e5, [&]{
+    auto context = decode_context(json_begin, json_end);
+    n += codec.decode(context).size();
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_string_view_decode_simple_tiny_string) {
+  const auto codec = default_codec<json::string_view>();
+  const auto json = std::string("\"spotify:track:05341EWu6uHUg2BojF3Cyw\"");
+  const auto json_begin = json.data();
+  const auto json_end = json.data() + json.size();
+  volatile size_t n = 0;
+  JSON_BENCHMARK(1e5, [&]{
+    for (int i = 0; i < 100; i++) {
+      auto context = decode_context(json_begin, json_end);
+      n += codec.decode(context).size();
+    }
+  });
+}
+
 /*
  * Encoding
  */
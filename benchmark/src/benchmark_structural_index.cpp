@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+
+#include <string>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/detail/structural_index.hpp>
+
+#include <spotify/json/benchmark/benchmark.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+BOOST_AUTO_TEST_SUITE(detail)
+
+namespace {
+
+/**
+ * A pretty-printed array of objects, indented the way most tools write JSON,
+ * so that a large share of the input is whitespace.
+ */
+std::string generate_pretty_document(size_t objects) {
+  std::string json = "[\n";
+  for (size_t i = 0; i < objects; i++) {
+    json += "    {\n";
+    json += "        \"uri\": \"spotify:track:" + std::to_string(i) + "\",\n";
+    json += "        \"name\": \"Track \\\"" + std::to_string(i) + "\\\"\",\n";
+    json += "        \"album\": \"spotify:album:" + std::to_string(i / 10) + "\"\n";
+    json += (i + 1 < objects ? "    },\n" : "    }\n");
+  }
+  json += "]\n";
+  return json;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(benchmark_json_detail_structural_index_build) {
+  const auto json = generate_pretty_document(1000);
+  volatile size_t n = 0;
+  JSON_BENCHMARK_EACH_INSTRUCTION_SET(1e3, [&]{
+    const structural_index index(json.data(), json.data() + json.size());
+    n += index.offsets().size();
+  });
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // detail
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
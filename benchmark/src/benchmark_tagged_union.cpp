@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <memory>
+#include <string>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/cast.hpp>
+#include <spotify/json/codec/eq.hpp>
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/codec/object.hpp>
+#include <spotify/json/codec/one_of.hpp>
+#include <spotify/json/codec/smart_ptr.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/codec/tagged_union.hpp>
+#include <spotify/json/decode_context.hpp>
+#include <spotify/json/encode_context.hpp>
+
+#include <spotify/json/benchmark/benchmark.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+BOOST_AUTO_TEST_SUITE(codec)
+
+namespace {
+
+struct media_t {
+  virtual ~media_t() = default;
+  std::string uri;
+  std::string name;
+  int64_t duration_ms = 0;
+};
+
+struct track_t : media_t {
+  std::string album_uri;
+};
+
+struct episode_t : media_t {
+  std::string show_uri;
+};
+
+struct chapter_t : media_t {
+  std::string book_uri;
+};
+
+/**
+ * With one_of_t, each codec has to check the type itself. tagged_union_t does
+ * that before picking a codec, so its codecs do not have a type field.
+ */
+template <typename T>
+object_t<T> media_codec(const char *type, std::string T::*parent_uri, const char *parent_key) {
+  auto codec = object<T>();
+  if (type) {
+    codec.required("type", eq(std::string(type)));
+  }
+  codec.required("uri", &T::uri);
+  codec.optional("name", &T::name);
+  codec.optional("duration_ms", &T::duration_ms);
+  codec.optional(parent_key, parent_uri);
+  return codec;
+}
+
+auto one_of_codec() -> decltype(one_of(
+    cast<std::shared_ptr<media_t>>(shared_ptr(object<track_t>())),
+    cast<std::shared_ptr<media_t>>(shared_ptr(object<chapter_t>())),
+    cast<std::shared_ptr<media_t>>(shared_ptr(object<episode_t>())))) {
+  return one_of(
+      cast<std::shared_ptr<media_t>>(shared_ptr(
+          media_codec<track_t>("track", &track_t::album_uri, "album_uri"))),
+      cast<std::shared_ptr<media_t>>(shared_ptr(
+          media_codec<chapter_t>("chapter", &chapter_t::book_uri, "book_uri"))),
+      cast<std::shared_ptr<media_t>>(shared_ptr(
+          media_codec<episode_t>("episode", &episode_t::show_uri, "show_uri"))));
+}
+
+tagged_union_t<std::shared_ptr<media_t>> tagged_union_codec() {
+  auto codec = tagged_union<std::shared_ptr<media_t>>("type");
+  codec.add("track", media_codec<track_t>(nullptr, &track_t::album_uri, "album_uri"));
+  codec.add("chapter", media_codec<chapter_t>(nullptr, &chapter_t::book_uri, "book_uri"));
+  codec.add("episode", media_codec<episode_t>(nullptr, &episode_t::show_uri, "show_uri"));
+  return codec;
+}
+
+const std::string episode_json = R"({)"
+    R"("type":"episode",)"
+    R"("uri":"spotify:episode:512ojhOuo1ktJprKbVcKyQ",)"
+    R"("name":"Episode 1",)"
+    R"("duration_ms":2693000,)"
+    R"("show_uri":"spotify:show:5CfCWKI5pZ28U0uOzXkDHe")"
+    R"(})";
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_one_of_decode_polymorphic) {
+  const auto codec = one_of_codec();
+  const auto json = episode_json;
+  JSON_BENCHMARK(1e5, [=]{
+    auto context = decode_context(json.data(), json.data() + json.size());
+    codec.decode(context);
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_tagged_union_decode_polymorphic) {
+  const auto codec = tagged_union_codec();
+  const auto json = episode_json;
+  JSON_BENCHMARK(1e5, [=]{
+    auto context = decode_context(json.data(), json.data() + json.size());
+    codec.decode(context);
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_tagged_union_encode_polymorphic) {
+  const auto codec = tagged_union_codec();
+  auto context = decode_context(episode_json.data(), episode_json.data() + episode_json.size());
+  const auto episode = codec.decode(context);
+  JSON_BENCHMARK(1e5, [=]{
+    encode_context context;
+    codec.encode(context, episode);
+  });
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // codec
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
@@ -0,0 +1,478 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include <spotify/json/decode_context.hpp>
+#include <spotify/json/decode_exception.hpp>
+#include <spotify/json/default_codec.hpp>
+#include <spotify/json/detail/chunk_scanner.hpp>
+#include <spotify/json/detail/container_elements.hpp>
+#include <spotify/json/detail/decode_helpers.hpp>
+#include <spotify/json/detail/macros.hpp>
+#include <spotify/json/detail/skip_chars.hpp>
+#include <spotify/json/string_view.hpp>
+
+namespace spotify {
+namespace json {
+
+/**
+ * Decodes a JSON value from input that arrives in chunks, such as the buffers
+ * of a network stream, without first joining the chunks together.
+ *
+ * When the value is an array or an object and the codec is an array_t or a
+ * map_t (such as the default codec of a std::vector or a std::map), each of its
+ * elements is decoded and inserted into value() as soon as the chunk that it
+ * ends in arrives, so decoding keeps up with the input. Elements are decoded
+ * right out of the chunks. Only an element that spans chunks has its bytes kept
+ * in a buffer until its last chunk arrives, which is found by scanning each
+ * chunk of it once, continuing from where the scan of the previous one stopped.
+ *
+ * Other values, including objects that are decoded with an object_t and
+ * arrays that are decoded with a tuple_t, are scanned in the same way, but
+ * their chunks are concatenated into one buffer, and they are decoded as a
+ * whole when their last chunk arrives. For them, chunked_decoder saves the
+ * caller from joining the chunks, but not the copy, and decoding does not
+ * overlap the input; only the scan does. Values that are not objects, arrays
+ * or strings can only be told to be complete by what follows them, so when
+ * such a value is the whole input, it is decoded by finish().
+ *
+ * Like decode(), the input must be a single value, optionally surrounded by
+ * whitespace. Failures throw decode_exception, with the message and the offset
+ * that decode() would fail with. Offsets count from the start of the first
+ * chunk.
+ */
+template <typename codec_type>
+class chunked_decoder final {
+  using elements = detail::container_elements<codec_type>;
+  using has_elements = std::integral_constant<bool, elements::is_supported>;
+
+ public:
+  using object_type = typename codec_type::object_type;
+
+  explicit chunked_decoder(codec_type codec = codec_type())
+      : _codec(std::move(codec)) {}
+
+  /**
+   * Decode what can be decoded of the next chunk of input. The chunk only needs
+   * to be valid during the call.
+   *
+   * @return true if the value has been decoded.
+   * @throws decode_exception if the JSON parsing fails.
+   */
+  bool append(const char *data, size_t size) {
+    const auto end = data + size;
+    auto begin = data;
+    if (_state == state::done) {
+      check_trailing_input(begin, end);
+      _offset += size;
+      return true;
+    }
+
+    if (_state == state::before_value) {
+      begin = skip_whitespace(begin, end);
+      if (begin == end) {
+        _offset += size;
+        return false;
+      }
+      _value_offset = _offset + (begin - data);
+      _state = state::value;
+      begin = start_elements(begin, has_elements());
+    }
+
+    const auto value_end = (_state == state::value ?
+        append_value(begin, end) :
+        append_elements(data, begin, end, has_elements()));
+    if (_state != state::done) {
+      _offset += size;
+      return false;
+    }
+
+    _offset += value_end - data;
+    check_trailing_input(value_end, end);
+    _offset += end - value_end;
+    return true;
+  }
+
+  template <typename string_type>
+  bool append(const string_type &string) {
+    return append(string.data(), string.size());
+  }
+
+  /**
+   * Append each of count segments, in order, like the buffers of an iovec.
+   */
+  bool append(const json::string_view *segments, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+      append(segments[i].data(), segments[i].size());
+    }
+    return is_done();
+  }
+
+  /**
+   * Tell the decoder that there is no more input. If the value has not been
+   * decoded yet, the input that has been appended is decoded now, which fails
+   * unless the value is a number, true, false or null at the end of the input.
+   *
+   * @throws decode_exception if the JSON parsing fails.
+   */
+  void finish() {
+    switch (_state) {
+      case state::done:
+        return;
+      case state::before_value:
+        _value_offset = _offset;
+        decode_value(_buffer.data(), _buffer.data() + _buffer.size());
+        return;
+      case state::value:
+        decode_value(_buffer.data(), _buffer.data() + _buffer.size());
+        std::string().swap(_buffer);
+        return;
+      case state::before_first_element:
+      case state::before_element:
+        _element_offset = _offset;
+        decode_buffered_element(has_elements());  // Fails like the codec does
+        break;
+      case state::in_element:
+        decode_buffered_element(has_elements());
+        break;
+      case state::after_element:
+        break;
+    }
+    json_throw(decode_exception("Unexpected end of input", _offset));
+  }
+
+  bool is_done() const {
+    return _state == state::done;
+  }
+
+  /**
+   * The decoded value. Only complete once is_done() is true, but the elements
+   * of an array or an object are inserted into it as they are decoded.
+   */
+  object_type &value() {
+    return _value;
+  }
+
+ private:
+  enum class state : uint8_t {
+    before_value,
+    value,  // A value that is decoded as a whole
+    before_first_element,
+    before_element,
+    in_element,  // An element that spans chunks
+    after_element,
+    done
+  };
+
+  /**
+   * The part of the element that the scan of an element that spans chunks has
+   * reached. Elements of arrays are values only.
+   */
+  enum class element_part : uint8_t { key, colon, before_value, value };
+
+  static const char *skip_whitespace(const char *begin, const char *end) {
+    decode_context context(begin, end);
+    detail::skip_any_whitespace(context);
+    return context.position;
+  }
+
+  /**
+   * Throw the failure recorded in context, counting its offset from the start
+   * of the input rather than from the start of the context.
+   */
+  static void throw_if_failed(const decode_context &context, const size_t offset) {
+    if (json_unlikely(context.has_failed())) {
+      json_throw(decode_exception(context.error(), offset + context.error_offset()));
+    }
+  }
+
+  /**
+   * A successfully decoded element is certainly complete if it is followed by
+   * something that can follow an element, or if it ends the chunk with the last
+   * character of a string or a container. Anything else, such as a number at
+   * the end of the chunk or followed by a '.', might go on in the next chunk.
+   */
+  static bool is_complete(const decode_context &context) {
+    if (context.position != context.end) {
+      const auto next = *context.position;
+      return (
+          next == ',' || next == elements::closing ||
+          next == ' ' || next == '\t' || next == '\n' || next == '\r');
+    }
+    const auto last = context.position[-1];
+    return (last == '"' || last == ']' || last == '}');
+  }
+
+  /**
+   * Scan the value at begin in chunks, and decode it when it is complete.
+   */
+  const char *append_value(const char *begin, const char *end) {
+    const auto value_end = _scanner.scan(begin, end);
+    if (!value_end) {
+      _buffer.append(begin, end);
+      return end;
+    }
+
+    if (_buffer.empty()) {
+      decode_value(begin, value_end);
+    } else {
+      _buffer.append(begin, value_end);
+      decode_value(_buffer.data(), _buffer.data() + _buffer.size());
+      std::string().swap(_buffer);
+    }
+    return value_end;
+  }
+
+  void decode_value(const char *begin, const char *end) {
+    decode_context context(begin, end);
+    context.throw_on_failure = false;
+    _value = _codec.decode(context);
+    detail::skip_any_whitespace(context);
+    detail::fail_if(context, context.position != context.end, "Unexpected trailing input");
+    throw_if_failed(context, _value_offset);
+    _state = state::done;
+  }
+
+  const char *start_elements(const char *begin, std::false_type) {
+    return begin;
+  }
+
+  const char *start_elements(const char *begin, std::true_type) {
+    if (*begin != elements::opening) {
+      return begin;
+    }
+    _state = state::before_first_element;
+    return begin + 1;
+  }
+
+  const char *append_elements(const char *, const char *, const char *end, std::false_type) {
+    return end;
+  }
+
+  /**
+   * Decode the elements that end in the chunk at data, starting at begin, and
+   * the element that begins in it and spans chunks as far as it goes. Returns
+   * the position after the closing bracket if the container ends in the chunk.
+   */
+  const char *append_elements(const char *data, const char *begin, const char *end, std::true_type) {
+    auto position = begin;
+    while (position != end) {
+      switch (_state) {
+        case state::in_element:
+          position = continue_element(position, end);
+          break;
+        case state::after_element:
+          position = skip_whitespace(position, end);
+          if (position == end) {
+            break;
+          } else if (*position == ',') {
+            _state = state::before_element;
+            position++;
+            break;
+          } else if (*position != elements::closing) {
+            json_throw(decode_exception("Unexpected input", _offset + (position - data)));
+          }
+          return finish_elements(data, position + 1);
+        default:
+          position = skip_whitespace(position, end);
+          if (position == end) {
+            break;
+          } else if (_state == state::before_first_element && *position == elements::closing) {
+            return finish_elements(data, position + 1);
+          }
+          _element_offset = _offset + (position - data);
+          position = start_element(position, end);
+          break;
+      }
+    }
+    return end;
+  }
+
+  /**
+   * Decode the element at begin right out of the chunk. If it does not end in
+   * the chunk, start to buffer it instead.
+   */
+  const char *start_element(const char *begin, const char *end) {
+    decode_context context(begin, end);
+    context.throw_on_failure = false;
+    auto is_decoded = false;
+    json_try {
+      auto element = elements::decode(_codec, context);
+      if (json_likely(!context.has_failed() && is_complete(context))) {
+        _insert_state = elements::insert(context, _insert_state, _value, std::move(element));
+        is_decoded = true;
+      }
+    } json_catch(...) {
+      // Decoded again below if the element ends in this chunk
+    }
+
+    if (json_likely(is_decoded)) {
+      throw_if_failed(context, _element_offset);
+      _state = state::after_element;
+      return context.position;
+    }
+
+    _scanner = detail::chunk_scanner();
+    _element_part = (elements::has_keys ? element_part::key : element_part::before_value);
+    _state = state::in_element;
+    return continue_element(begin, end);
+  }
+
+  /**
+   * Scan the chunk for the end of the element that is being buffered, and
+   * decode the element if it ends in the chunk. One more character is decoded
+   * with the element if there is one, so that it fails like decode() would
+   * when it is followed by something unexpected.
+   */
+  const char *continue_element(const char *begin, const char *end) {
+    const auto element_end = scan_element(begin, end);
+    if (!element_end) {
+      _buffer.append(begin, end);
+      return end;
+    }
+
+    const auto buffered = _buffer.size();
+    const auto tail = (element_end == end ? end : element_end + 1);
+    _buffer.append(begin, tail);
+    const auto decoded = decode_buffered_element(has_elements());
+    if (json_unlikely(decoded < buffered)) {
+      // The scan ends scalars at whitespace and separators, so only a codec
+      // that stops inside of a string or a container gets here.
+      json_throw(decode_exception("Unexpected input", _element_offset + decoded));
+    }
+    return begin + (decoded - buffered);
+  }
+
+  /**
+   * Find where the element that is being buffered ends, continuing from where
+   * the scan of the previous chunk stopped.
+   */
+  const char *scan_element(const char *begin, const char *end) {
+    if (_element_part == element_part::key) {
+      begin = _scanner.scan(begin, end);
+      if (!begin) {
+        return nullptr;
+      }
+      _scanner = detail::chunk_scanner();
+      _element_part = element_part::colon;
+    }
+
+    if (_element_part == element_part::colon) {
+      begin = skip_whitespace(begin, end);
+      if (begin == end) {
+        return nullptr;
+      } else if (*begin != ':') {
+        return begin;  // Decoding the element fails here
+      }
+      begin++;
+      _element_part = element_part::before_value;
+    }
+
+    if (_element_part == element_part::before_value) {
+      begin = skip_whitespace(begin, end);
+      if (begin == end) {
+        return nullptr;
+      }
+      _element_part = element_part::value;
+    }
+
+    return _scanner.scan(begin, end);
+  }
+
+  size_t decode_buffered_element(std::false_type) {
+    return 0;
+  }
+
+  /**
+   * Decode the buffered element, and return how many bytes of the buffer it
+   * was decoded from.
+   */
+  size_t decode_buffered_element(std::true_type) {
+    decode_context context(_buffer.data(), _buffer.data() + _buffer.size());
+    context.throw_on_failure = false;
+    auto element = elements::decode(_codec, context);
+    throw_if_failed(context, _element_offset);
+    insert_element(context, std::move(element));
+    const auto decoded = static_cast<size_t>(context.position - context.begin);
+    _buffer.clear();  // Keeps the memory for the next element that spans chunks
+    return decoded;
+  }
+
+  template <typename element_type>
+  void insert_element(decode_context &context, element_type &&element) {
+    _insert_state = elements::insert(context, _insert_state, _value, std::move(element));
+    throw_if_failed(context, _element_offset);
+    _state = state::after_element;
+  }
+
+  /**
+   * Validate the container, whose closing bracket is right before value_end.
+   */
+  const char *finish_elements(const char *data, const char *value_end) {
+    decode_context context(value_end, value_end);
+    context.throw_on_failure = false;
+    elements::validate(context, _insert_state, _value);
+    throw_if_failed(context, _offset + (value_end - data));
+    std::string().swap(_buffer);
+    _state = state::done;
+    return value_end;
+  }
+
+  void check_trailing_input(const char *begin, const char *end) const {
+    decode_context context(begin, end);
+    context.throw_on_failure = false;
+    detail::skip_any_whitespace(context);
+    detail::fail_if(context, context.position != context.end, "Unexpected trailing input");
+    throw_if_failed(context, _offset);
+  }
+
+  codec_type _codec;
+  detail::chunk_scanner _scanner;
+  std::string _buffer;
+  object_type _value = object_type();
+  typename elements::state _insert_state = elements::init_state;
+  size_t _offset = 0;  // Of the start of the chunk that is being appended
+  size_t _value_offset = 0;
+  size_t _element_offset = 0;
+  state _state = state::before_value;
+  element_part _element_part = element_part::value;
+};
+
+/**
+ * Create a chunked_decoder that decodes values with codec.
+ */
+template <typename codec_type>
+chunked_decoder<codec_type> make_chunked_decoder(codec_type codec) {
+  return chunked_decoder<codec_type>(std::move(codec));
+}
+
+/**
+ * Create a chunked_decoder that decodes values with default_codec<value_type>().
+ */
+template <typename value_type>
+chunked_decoder<decltype(default_codec<value_type>())> make_chunked_decoder() {
+  return chunked_decoder<decltype(default_codec<value_type>())>(cached_default_codec<value_type>());
+}
+
+}  // namespace json
+}  // namespace spotify
@@ -28,12 +28,33 @@
 #include <spotify/json/default_codec.hpp>
 #include <spotify/json/detail/decode_helpers.hpp>
 #include <spotify/json/detail/encode_helpers.hpp>
+#include <spotify/json/detail/leading_tokens.hpp>
 #include <spotify/json/encode_context.hpp>
 
 namespace spotify {
 namespace json {
 namespace detail {
 
+/**
+ * Decode into an existing container by clearing it and then inserting the
+ * decoded elements. The elements are not reused, but containers such as
+ * std::unordered_set keep their memory when they are cleared.
+ */
+template <typename inserter, typename codec_type, typename container_type>
+void decode_into_cleared(decode_context &context, const codec_type &codec, container_type &container) {
+  container.clear();
+  typename inserter::state state = inserter::init_state;
+  decode_comma_separated(context, '[', ']', [&]{
+    auto value = codec.decode(context);
+    if (json_likely(!context.has_failed())) {
+      state = inserter::insert(context, state, container, std::move(value));
+    }
+  });
+  if (json_likely(!context.has_failed())) {
+    inserter::validate(context, state, container);
+  }
+}
+
 struct sequence_inserter {
   using state = int;
   static const state init_state = 0;
@@ -52,6 +73,11 @@ struct sequence_inserter {
   static void validate(decode_context &, state, container_type &) {
     // Nothing to validate
   }
+
+  template <typename codec_type, typename container_type>
+  static void decode_into(decode_context &context, const codec_type &codec, container_type &container) {
+    decode_into_cleared<sequence_inserter>(context, codec, container);
+  }
 };
 
 struct fixed_size_sequence_inserter {
@@ -64,7 +90,9 @@ struct fixed_size_sequence_inserter {
       state pos,
       container_type &container,
       value_type &&value) {
-    fail_if(context, pos >= container.size(), "Too many elements in array");
+    if (fail_if(context, pos >= container.size(), "Too many elements in array")) {
+      return pos;
+    }
     container[pos] = value;
     return pos + 1;
   }
@@ -73,6 +101,20 @@ struct fixed_size_sequence_inserter {
   static void validate(decode_context &context, state pos, container_type &container) {
     fail_if(context, pos != container.size(), "Too few elements in array");
   }
+
+  template <typename codec_type, typename container_type>
+  static void decode_into(decode_context &context, const codec_type &codec, container_type &container) {
+    state pos = init_state;
+    decode_comma_separated(context, '[', ']', [&]{
+      if (fail_if(context, pos >= container.size(), "Too many elements in array")) {
+        return;
+      }
+      detail::decode_into(codec, context, container[pos++]);
+    });
+    if (json_likely(!context.has_failed())) {
+      validate(context, pos, container);
+    }
+  }
 };
 
 struct associative_inserter {
@@ -93,15 +135,41 @@ struct associative_inserter {
   static void validate(decode_context &, state, container_type &) {
     // Nothing to validate
   }
+
+  template <typename codec_type, typename container_type>
+  static void decode_into(decode_context &context, const codec_type &codec, container_type &container) {
+    decode_into_cleared<associative_inserter>(context, codec, container);
+  }
+};
+
+/**
+ * Decode into an existing random access container. The elements that are
+ * already in the container are decoded into, so that their memory is reused
+ * too, and superfluous elements are removed at the end.
+ */
+struct random_access_sequence_inserter : public sequence_inserter {
+  template <typename codec_type, typename container_type>
+  static void decode_into(decode_context &context, const codec_type &codec, container_type &container) {
+    size_t size = 0;
+    decode_comma_separated(context, '[', ']', [&]{
+      if (json_likely(size < container.size())) {
+        detail::decode_into(codec, context, container[size]);
+      } else {
+        container.push_back(codec.decode(context));
+      }
+      size++;
+    });
+    container.erase(container.begin() + size, container.end());
+  }
 };
 
 template <typename T> struct container_inserter;
 
 template <typename T>
-struct container_inserter<std::vector<T>> : public sequence_inserter {};
+struct container_inserter<std::vector<T>> : public random_access_sequence_inserter {};
 
 template <typename T>
-struct container_inserter<std::deque<T>> : public sequence_inserter {};
+struct container_inserter<std::deque<T>> : public random_access_sequence_inserter {};
 
 template <typename T>
 struct container_inserter<std::list<T>> : public sequence_inserter {};
@@ -143,13 +211,25 @@ class array_t final {
     object_type output;
     typename inserter::state state = inserter::init_state;
     detail::decode_comma_separated(context, '[', ']', [&]{
-      state = inserter::insert(
-          context, state, output, _inner_codec.decode(context));
+      auto value = _inner_codec.decode(context);
+      if (json_likely(!context.has_failed())) {
+        state = inserter::insert(context, state, output, std::move(value));
+      }
     });
-    inserter::validate(context, state, output);
+    if (json_likely(!context.has_failed())) {
+      inserter::validate(context, state, output);
+    }
     return output;
   }
 
+  /**
+   * Decode into an existing container, reusing the memory of the container
+   * and, for std::vector, std::deque and std::array, of its elements.
+   */
+  void decode_into(decode_context &context, object_type &output) const {
+    detail::container_inserter<T>::decode_into(context, _inner_codec, output);
+  }
+
   void encode(encode_context &context, const object_type &array) const {
     context.append('[');
     for (const auto &element : array) {
@@ -161,6 +241,14 @@ class array_t final {
     context.append_or_replace(',', ']');
   }
 
+  detail::token_set leading_tokens() const {
+    return detail::token_array;
+  }
+
+  const codec_type &inner_codec() const {
+    return _inner_codec;
+  }
+
  private:
   codec_type _inner_codec;
 };
@@ -21,6 +21,7 @@
 #include <spotify/json/decode_context.hpp>
 #include <spotify/json/default_codec.hpp>
 #include <spotify/json/detail/decode_helpers.hpp>
+#include <spotify/json/detail/leading_tokens.hpp>
 #include <spotify/json/encode_context.hpp>
 
 #if _MSC_VER
@@ -39,7 +40,7 @@ class boolean_t final {
     switch (detail::peek(context)) {
       case 'f': detail::skip_false(context); return false;
       case 't': detail::skip_true(context); return true;
-      default: detail::fail(context, "Unexpected input, expected boolean");
+      default: detail::fail(context, "Unexpected input, expected boolean"); return false;
     }
   }
 
@@ -50,6 +51,10 @@ class boolean_t final {
     buffer[needed - 1] = 'e'; // write the missing 'e' in 'false' (or overwrite it in 'true')
     context.advance(needed);
   }
+
+  detail::token_set leading_tokens() const {
+    return detail::token_boolean;
+  }
 };
 
 inline boolean_t boolean() {
@@ -28,6 +28,7 @@
 #include <spotify/json/codec/smart_ptr.hpp>
 #include <spotify/json/detail/decode_helpers.hpp>
 #include <spotify/json/detail/encode_helpers.hpp>
+#include <spotify/json/detail/leading_tokens.hpp>
 
 namespace spotify {
 namespace json {
@@ -75,6 +76,10 @@ class optional_t final {
     _inner_codec.encode(context, *value);
   }
 
+  detail::token_set leading_tokens() const {
+    return detail::leading_tokens(_inner_codec);
+  }
+
   template <typename value_type>
   bool should_encode(const boost::optional<value_type> &value) const {
     return (value != boost::none) && detail::should_encode(_inner_codec, *value);
@@ -20,6 +20,7 @@
 #include <utility>
 
 #include <spotify/json/decode_context.hpp>
+#include <spotify/json/detail/leading_tokens.hpp>
 #include <spotify/json/encode_context.hpp>
 
 namespace spotify {
@@ -53,6 +54,10 @@ class cast_t {
     _inner_codec.encode(context, codec_cast<inner_type, T>::cast(value));
   }
 
+  detail::token_set leading_tokens() const {
+    return detail::leading_tokens(_inner_codec);
+  }
+
  private:
   codec_type _inner_codec;
 };
@@ -17,6 +17,7 @@
 #pragma once
 
 #include <spotify/json/decode_context.hpp>
+#include <spotify/json/detail/leading_tokens.hpp>
 #include <spotify/json/encode_context.hpp>
 
 namespace spotify {
@@ -47,13 +48,16 @@ class codec_interface final {
    * this codec parses.
    *
    * If parsing succeeds, position should be set to point to the character after
-   * the last character that was parsed. If parsing fails, context.error should
-   * be set to a non-empty string and context.position should point to where the
-   * error occured.
+   * the last character that was parsed. If parsing fails, detail::fail should
+   * be called with an error message and the offset where the error occured.
+   * That throws a decode_exception unless context.throw_on_failure is false,
+   * in which case the error is recorded in the context and decode should
+   * return as soon as possible. Codecs that call other codecs must check
+   * context.has_failed() after each call, and return early if it is true.
    *
    * If parsing fails, object_type should be ignored by the caller.
    *
-   * decode will never be called with a contest that has_failed().
+   * decode will never be called with a context that has_failed().
    */
   object_type decode(decode_context &context) const;
 
@@ -75,6 +79,18 @@ class codec_interface final {
    * should be thrown.
    */
   bool should_encode(const object_type &value) const;
+
+  /**
+   * This method is optional.
+   *
+   * If it is present, it returns the kinds of tokens (detail::token_object,
+   * detail::token_string, etc.) that a value decoded by this codec can start
+   * with. Codecs like one_of_t use it to skip codecs that can not decode the
+   * input without trying them. The set may include tokens that the codec fails
+   * to decode, but it must never leave out a token that the codec can decode.
+   * Codecs that do not have this method are assumed to accept any token.
+   */
+  detail::token_set leading_tokens() const;
 };
 
 }  // namespace codec
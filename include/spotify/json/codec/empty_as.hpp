@@ -21,7 +21,10 @@
 #include <spotify/json/codec/null.hpp>
 #include <spotify/json/codec/omit.hpp>
 #include <spotify/json/decode_context.hpp>
+#include <spotify/json/decode_exception.hpp>
 #include <spotify/json/detail/decode_helpers.hpp>
+#include <spotify/json/detail/leading_tokens.hpp>
+#include <spotify/json/detail/macros.hpp>
 #include <spotify/json/encode_context.hpp>
 
 namespace spotify {
@@ -46,19 +49,41 @@ class empty_as_t final {
         _inner_codec(std::move(inner_codec)) {}
 
   object_type decode(decode_context &context) const {
-    const auto original_position = context.position;
-    try {
+    // When the next token can not be an empty value, the inner codec is the
+    // only one that can succeed, and it does not have to be tried first.
+    if (!(detail::leading_tokens(_empty_codec) & detail::peek_token(context))) {
       return _inner_codec.decode(context);
-    } catch (const decode_exception &exception) {
-      try {
-        context.position = original_position;
-        return _empty_codec.decode(context);
-      } catch (const decode_exception &) {
-        // The error of the inner codec is more interesting than saying, for
-        // example, that the object is not a valid null.
-        throw exception;
+    }
+
+    const auto original_position = context.position;
+    {
+      const detail::no_throw_scope no_throw(context);
+      const detail::immutable_input_scope immutable_input(context);
+      json_try {
+        auto result = _inner_codec.decode(context);
+        if (json_likely(!context.has_failed())) {
+          return result;
+        }
+      } json_catch(const decode_exception &) {
+      }
+
+      context.clear_error();
+      context.position = original_position;
+      json_try {
+        auto result = _empty_codec.decode(context);
+        if (json_likely(!context.has_failed())) {
+          return result;
+        }
+      } json_catch(const decode_exception &) {
       }
     }
+
+    // The error of the inner codec is more interesting than saying, for
+    // example, that the object is not a valid null. Decode with it again to
+    // fail with its error, the way that the context fails.
+    context.clear_error();
+    context.position = original_position;
+    return _inner_codec.decode(context);
   }
 
   void encode(encode_context &context, const object_type &value) const {
@@ -69,6 +94,10 @@ class empty_as_t final {
     }
   }
 
+  detail::token_set leading_tokens() const {
+    return detail::leading_tokens(_empty_codec) | detail::leading_tokens(_inner_codec);
+  }
+
   bool should_encode(const object_type &value) const {
     if (value == _default) {
       return detail::should_encode(_empty_codec, value);
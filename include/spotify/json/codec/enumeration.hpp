@@ -24,6 +24,7 @@
 #include <spotify/json/default_codec.hpp>
 #include <spotify/json/detail/decode_helpers.hpp>
 #include <spotify/json/detail/encode_helpers.hpp>
+#include <spotify/json/detail/leading_tokens.hpp>
 #include <spotify/json/detail/macros.hpp>
 #include <spotify/json/encode_context.hpp>
 
@@ -49,10 +50,16 @@ class enumeration_t final {
 
   object_type decode(decode_context &context) const {
     const auto result = _inner_codec.decode(context);
+    if (json_unlikely(context.has_failed())) {
+      return detail::failed_value<object_type>(context);
+    }
+
     const auto it = std::find_if(_mapping.begin(), _mapping.end(), [&](const std::pair<outer_type, inner_type> &pair) {
       return pair.second == result;
     });
-    detail::fail_if(context, it == _mapping.end(), "Encountered unknown enumeration value");
+    if (detail::fail_if(context, it == _mapping.end(), "Encountered unknown enumeration value")) {
+      return detail::failed_value<object_type>(context);
+    }
     return it->first;
   }
 
@@ -62,6 +69,10 @@ class enumeration_t final {
     _inner_codec.encode(context, (*it).second);
   }
 
+  detail::token_set leading_tokens() const {
+    return detail::leading_tokens(_inner_codec);
+  }
+
   bool should_encode(const object_type &value) const {
     return find(value) != _mapping.end();
   }
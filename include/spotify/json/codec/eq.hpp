@@ -18,7 +18,9 @@
 
 #include <spotify/json/decode_context.hpp>
 #include <spotify/json/default_codec.hpp>
+#include <spotify/json/detail/decode_helpers.hpp>
 #include <spotify/json/detail/encode_helpers.hpp>
+#include <spotify/json/detail/leading_tokens.hpp>
 
 namespace spotify {
 namespace json {
@@ -44,7 +46,9 @@ class eq_t final {
 
   object_type decode(decode_context &context) const {
     object_type result = _inner_codec.decode(context);
-    detail::fail_if(context, result != _value, "Encountered unexpected value");
+    if (json_likely(!context.has_failed())) {
+      detail::fail_if(context, result != _value, "Encountered unexpected value");
+    }
     return result;
   }
 
@@ -52,6 +56,10 @@ class eq_t final {
     _inner_codec.encode(context, _value);
   }
 
+  detail::token_set leading_tokens() const {
+    return detail::leading_tokens(_inner_codec);
+  }
+
   bool should_encode(const object_type &value) const {
     return detail::should_encode(_inner_codec, value);
   }
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <cmath>
+#include <stdexcept>
+#include <type_traits>
+
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/decode_context.hpp>
+#include <spotify/json/detail/encode_float.hpp>
+#include <spotify/json/detail/encode_helpers.hpp>
+#include <spotify/json/detail/leading_tokens.hpp>
+#include <spotify/json/detail/macros.hpp>
+#include <spotify/json/encode_context.hpp>
+
+namespace spotify {
+namespace json {
+namespace codec {
+
+/**
+ * Codec for floating point numbers that are written with a fixed number of
+ * decimals, for when short and fast output matters more than getting back
+ * the exact same number, as for coordinates and metrics. Numbers are rounded
+ * to the nearest multiple of 10^-decimals, and trailing zeros are left out:
+ * with three decimals, 1.23456 is written as 1.235 and 1.5 as 1.5. Numbers
+ * that are too large to be rounded like this (from 1e19 / 10^decimals and up)
+ * are written like number_t writes them.
+ *
+ * Decoding is the same as for number_t.
+ */
+template <typename T>
+class fixed_precision_t final {
+ public:
+  static_assert(
+      std::is_same<T, float>::value || std::is_same<T, double>::value,
+      "fixed_precision_t only supports float and double");
+
+  using object_type = T;
+
+  static constexpr unsigned max_decimals = 17;
+
+  explicit fixed_precision_t(const unsigned decimals)
+      : _decimals(decimals) {
+    if (decimals > max_decimals) {
+      json_throw(std::invalid_argument("fixed_precision_t supports at most 17 decimals"));
+    }
+  }
+
+  object_type decode(decode_context &context) const {
+    return number_t<T>().decode(context);
+  }
+
+  void encode(encode_context &context, const object_type value) const {
+    detail::fail_if(context, !std::isfinite(value), "Special values like 'Infinity' or 'NaN' are supported in JSON.");
+    detail::encode_fixed_precision(context, value, _decimals);
+  }
+
+  detail::token_set leading_tokens() const {
+    return detail::token_number;
+  }
+
+ private:
+  unsigned _decimals;
+};
+
+template <typename T>
+constexpr unsigned fixed_precision_t<T>::max_decimals;
+
+template <typename T>
+fixed_precision_t<T> fixed_precision(const unsigned decimals) {
+  return fixed_precision_t<T>(decimals);
+}
+
+}  // namespace codec
+}  // namespace json
+}  // namespace spotify
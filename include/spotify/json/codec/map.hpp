@@ -25,6 +25,7 @@
 #include <spotify/json/default_codec.hpp>
 #include <spotify/json/detail/decode_helpers.hpp>
 #include <spotify/json/detail/encode_helpers.hpp>
+#include <spotify/json/detail/leading_tokens.hpp>
 
 namespace spotify {
 namespace json {
@@ -53,16 +54,20 @@ class map_t final {
       : _inner_codec(std::move(inner_codec)) {}
 
   object_type decode(decode_context &context) const {
-    using value_type = typename object_type::value_type;
     object_type output;
-    detail::decode_object<string_t>(
-        context,
-        [&](std::string &&key) {
-          output.insert(value_type(std::move(key), _inner_codec.decode(context)));
-        });
+    decode_elements(context, output);
     return output;
   }
 
+  /**
+   * Decode into an existing map. The map is cleared first, which for
+   * std::unordered_map keeps the memory of the bucket array.
+   */
+  void decode_into(decode_context &context, object_type &output) const {
+    output.clear();
+    decode_elements(context, output);
+  }
+
   void encode(encode_context &context, const object_type &map) const {
     context.append('{');
     for (const auto &element : map) {
@@ -76,7 +81,27 @@ class map_t final {
     context.append_or_replace(',', '}');
   }
 
+  detail::token_set leading_tokens() const {
+    return detail::token_object;
+  }
+
+  const codec_type &inner_codec() const {
+    return _inner_codec;
+  }
+
  private:
+  json_force_inline void decode_elements(decode_context &context, object_type &output) const {
+    using value_type = typename object_type::value_type;
+    detail::decode_object<string_t>(
+        context,
+        [&](std::string &&key) {
+          auto value = _inner_codec.decode(context);
+          if (json_likely(!context.has_failed())) {
+            output.insert(value_type(std::move(key), std::move(value)));
+          }
+        });
+  }
+
   string_t _string_codec;
   codec_type _inner_codec;
 };
@@ -19,6 +19,7 @@
 #include <spotify/json/decode_context.hpp>
 #include <spotify/json/default_codec.hpp>
 #include <spotify/json/detail/decode_helpers.hpp>
+#include <spotify/json/detail/leading_tokens.hpp>
 #include <spotify/json/encode_context.hpp>
 
 namespace spotify {
@@ -46,6 +47,10 @@ class null_t final {
     context.append("null", 4);
   }
 
+  detail::token_set leading_tokens() const {
+    return detail::token_null;
+  }
+
  private:
   object_type _value;
 };
@@ -18,23 +18,102 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <cstdlib>
 #include <limits>
 #include <type_traits>
 
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 #include <double-conversion/double-conversion.h>
 
 #include <spotify/json/decode_context.hpp>
 #include <spotify/json/default_codec.hpp>
+#include <spotify/json/detail/decode_float.hpp>
 #include <spotify/json/detail/decode_helpers.hpp>
+#include <spotify/json/detail/encode_float.hpp>
 #include <spotify/json/detail/encode_helpers.hpp>
 #include <spotify/json/detail/encode_integer.hpp>
+#include <spotify/json/detail/leading_tokens.hpp>
 #include <spotify/json/encode_context.hpp>
 
 namespace spotify {
 namespace json {
 namespace detail {
 
+/**
+ * Load 8 bytes into a word with the first byte in the least significant bits,
+ * whatever the byte order of the CPU. Compilers turn this into a single load
+ * on little-endian CPUs.
+ */
+json_force_inline uint64_t load_little_endian_8(const char *p) {
+  const auto u = reinterpret_cast<const uint8_t *>(p);
+  return
+      uint64_t(u[0]) | (uint64_t(u[1]) << 8) | (uint64_t(u[2]) << 16) | (uint64_t(u[3]) << 24) |
+      (uint64_t(u[4]) << 32) | (uint64_t(u[5]) << 40) | (uint64_t(u[6]) << 48) | (uint64_t(u[7]) << 56);
+}
+
+/**
+ * Whether all of the 8 bytes in the word (see load_little_endian_8) are
+ * digits. A byte is a digit if its high nibble is 3 both before and after
+ * adding 6 to it.
+ */
+json_force_inline bool is_8_digits(const uint64_t word) {
+  return (((word & 0xF0F0F0F0F0F0F0F0ULL) |
+      (((word + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) ==
+      0x3333333333333333ULL);
+}
+
+/**
+ * The number of leading digits in the word (see load_little_endian_8). Each
+ * byte is 0x33 before the xor in is_8_digits if and only if it is a digit.
+ * Adding 6 can only carry into the bytes after the first one that is not a
+ * digit, so the lowest byte that is left nonzero is that first non-digit.
+ */
+json_force_inline unsigned count_leading_digits(const uint64_t word) {
+  const auto non_digits = ((word & 0xF0F0F0F0F0F0F0F0ULL) |
+      (((word + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) ^
+      0x3333333333333333ULL;
+  if (!non_digits) {
+    return 8;
+  }
+#if defined(_MSC_VER) && defined(_M_X64)
+  unsigned long index;
+  _BitScanForward64(&index, non_digits);
+  return static_cast<unsigned>(index) / 8;
+#elif defined(_MSC_VER)
+  unsigned long index;
+  const auto low = static_cast<uint32_t>(non_digits);
+  _BitScanForward(&index, low ? low : static_cast<uint32_t>(non_digits >> 32));
+  return (low ? 0 : 4) + static_cast<unsigned>(index) / 8;
+#else
+  return static_cast<unsigned>(__builtin_ctzll(non_digits)) / 8;
+#endif  // defined(_MSC_VER)
+}
+
+/**
+ * 10 to the power of n, for n up to 8.
+ */
+json_force_inline uint32_t power_of_10(const unsigned n) {
+  static const uint32_t powers[] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000 };
+  return powers[n];
+}
+
+/**
+ * The value of the 8 digits in the word (see load_little_endian_8), found by
+ * combining the digits in pairs, then pairs of pairs and so on, with one
+ * multiply for each step instead of one for each digit.
+ */
+json_force_inline uint32_t decode_8_digits(uint64_t word) {
+  word -= 0x3030303030303030ULL;
+  word = (word * 10) + (word >> 8);
+  word = (((word & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) +
+      (((word >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >> 32;
+  return static_cast<uint32_t>(word);
+}
+
 template <typename T>
 T decode_floating_point(
     const double_conversion::StringToDoubleConverter &converter,
@@ -60,12 +139,119 @@ inline double decode_floating_point(
   return converter.StringToDouble(buffer, length, processed_characters_count);
 }
 
+inline bool decimal_to_binary(uint64_t mantissa, int64_t exponent, bool is_negative, float &value) {
+  return decimal_to_float(mantissa, exponent, is_negative, value);
+}
+
+inline bool decimal_to_binary(uint64_t mantissa, int64_t exponent, bool is_negative, double &value) {
+  return decimal_to_double(mantissa, exponent, is_negative, value);
+}
+
+/**
+ * Decode the floating point number at the context position without using
+ * double-conversion. This handles numbers that follow the JSON grammar and
+ * have at most 19 significant digits, and only when the result can be computed
+ * exactly (see decimal_to_double). For anything else, including numbers that
+ * JSON does not allow but double-conversion does (like '01' or '1.'), it
+ * returns false without moving the context position.
+ */
+template <typename T>
+json_force_inline bool decode_floating_point_fast(decode_context &context, T &value) {
+  const auto end = context.end;
+  auto position = context.position;
+  const auto is_negative = (position != end && *position == '-');
+  position += is_negative;
+
+  // Find [xxxx].yyyyE±zzzz
+  const auto int_begin = position;
+  uint64_t mantissa = 0;
+  for (; position != end; position++) {
+    const auto digit = static_cast<unsigned>(*position - '0');
+    if (digit > 9) {
+      break;
+    }
+    mantissa = mantissa * 10 + digit;
+  }
+  const auto num_int_digits = position - int_begin;
+  if (num_int_digits == 0 || (num_int_digits > 1 && *int_begin == '0')) {
+    return false;
+  }
+
+  // Find xxxx.[yyyy]E±zzzz
+  int64_t exponent = 0;
+  auto num_digits = num_int_digits;
+  if (position != end && *position == '.') {
+    const auto dec_begin = ++position;
+    while (end - position >= 8) {
+      const auto word = load_little_endian_8(position);
+      if (!is_8_digits(word)) {
+        break;
+      }
+      mantissa = mantissa * 100000000 + decode_8_digits(word);
+      position += 8;
+    }
+    for (; position != end; position++) {
+      const auto digit = static_cast<unsigned>(*position - '0');
+      if (digit > 9) {
+        break;
+      }
+      mantissa = mantissa * 10 + digit;
+    }
+    if (position == dec_begin) {
+      return false;
+    }
+    exponent = dec_begin - position;
+    num_digits += position - dec_begin;
+  }
+
+  // The mantissa has overflowed unless most of the digits are leading zeros.
+  if (json_unlikely(num_digits > 19)) {
+    for (auto p = int_begin; p != position && (*p == '0' || *p == '.'); p++) {
+      num_digits -= (*p == '0');
+    }
+    if (num_digits > 19) {
+      return false;
+    }
+  }
+
+  // Find xxxx.yyyyE±[zzzz]
+  if (position != end && (*position == 'e' || *position == 'E')) {
+    position++;
+    const auto is_negative_exponent = (position != end && *position == '-');
+    position += (position != end && (*position == '-' || *position == '+'));
+    const auto exp_begin = position;
+    int64_t exp = 0;
+    for (; position != end; position++) {
+      const auto digit = static_cast<unsigned>(*position - '0');
+      if (digit > 9) {
+        break;
+      }
+      exp = (exp < 0x10000 ? exp * 10 + digit : exp);  // way out of range anyway
+    }
+    if (position == exp_begin) {
+      return false;
+    }
+    exponent += (is_negative_exponent ? -exp : exp);
+  }
+
+  if (json_unlikely(!decimal_to_binary(mantissa, exponent, is_negative, value))) {
+    return false;
+  }
+  context.position = position;
+  return true;
+}
+
 template <typename T>
 class floating_point_t {
  public:
   using object_type = T;
 
   object_type decode(decode_context &context) const {
+    object_type value;
+    if (json_likely(decode_floating_point_fast(context, value))) {
+      return value;
+    }
+
     using atod_converter = double_conversion::StringToDoubleConverter;
     static const atod_converter converter(
         atod_converter::ALLOW_TRAILING_JUNK,
@@ -80,31 +266,21 @@ class floating_point_t {
         context.position,
         static_cast<int>(context.end - context.position),
         &bytes_read);
-    fail_if(context, std::isnan(result), "Invalid floating point number");
+    if (fail_if(context, std::isnan(result), "Invalid floating point number")) {
+      return result;
+    }
     skip_unchecked_n(context, bytes_read);
     return result;
   }
 
   void encode(encode_context &context, const object_type &value) const {
-    // The maximum buffer size required to emit a double in base 10, for decimal
-    // and exponential representations, is 25 bytes; based on the settings used
-    // below for the DoubleToStringConverter. We add another byte for the null
-    // terminator, but it is not actually needed because we don't finalize the
-    // builder.
-    const auto max_required_size = 26;
-    const auto p = reinterpret_cast<char *>(context.reserve(max_required_size));
-
-    // The converter is based on the ECMAScript converter, but will not convert
-    // special values, like Infinity and NaN, since JSON does not support those.
-    using dtoa_converter = double_conversion::DoubleToStringConverter;
-    const dtoa_converter converter(
-        dtoa_converter::UNIQUE_ZERO | dtoa_converter::EMIT_POSITIVE_EXPONENT_SIGN,
-        nullptr, nullptr, 'e', -6, 21, 6, 0);
-
-    using dtoa_builder = double_conversion::StringBuilder;
-    dtoa_builder builder(p, max_required_size);
-    detail::fail_if(context, !converter.ToShortest(value, &builder), "Special values like 'Infinity' or 'NaN' are supported in JSON.");
-    context.advance(builder.position());
+    // JSON does not support special values like Infinity and NaN.
+    detail::fail_if(context, !std::isfinite(value), "Special values like 'Infinity' or 'NaN' are supported in JSON.");
+    encode_floating_point(context, value);
+  }
+
+  detail::token_set leading_tokens() const {
+    return detail::token_number;
   }
 };
 
@@ -149,8 +325,8 @@ json_force_inline iterator_type find_non_digit(const iterator_type begin, const
 }
 
 /**
- * Calculate 'exp_10(e, v) = v * 10^e', throwing a decode_exception if the value
- * overflows the integer type. This function executes in linear time over the
+ * Calculate 'exp_10(e, v) = v * 10^e', failing if the value overflows the
+ * integer type. This function executes in linear time over the
  * value of 'e', so it will not be very efficient for large exponents, although
  * the value will overflow rather quickly so the runtime is bounded (a value of
  * zero is specifically handled to avoid a semi-infinite loop). Note that the
@@ -168,7 +344,9 @@ json_force_inline T exp_10(
     for (unsigned i = 0; i < exponent; i++) {
       const auto old_value = value;
       value *= 10;
-      fail_if(context, intops::is_overflow(old_value, value), "Integer overflow");
+      if (fail_if(context, intops::is_overflow(old_value, value), "Integer overflow")) {
+        break;
+      }
     }
   }
   return value;
@@ -207,8 +385,8 @@ json_never_inline T decode_integer_range_with_overflow(
 /**
  * Decode an integer specified in a byte range. The range must be known to only
  * contain digits characters ('0' through '9'). If it contains anything else,
- * the result is undefined. A decode_exception is thrown if the value overflows
- * the integer type.
+ * the result is undefined. Decoding fails if the value overflows the integer
+ * type.
  */
 template <typename T, bool is_positive>
 json_never_inline T decode_integer_range(
@@ -232,7 +410,7 @@ json_never_inline T decode_integer_range(
  * cutting off the least significant digits of the integer part of the number.
  * If the negative exponent is larger than the number of integer digits, zero is
  * returned. If the parsed number is too large to fit in the given integer type,
- * a decode_exception is thrown.
+ * decoding fails.
  */
 template <typename T, bool is_positive>
 json_never_inline T decode_with_negative_exponent(
@@ -253,7 +431,7 @@ json_never_inline T decode_with_negative_exponent(
  * digits, until the exponent has been used up. If there are not enough decimal
  * digits, the remaining exponent is used to multiply the parsed (from both the
  * integer and decimal digits) value appropriately. If the parsed number is too
- * large to fit in the given integer type, a decode_exception is thrown.
+ * large to fit in the given integer type, decoding fails.
  */
 template <typename T, bool is_positive>
 json_never_inline T decode_with_positive_exponent(
@@ -305,7 +483,7 @@ json_never_inline T handle_overflowing_exponent(
  * exponent into account) overflows the given type, e.g., 52e-1 = 5. It also
  * makes sure to not discard the decimal digits until the exponent has been
  * taken into account, e.g., 5.2e1 = 52. If the parsed number is too large to
- * fit in the given integer type, a decode_exception is thrown.
+ * fit in the given integer type, decoding fails.
  */
 template <typename T, bool is_positive>
 json_never_inline T decode_integer_tricky(decode_context &context, const char *int_beg) {
@@ -320,7 +498,9 @@ json_never_inline T decode_integer_tricky(decode_context &context, const char *i
     skip_unchecked_1(context);
     dec_beg = context.position;
     dec_end = find_non_digit(dec_beg, context.end);
-    fail_if(context, dec_beg == dec_end, "Invalid digits after decimal point");
+    if (fail_if(context, dec_beg == dec_end, "Invalid digits after decimal point")) {
+      return 0;
+    }
     context.position = dec_end;
   }
 
@@ -338,7 +518,9 @@ json_never_inline T decode_integer_tricky(decode_context &context, const char *i
     }
     exp_beg = context.position;
     exp_end = find_non_digit(exp_beg, context.end);
-    fail_if(context, exp_beg == exp_end, "Exponent symbols should be followed by an optional '+' or '-' and then by at least one number");
+    if (fail_if(context, exp_beg == exp_end, "Exponent symbols should be followed by an optional '+' or '-' and then by at least one number")) {
+      return 0;
+    }
     context.position = exp_end;
   }
 
@@ -353,6 +535,81 @@ json_never_inline T decode_integer_tricky(decode_context &context, const char *i
       decode_with_negative_exponent<T, is_positive>(context, exp, int_beg, int_end));
 }
 
+/**
+ * Finish decoding the pure integer that starts at b and whose digits end at
+ * position, where the magnitude has been decoded up to. A decimal point, an
+ * exponent or a digit past the ones that fit in the magnitude (see
+ * decode_long_integer) leave it to the more complex parser, and so does a
+ * magnitude that does not fit in the type.
+ */
+template <typename T, bool is_positive>
+json_force_inline T finish_integer(
+    decode_context &context,
+    const char *b,
+    const char *position,
+    const uint64_t magnitude) {
+  context.position = position;
+  if (json_likely(position != context.end)) {
+    const auto c = *position;
+    const auto is_tricky = ((c >= '0' && c <= '9') | (c == '.') | (c == 'e') | (c == 'E'));
+    if (json_unlikely(is_tricky)) {
+      return decode_integer_tricky<T, is_positive>(context, b);
+    }
+  }
+
+  const auto max_magnitude = static_cast<uint64_t>(std::numeric_limits<T>::max()) + (is_positive ? 0 : 1);
+  if (json_unlikely(magnitude > max_magnitude)) {
+    return decode_integer_tricky<T, is_positive>(context, b);
+  }
+  return static_cast<T>(is_positive ? magnitude : 0 - magnitude);
+}
+
+/**
+ * Decode the rest of a pure integer that starts at b and has more than eight
+ * digits, the first of which have been decoded into magnitude up to position.
+ * The digits are decoded eight at a time for as long as there are eight of
+ * them (see decode_8_digits). The last 1-7 digits are shifted to the end of
+ * the word, behind zeros, so that they too are decoded with decode_8_digits.
+ * Any 19 digits fit in the magnitude, so longer integers are left to the more
+ * complex parser; the few digits before that limit, and the ones at the very
+ * end of the input, are decoded one at a time.
+ */
+template <typename T, bool is_positive>
+json_never_inline T decode_long_integer(
+    decode_context &context,
+    const char *b,
+    const char *position,
+    uint64_t magnitude) {
+  const auto max_digits = 19;
+  while (context.end - position >= 8 && position - b <= max_digits - 8) {
+    const auto word = load_little_endian_8(position);
+    const auto n = count_leading_digits(word);
+    if (n != 8) {
+      if (n) {
+        const auto shift = 8 * (8 - n);
+        const auto digits = (word << shift) | (0x3030303030303030ULL >> (64 - shift));
+        magnitude = magnitude * power_of_10(n) + decode_8_digits(digits);
+        position += n;
+      }
+      return finish_integer<T, is_positive>(context, b, position, magnitude);
+    }
+    magnitude = magnitude * 100000000 + decode_8_digits(word);
+    position += 8;
+  }
+
+  const auto last = (context.end - b > max_digits ? b + max_digits : context.end);
+  for (; position != last; position++) {
+    const auto digit = static_cast<unsigned>(*position - '0');
+    if (digit > 9) {
+      break;
+    }
+    magnitude = magnitude * 10 + digit;
+  }
+
+  // A digit here means that there are more than max_digits digits.
+  return finish_integer<T, is_positive>(context, b, position, magnitude);
+}
+
 /**
  * Decode the integer at the context position. The integer can be specified
  * either as a pure integer: 'xxxx', where 'x' is a digit character between '0'
@@ -361,36 +618,40 @@ json_never_inline T decode_integer_tricky(decode_context &context, const char *i
  * or an "exponent E", we need to switch over to a more complex parser. The same
  * thing happens if we overflow, because we cannot yet know if this was a true
  * overflow or if a negative exponent will reduce the integer into range again.
- * If the parsed number is too large to fit in the given integer type, a
- * decode_exception is thrown. Decimal digits are simply discarded if they are
+ * If the parsed number is too large to fit in the given integer type,
+ * decoding fails. Decimal digits are simply discarded if they are
  * not used, i.e., if there is no positive exponent.
+ *
+ * Pure integers are decoded into a 64 bit magnitude and checked for overflow
+ * once at the end. Most integers are short, so the first eight digits are read
+ * one at a time, which is faster than trying to read eight at once and failing.
+ * Integers that go on after that are handed to decode_long_integer.
  */
 template <typename T, bool is_positive>
 json_never_inline T decode_integer(decode_context &context) {
-  using intops = integer_ops<T, is_positive>;
+  static_assert(sizeof(T) <= sizeof(uint64_t), "Integers are decoded into 64 bits");
   const auto b = context.position;
   const auto c = next(context);
   const auto i = to_integer<T>(c);
-  fail_if(context, is_invalid_digit(i), "Invalid integer");
-  T value = intops::accumulate(0, i);
-
-  while (json_likely(context.remaining())) {
-    const auto c = peek_unchecked(context);
-    const auto i = to_integer<T>(c);
-    if (is_invalid_digit(i)) {
-      const auto is_tricky = ((c == '.') | (c == 'e') | (c == 'E'));
-      return (json_unlikely(is_tricky) ? decode_integer_tricky<T, is_positive>(context, b) : value);
-    }
+  if (fail_if(context, is_invalid_digit(i), "Invalid integer")) {
+    return 0;
+  }
 
-    skip_unchecked_1(context);
-    const auto old_value = value;
-    value = intops::accumulate(value * 10, i);
-    if (json_unlikely(intops::is_overflow(old_value, value))) {
-      return decode_integer_tricky<T, is_positive>(context, b);
+  auto magnitude = static_cast<uint64_t>(c - '0');
+  auto position = context.position;
+  const auto short_end = (context.end - position > 7 ? position + 7 : context.end);
+  for (; position != short_end; position++) {
+    const auto digit = static_cast<unsigned>(*position - '0');
+    if (digit > 9) {
+      return finish_integer<T, is_positive>(context, b, position, magnitude);
     }
+    magnitude = magnitude * 10 + digit;
   }
 
-  return value;
+  const auto is_long = (position != context.end && *position >= '0' && *position <= '9');
+  return (json_likely(!is_long) ?
+      finish_integer<T, is_positive>(context, b, position, magnitude) :
+      decode_long_integer<T, is_positive>(context, b, position, magnitude));
 }
 
 template <typename T>
@@ -419,6 +680,10 @@ class integer_t<T, true, false> {
   json_force_inline void encode(encode_context &context, const object_type value) const {
     encode_positive_integer(context, value);
   }
+
+  detail::token_set leading_tokens() const {
+    return detail::token_number;
+  }
 };
 
 template <typename T>
@@ -433,11 +698,11 @@ class integer_t<T, true, true> {
   }
 
   json_force_inline void encode(encode_context &context, const object_type value) const {
-    if (value < 0) {
-      encode_negative_integer(context, value);
-    } else {
-      encode_positive_integer(context, value);
-    }
+    encode_signed_integer(context, value);
+  }
+
+  detail::token_set leading_tokens() const {
+    return detail::token_number;
   }
 };
 
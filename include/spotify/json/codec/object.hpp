@@ -21,7 +21,6 @@
 #include <memory>
 #include <string>
 #include <type_traits>
-#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -30,7 +29,9 @@
 #include <spotify/json/decode_context.hpp>
 #include <spotify/json/default_codec.hpp>
 #include <spotify/json/detail/bitset.hpp>
+#include <spotify/json/detail/decode_helpers.hpp>
 #include <spotify/json/detail/field_registry.hpp>
+#include <spotify/json/detail/leading_tokens.hpp>
 #include <spotify/json/detail/macros.hpp>
 #include <spotify/json/detail/skip_value.hpp>
 #include <spotify/json/encode_context.hpp>
@@ -70,40 +71,191 @@ class object_t final {
     add_field(name, true, std::forward<args_type>(args)...);
   }
 
+  /**
+   * The number of bytes of memory used by the codec, including its fields and
+   * the codecs of its fields (as far as they report their footprint). Copies
+   * of a codec share their fields, so the memory of a copy is mostly counted
+   * twice.
+   */
+  size_t memory_footprint() const noexcept {
+    return sizeof(*this) - sizeof(_fields) + _fields.memory_footprint();
+  }
+
   json_never_inline object_type decode(decode_context &context) const {
+    object_type output = construct(std::is_default_constructible<T>());
+    decode_fields<false>(context, output);
+    return output;
+  }
+
+  /**
+   * Decode into an existing object. Fields that are bound to member variables
+   * are decoded into the existing values, so that strings and containers keep
+   * their memory. Fields that are not present in the input are reset to their
+   * values in a newly constructed object, so the result is the same as that of
+   * decode().
+   */
+  json_never_inline void decode_into(decode_context &context, object_type &output) const {
+    decode_fields<true>(context, output);
+  }
+
+  /**
+   * Decode an object of which the caller has already consumed the '{' and the
+   * first key and ':', such as tagged_union_t after it has found its
+   * discriminator. The context must be positioned at the value of that key.
+   */
+  json_never_inline object_type decode_after_first_key(
+      decode_context &context,
+      const char *key,
+      size_t key_size) const {
+    object_type output = construct(std::is_default_constructible<T>());
+    decode_fields<false, true>(context, output, _fields.find_index(key, key_size));
+    return output;
+  }
+
+  void encode(encode_context &context, const object_type &value) const {
+    context.append('{');
+    for (const auto &field : _fields) {
+      field.encode(field.field, context, field.escaped_key, &value);
+    }
+    context.append_or_replace(',', '}');
+  }
+
+  detail::token_set leading_tokens() const {
+    return detail::token_object;
+  }
+
+ private:
+  /**
+   * Decode the fields of an object. If after_first_key is set, the '{' and the
+   * first key have already been consumed, and first_field_idx is the index of
+   * the field of that key (json_size_t_max if there is no such field).
+   */
+  template <bool into_existing, bool after_first_key = false>
+  json_force_inline void decode_fields(
+      decode_context &context,
+      object_type &output,
+      const size_t first_field_idx = json_size_t_max) const {
     uint_fast32_t uniq_seen_required = 0;
     detail::bitset<64> seen_required(_fields.num_required_fields());
+    size_t uniq_seen = 0;
+    detail::bitset<64> seen(into_existing ? _fields.size() : 0);
 
-    object_type output = construct(std::is_default_constructible<T>());
-    detail::decode_object<string_t>(context, [&](const std::string &key) {
-      const auto *field_ptr = _fields.find(key);
-      if (json_unlikely(!field_ptr)) {
+    size_t expected_field_idx = 0;
+    const auto decode_value = [&](const size_t field_idx) {
+      if (json_unlikely(field_idx == json_size_t_max)) {
         return detail::skip_value(context);
       }
 
-      const auto &field = from_field_storage_ptr(field_ptr);
-      field.decode(context, output);
+      expected_field_idx = field_idx + 1;
+      const auto &field = _fields.at(field_idx);
+      const auto decode = (into_existing ? field.decode_into : field.decode);
+      decode(field.field, context, &output);
       if (field.is_required()) {
-        const auto seen = seen_required.test_and_set(field.required_field_idx());
+        const auto seen = seen_required.test_and_set(field.required_field_idx);
         uniq_seen_required += (1 - seen);  // 'seen' is 1 when the field is a duplicate; 0 otherwise
       }
-    });
+      if (into_existing) {
+        uniq_seen += (1 - seen.test_and_set(field_idx));
+      }
+    };
+
+    const auto decode_field = [&]{
+      const auto field_idx = decode_key(context, expected_field_idx);
+      detail::skip_any_whitespace(context);
+      detail::skip_1(context, ':');
+      if (json_unlikely(context.has_failed())) {
+        return;
+      }
+      detail::skip_any_whitespace(context);
+      decode_value(field_idx);
+    };
+
+    if (!after_first_key) {
+      detail::decode_comma_separated(context, '{', '}', decode_field);
+    } else {
+      detail::decode_comma_separated_after_first(
+          context, '}', [&]{ decode_value(first_field_idx); }, decode_field);
+    }
+
+    if (json_unlikely(context.has_failed())) {
+      return;
+    }
 
     const auto is_missing_req_fields = (uniq_seen_required != _fields.num_required_fields());
-    detail::fail_if(context, is_missing_req_fields, "Missing required field(s)");
-    return output;
+    if (detail::fail_if(context, is_missing_req_fields, "Missing required field(s)")) {
+      return;
+    }
+
+    if (into_existing && uniq_seen != _fields.size()) {
+      reset_fields(seen, output);
+    }
   }
 
-  void encode(encode_context &context, const object_type &value) const {
-    context.append('{');
-    for (const auto &field_storage : _fields) {
-      const auto &field = from_field_storage_ptr(field_storage.second.get());
-      field.encode(context, field_storage.first, value);
+  /**
+   * Reset the fields that have not been seen to their values in a newly
+   * constructed object. Assigning into the existing values lets strings and
+   * containers keep their capacity. Values that can not be copied are moved
+   * out of the prototype instead, which is only used for this.
+   */
+  json_never_inline void reset_fields(const detail::bitset<64> &seen, object_type &output) const {
+    auto prototype = construct(std::is_default_constructible<T>());
+    for (size_t field_idx = 0; field_idx < _fields.size(); field_idx++) {
+      if (!seen.test(field_idx)) {
+        const auto &field = _fields.at(field_idx);
+        field.reset(field.field, &prototype, &output);
+      }
     }
-    context.append_or_replace(',', '}');
   }
 
- private:
+  /**
+   * Decode an object key and find the index of the field that it refers to, or
+   * json_size_t_max if there is no such field. Producers usually write fields
+   * in the order in which they were registered, so the key is first compared
+   * against the escaped key of the field that is expected to come next, which
+   * only costs a single memcmp. If that fails, the field is looked up by name.
+   */
+  json_force_inline size_t decode_key(decode_context &context, const size_t expected_idx) const {
+    if (json_likely(expected_idx < _fields.size())) {
+      const auto &expected_key = _fields.at(expected_idx).escaped_key;
+      const auto expected_key_size = expected_key.size() - 1;  // the key without the ':'
+      if (json_likely(
+          context.remaining() >= expected_key_size &&
+          std::memcmp(context.position, expected_key.data(), expected_key_size) == 0)) {
+        detail::skip_unchecked_n(context, expected_key_size);
+        return expected_idx;
+      }
+    }
+
+    return decode_unexpected_key(context);
+  }
+
+  /**
+   * Keys without escape sequences are matched directly against the input, so
+   * decoding them does not allocate memory. Only escaped keys are unescaped
+   * into an std::string before they are looked up.
+   */
+  json_force_inline size_t decode_unexpected_key(decode_context &context) const {
+    detail::skip_1(context, '"');
+    if (json_unlikely(context.has_failed())) {
+      return json_size_t_max;
+    }
+
+    const auto begin = context.position;
+    detail::skip_any_simple_characters(context);
+
+    switch (detail::next(context, "Unterminated string")) {
+      case '"': return _fields.find_index(begin, context.position - begin - 1);
+      case '\\': return decode_escaped_key(context, begin - 1);
+      default: return json_size_t_max;  // The input ended, so decoding has failed
+    }
+  }
+
+  json_never_inline size_t decode_escaped_key(decode_context &context, const char *begin) const {
+    context.position = begin;
+    const auto key = string_t().decode(context);
+    return _fields.find_index(key.data(), key.size());
+  }
+
   json_force_inline static void append_key_to_context(
       encode_context &context,
       const std::string &escaped_key) {
@@ -131,42 +283,22 @@ class object_t final {
     return _construct();
   }
 
-  struct field {
-    field(bool required, size_t required_field_idx)
-        : _data(required ? required_field_idx : json_size_t_max) {}
-    virtual ~field() = default;
-
-    virtual void decode(decode_context &context, object_type &object) const = 0;
-    virtual void encode(
-        encode_context &context,
-        const std::string &escaped_key,
-        const object_type &object) const = 0;
-
-    json_force_inline bool is_required() const { return (_data != json_size_t_max); }
-    json_force_inline size_t required_field_idx() const { return _data; }
-
-   private:
-    size_t _data;
-  };
-
-  static const field &from_field_storage_ptr(const void *field_storage) {
-    return *static_cast<const field *>(field_storage);
-  }
-
   template <typename codec_type>
-  struct dummy_field final : public field {
-    dummy_field(bool required, size_t required_field_idx, codec_type codec)
-        : field(required, required_field_idx),
-          codec(std::move(codec)) {}
-
-    void decode(decode_context &context, object_type &object) const override {
+  struct dummy_field final {
+    void decode(decode_context &context, object_type &object) const {
       codec.decode(context);
     }
 
+    void decode_into(decode_context &context, object_type &object) const {
+      decode(context, object);
+    }
+
+    void reset(object_type &, object_type &) const {}
+
     void encode(
         encode_context &context,
         const std::string &escaped_key,
-        const object_type &object) const override {
+        const object_type &object) const {
       const auto &value = typename codec_type::object_type();
       if (json_likely(detail::should_encode(codec, value))) {
         append_key_to_context(context, escaped_key);
@@ -178,20 +310,23 @@ class object_t final {
   };
 
   template <typename member_ptr, typename codec_type>
-  struct member_var_field final : public field {
-    member_var_field(bool required, size_t required_field_idx, codec_type codec, member_ptr member)
-        : field(required, required_field_idx),
-          codec(std::move(codec)),
-          member(member) {}
-
-    void decode(decode_context &context, object_type &object) const override {
+  struct member_var_field final {
+    void decode(decode_context &context, object_type &object) const {
       object.*member = codec.decode(context);
     }
 
+    void decode_into(decode_context &context, object_type &object) const {
+      detail::decode_into(codec, context, object.*member);
+    }
+
+    void reset(object_type &prototype, object_type &object) const {
+      reset_member(prototype.*member, object.*member);
+    }
+
     void encode(
         encode_context &context,
         const std::string &escaped_key,
-        const object_type &object) const override {
+        const object_type &object) const {
       const auto &value = object.*member;
       if (json_likely(detail::should_encode(codec, value))) {
         append_key_to_context(context, escaped_key);
@@ -204,22 +339,27 @@ class object_t final {
   };
 
   template <typename getter_ptr, typename setter_ptr, typename codec_type>
-  struct member_fn_field final : public field {
-    member_fn_field(
-        bool required, size_t required_field_idx, codec_type codec, getter_ptr getter, setter_ptr setter)
-        : field(required, required_field_idx),
-          codec(std::move(codec)),
-          getter(getter),
-          setter(setter) {}
-
-    void decode(decode_context &context, object_type &object) const override {
-      (object.*setter)(codec.decode(context));
+  struct member_fn_field final {
+    void decode(decode_context &context, object_type &object) const {
+      auto value = codec.decode(context);
+      if (json_likely(!context.has_failed())) {
+        (object.*setter)(std::move(value));
+      }
+    }
+
+    void decode_into(decode_context &context, object_type &object) const {
+      decode(context, object);
+    }
+
+    void reset(object_type &prototype, object_type &object) const {
+      auto value = reset_value<typename codec_type::object_type>((prototype.*getter)());
+      (object.*setter)(std::move(value));
     }
 
     void encode(
         encode_context &context,
         const std::string &escaped_key,
-        const object_type &object) const override {
+        const object_type &object) const {
       const auto &value = (object.*getter)();
       if (json_likely(detail::should_encode(codec, value))) {
         append_key_to_context(context, escaped_key);
@@ -233,23 +373,27 @@ class object_t final {
   };
 
   template <typename getter, typename setter, typename codec_type>
-  struct custom_field final : public field {
-    template <typename getter_arg, typename setter_arg>
-    custom_field(
-        bool required, size_t required_field_idx, codec_type codec, getter_arg &&get, setter_arg &&set)
-        : field(required, required_field_idx),
-          codec(std::move(codec)),
-          get(std::forward<getter_arg>(get)),
-          set(std::forward<setter_arg>(set)) {}
-
-    void decode(decode_context &context, object_type &object) const override {
-      set(object, codec.decode(context));
+  struct custom_field final {
+    void decode(decode_context &context, object_type &object) const {
+      auto value = codec.decode(context);
+      if (json_likely(!context.has_failed())) {
+        set(object, std::move(value));
+      }
+    }
+
+    void decode_into(decode_context &context, object_type &object) const {
+      decode(context, object);
+    }
+
+    void reset(object_type &prototype, object_type &object) const {
+      auto value = reset_value<typename codec_type::object_type>(get(prototype));
+      set(object, std::move(value));
     }
 
     void encode(
         encode_context &context,
         const std::string &escaped_key,
-        const object_type &object) const override {
+        const object_type &object) const {
       const auto &value = get(object);
       if (json_likely(detail::should_encode(codec, value))) {
         append_key_to_context(context, escaped_key);
@@ -262,6 +406,120 @@ class object_t final {
     setter set;
   };
 
+  template <typename field_type>
+  static void decode_field(const void *field, decode_context &context, void *object) {
+    static_cast<const field_type *>(field)->decode(context, *static_cast<object_type *>(object));
+  }
+
+  template <typename field_type>
+  static void decode_field_into(const void *field, decode_context &context, void *object) {
+    static_cast<const field_type *>(field)->decode_into(context, *static_cast<object_type *>(object));
+  }
+
+  template <typename field_type>
+  static void reset_field(const void *field, void *prototype, void *object) {
+    static_cast<const field_type *>(field)->reset(
+        *static_cast<object_type *>(prototype), *static_cast<object_type *>(object));
+  }
+
+  template <typename...>
+  struct void_type {
+    using type = void;
+  };
+
+  /**
+   * Whether values of the type can be copy constructed. Standard containers
+   * can be copied according to the type traits even when their elements can
+   * not, so the elements of types with a value_type are checked as well.
+   */
+  template <typename value_type, typename = void>
+  struct is_copy_constructible : std::is_copy_constructible<value_type> {};
+
+  template <typename value_type>
+  struct is_copy_constructible<value_type, typename void_type<typename value_type::value_type>::type>
+      : std::integral_constant<bool,
+          std::is_copy_constructible<value_type>::value &&
+          is_copy_constructible<typename value_type::value_type>::value> {};
+
+  template <typename value_type>
+  using is_copyable = std::integral_constant<bool,
+      is_copy_constructible<value_type>::value &&
+      std::is_copy_assignable<value_type>::value>;
+
+  template <typename value_type>
+  static typename std::enable_if<is_copyable<value_type>::value>::type
+  reset_member(value_type &prototype_value, value_type &value) {
+    value = prototype_value;
+  }
+
+  template <typename value_type>
+  static typename std::enable_if<!is_copyable<value_type>::value>::type
+  reset_member(value_type &prototype_value, value_type &value) {
+    value = std::move(prototype_value);
+  }
+
+  /**
+   * The value that a field with a getter and a setter is reset to: the value
+   * that the getter returns for the prototype, or a value initialized one if
+   * that is a reference to a value that can not be copied.
+   */
+  template <typename value_type, typename source_type>
+  using can_reset_from = std::integral_constant<bool,
+      std::is_constructible<value_type, source_type &&>::value &&
+      (!std::is_lvalue_reference<source_type>::value || is_copyable<value_type>::value)>;
+
+  template <typename value_type, typename source_type>
+  static typename std::enable_if<can_reset_from<value_type, source_type>::value, value_type>::type
+  reset_value(source_type &&source) {
+    return value_type(std::forward<source_type>(source));
+  }
+
+  template <typename value_type, typename source_type>
+  static typename std::enable_if<!can_reset_from<value_type, source_type>::value, value_type>::type
+  reset_value(source_type &&) {
+    return value_type();
+  }
+
+  template <typename field_type>
+  static void encode_field(
+      const void *field,
+      encode_context &context,
+      const std::string &escaped_key,
+      const void *object) {
+    static_cast<const field_type *>(field)->encode(
+        context, escaped_key, *static_cast<const object_type *>(object));
+  }
+
+  template <typename codec_type>
+  static auto codec_heap_size(const codec_type &codec, int) -> decltype(codec.memory_footprint()) {
+    return codec.memory_footprint() - sizeof(codec);
+  }
+
+  template <typename codec_type>
+  static size_t codec_heap_size(const codec_type &, ...) {
+    return 0;
+  }
+
+  /**
+   * Save a field to the registry, together with the functions that decode and
+   * encode it. The fields are aggregates, so they are brace initialized with
+   * the codec followed by the accessors of the field.
+   */
+  template <typename field_type, typename... args_type>
+  void save_field(const std::string &name, bool required, args_type &&...args) {
+    const auto field = std::make_shared<const field_type>(
+        field_type{ std::forward<args_type>(args)... });
+    _fields.save(
+        name,
+        required,
+        field,
+        sizeof(field_type) + codec_heap_size(field->codec, 0),
+        &decode_field<field_type>,
+        &decode_field_into<field_type>,
+        &reset_field<field_type>,
+        &encode_field<field_type>);
+  }
+
   template <typename value_type, typename object_type>
   void add_field(const std::string &name, bool required, value_type object_type::*member_ptr) {
     add_field(name, required, member_ptr, default_codec<value_type>());
@@ -275,11 +533,7 @@ class object_t final {
       codec_type &&codec) {
     using member_ptr = value_type (object_type::*);
     using field_type = member_var_field<member_ptr, typename std::decay<codec_type>::type>;
-    _fields.save(name, required, std::make_shared<field_type>(
-        required,
-        _fields.num_required_fields(),
-        std::forward<codec_type>(codec),
-        member));
+    save_field<field_type>(name, required, std::forward<codec_type>(codec), member);
   }
 
   template <
@@ -310,12 +564,7 @@ class object_t final {
     using getter_ptr = get_type (get_object_type::*)() const;
     using setter_ptr = void (set_object_type::*)(set_type);
     using field_type = member_fn_field<getter_ptr, setter_ptr, typename std::decay<codec_type>::type>;
-    _fields.save(name, required, std::make_shared<field_type>(
-        required,
-        _fields.num_required_fields(),
-        std::forward<codec_type>(codec),
-        getter,
-        setter));
+    save_field<field_type>(name, required, std::forward<codec_type>(codec), getter, setter);
   }
 
   template <typename getter, typename setter>
@@ -334,21 +583,19 @@ class object_t final {
         typename std::decay<getter>::type,
         typename std::decay<setter>::type,
         typename std::decay<codec_type>::type>;
-    _fields.save(name, required, std::make_shared<field_type>(required,
-        _fields.num_required_fields(),
+    save_field<field_type>(
+        name,
+        required,
         std::forward<codec_type>(codec),
         std::forward<getter>(get),
-        std::forward<setter>(set)));
+        std::forward<setter>(set));
   }
 
   template <typename codec_type,
             typename = typename std::enable_if<!std::is_member_pointer<codec_type>::value>::type>
   void add_field(const std::string &name, bool required, codec_type &&codec) {
     using field_type = dummy_field<typename std::decay<codec_type>::type>;
-    _fields.save(name, required, std::make_shared<field_type>(
-        required,
-        _fields.num_required_fields(),
-        std::forward<codec_type>(codec)));
+    save_field<field_type>(name, required, std::forward<codec_type>(codec));
   }
 
   /**
@@ -21,6 +21,7 @@
 #include <spotify/json/decode_context.hpp>
 #include <spotify/json/detail/decode_helpers.hpp>
 #include <spotify/json/detail/encode_helpers.hpp>
+#include <spotify/json/detail/leading_tokens.hpp>
 #include <spotify/json/encode_context.hpp>
 
 namespace spotify {
@@ -34,12 +35,17 @@ class omit_t final {
 
   object_type decode(decode_context &context) const {
     detail::fail(context, "omit_t codec cannot decode");
+    return detail::failed_value<object_type>(context);
   }
 
   void encode(encode_context &context, const object_type &value) const {
     detail::fail(context, "omit_t codec cannot encode");
   }
 
+  detail::token_set leading_tokens() const {
+    return 0;  // Decoding always fails
+  }
+
   bool should_encode(const object_type &value) const {
     return false;
   }
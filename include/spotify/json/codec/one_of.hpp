@@ -16,10 +16,15 @@
 
 #pragma once
 
+#include <array>
 #include <tuple>
 #include <type_traits>
 
 #include <spotify/json/decode_context.hpp>
+#include <spotify/json/decode_exception.hpp>
+#include <spotify/json/detail/decode_helpers.hpp>
+#include <spotify/json/detail/leading_tokens.hpp>
+#include <spotify/json/detail/macros.hpp>
 #include <spotify/json/encode_context.hpp>
 
 namespace spotify {
@@ -41,28 +46,97 @@ struct codecs_share_same_object_type<codec_type_1, codec_type_2, codecs_type...>
               typename codec_type_2::object_type>::value &&
           codecs_share_same_object_type<codec_type_2, codecs_type...>::value> {};
 
+/**
+ * The kinds of tokens that each of the codecs in a one_of_t can decode, and
+ * the kinds of tokens that any of the codecs after it can decode. The latter
+ * tells if a codec is the last one that could possibly decode the input.
+ */
+template <size_t codec_count>
+struct one_of_tokens {
+  std::array<token_set, codec_count> accepted;
+  std::array<token_set, codec_count> accepted_by_later;
+};
+
+template <typename tuple_type, size_t N>
+struct collect_tokens {
+  static constexpr size_t codec_count = std::tuple_size<tuple_type>::value;
+  static constexpr size_t index = codec_count - N;
+
+  static token_set collect(const tuple_type &tuple, one_of_tokens<codec_count> &tokens) {
+    const auto later = collect_tokens<tuple_type, N - 1>::collect(tuple, tokens);
+    tokens.accepted[index] = leading_tokens(std::get<index>(tuple));
+    tokens.accepted_by_later[index] = later;
+    return later | tokens.accepted[index];
+  }
+};
+
+template <typename tuple_type>
+struct collect_tokens<tuple_type, 0> {
+  static constexpr size_t codec_count = std::tuple_size<tuple_type>::value;
+
+  static token_set collect(const tuple_type &, one_of_tokens<codec_count> &) {
+    return 0;
+  }
+};
+
+/**
+ * Tries the remaining N codecs in order, skipping those that can not decode
+ * the kind of token that the input starts with. A codec is tried with a
+ * no_throw_scope only if a later codec could decode the input as well, so
+ * falling back to the next codec does not involve any exceptions, unless a
+ * custom codec throws one itself. Other codecs fail the way that the context
+ * fails. If no codec can decode the token, the last codec reports the error.
+ * Codecs that are tried may not modify the input (see immutable_input_scope).
+ */
 template <typename tuple_type, size_t N>
 struct try_each_codec {
-  using object_type = typename std::tuple_element<
-      std::tuple_size<tuple_type>::value - N, tuple_type>::type::object_type;
+  static constexpr size_t codec_count = std::tuple_size<tuple_type>::value;
+  static constexpr size_t index = codec_count - N;
+  using object_type = typename std::tuple_element<index, tuple_type>::type::object_type;
+
+  static object_type decode(
+      const tuple_type &tuple,
+      const one_of_tokens<codec_count> &tokens,
+      const token_set token,
+      decode_context &context) {
+    if (!(tokens.accepted[index] & token)) {
+      return try_each_codec<tuple_type, N - 1>::decode(tuple, tokens, token, context);
+    }
+
+    if (!(tokens.accepted_by_later[index] & token)) {
+      return std::get<index>(tuple).decode(context);
+    }
 
-  static object_type decode(const tuple_type &tuple, decode_context &context) {
     const auto original_position = context.position;
-    try {
-      return std::get<std::tuple_size<tuple_type>::value - N>(tuple).decode(context);
-    } catch (const decode_exception &) {
-      context.position = original_position;
-      return try_each_codec<tuple_type, N - 1>::decode(tuple, context);
+    {
+      const no_throw_scope no_throw(context);
+      const immutable_input_scope immutable_input(context);
+      json_try {
+        auto result = std::get<index>(tuple).decode(context);
+        if (json_likely(!context.has_failed())) {
+          return result;
+        }
+      } json_catch(const decode_exception &) {
+      }
     }
+
+    context.clear_error();
+    context.position = original_position;
+    return try_each_codec<tuple_type, N - 1>::decode(tuple, tokens, token, context);
   }
 };
 
 template <typename tuple_type>
-struct try_each_codec<tuple_type, 0> {
+struct try_each_codec<tuple_type, 1> {
+  static constexpr size_t codec_count = std::tuple_size<tuple_type>::value;
   using object_type = typename std::tuple_element<0, tuple_type>::type::object_type;
 
-  static object_type decode(const tuple_type &tuple, decode_context &context) {
-    return std::get<std::tuple_size<tuple_type>::value - 1>(tuple).decode(context);
+  static object_type decode(
+      const tuple_type &tuple,
+      const one_of_tokens<codec_count> &,
+      const token_set,
+      decode_context &context) {
+    return std::get<codec_count - 1>(tuple).decode(context);
   }
 };
 
@@ -72,7 +146,10 @@ namespace codec {
 
 /**
  * Takes an ordered list of codecs and applies them one by one. The first
- * one that succeeds will be used.
+ * one that succeeds will be used. Codecs that can not decode the kind of token
+ * that the input starts with (see codec_interface::leading_tokens) are not
+ * tried at all, so only codecs that accept the same kind of token are actually
+ * tried one by one.
  *
  * When encoding, the first codec is always used.
  */
@@ -87,11 +164,13 @@ class one_of_t final {
 
   template <typename... Args>
   explicit one_of_t(Args&& ...args)
-      : _codecs(std::forward<Args>(args)...) {}
+      : _codecs(std::forward<Args>(args)...) {
+    _all_tokens = detail::collect_tokens<codecs_tuple, codec_count>::collect(_codecs, _tokens);
+  }
 
   object_type decode(decode_context &context) const {
-    return detail::try_each_codec<
-        decltype(_codecs), std::tuple_size<decltype(_codecs)>::value>::decode(_codecs, context);
+    return detail::try_each_codec<codecs_tuple, codec_count>::decode(
+        _codecs, _tokens, detail::peek_token(context), context);
   }
 
   void encode(encode_context &context, const object_type &value) const {
@@ -102,8 +181,17 @@ class one_of_t final {
     return detail::should_encode(std::get<0>(_codecs), value);
   }
 
+  detail::token_set leading_tokens() const {
+    return _all_tokens;
+  }
+
  private:
-  std::tuple<codec_type, codecs_type ...> _codecs;
+  using codecs_tuple = std::tuple<codec_type, codecs_type ...>;
+  static constexpr size_t codec_count = std::tuple_size<codecs_tuple>::value;
+
+  codecs_tuple _codecs;
+  detail::one_of_tokens<codec_count> _tokens;
+  detail::token_set _all_tokens;
 };
 
 template <typename... codecs_type>
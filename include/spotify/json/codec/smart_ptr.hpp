@@ -21,6 +21,7 @@
 #include <spotify/json/decode_context.hpp>
 #include <spotify/json/default_codec.hpp>
 #include <spotify/json/detail/encode_helpers.hpp>
+#include <spotify/json/detail/leading_tokens.hpp>
 #include <spotify/json/encode_context.hpp>
 
 namespace spotify {
@@ -69,6 +70,10 @@ class smart_ptr_t final {
     _inner_codec.encode(context, *value);
   }
 
+  detail::token_set leading_tokens() const {
+    return detail::leading_tokens(_inner_codec);
+  }
+
   bool should_encode(const object_type &value) const {
     return bool(value);
   }
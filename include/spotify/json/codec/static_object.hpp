@@ -0,0 +1,652 @@
+/*
+ * Copyright (c) 2018 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/decode_context.hpp>
+#include <spotify/json/default_codec.hpp>
+#include <spotify/json/detail/bitset.hpp>
+#include <spotify/json/detail/decode_helpers.hpp>
+#include <spotify/json/detail/encode_helpers.hpp>
+#include <spotify/json/detail/leading_tokens.hpp>
+#include <spotify/json/detail/macros.hpp>
+#include <spotify/json/detail/skip_value.hpp>
+#include <spotify/json/encode_context.hpp>
+
+namespace spotify {
+namespace json {
+namespace detail {
+
+template <typename member_ptr>
+struct static_member_var final {
+  member_ptr member;
+
+  template <typename object_type>
+  json_force_inline auto get(const object_type &object) const -> decltype(object.*member) {
+    return object.*member;
+  }
+
+  template <bool into_existing, typename codec_type, typename object_type>
+  json_force_inline void decode(
+      const codec_type &codec,
+      decode_context &context,
+      object_type &object) const {
+    if (into_existing) {
+      decode_into(codec, context, object.*member);
+    } else {
+      object.*member = codec.decode(context);
+    }
+  }
+
+  template <typename object_type>
+  json_force_inline void reset(const object_type &prototype, object_type &object) const {
+    object.*member = prototype.*member;
+  }
+};
+
+template <typename getter_ptr, typename setter_ptr>
+struct static_member_fn final {
+  getter_ptr getter;
+  setter_ptr setter;
+
+  template <typename object_type>
+  json_force_inline auto get(const object_type &object) const -> decltype((object.*getter)()) {
+    return (object.*getter)();
+  }
+
+  template <bool into_existing, typename codec_type, typename object_type>
+  json_force_inline void decode(
+      const codec_type &codec,
+      decode_context &context,
+      object_type &object) const {
+    auto value = codec.decode(context);
+    if (json_likely(!context.has_failed())) {
+      (object.*setter)(std::move(value));
+    }
+  }
+
+  template <typename object_type>
+  json_force_inline void reset(const object_type &prototype, object_type &object) const {
+    auto value = typename std::decay<decltype((prototype.*getter)())>::type((prototype.*getter)());
+    (object.*setter)(std::move(value));
+  }
+};
+
+/**
+ * Decodes and encodes the fields of a static_object_t. The field list is known
+ * at compile time, so looking up a field unrolls into a chain of comparisons
+ * against keys of constant length (which the compiler turns into a few integer
+ * comparisons instead of calls to memcmp), and going from a field index to the
+ * field unrolls into what is effectively a switch statement.
+ */
+template <typename T, size_t remaining_count, size_t required_idx, typename... fields_type>
+struct static_object_fields final {
+  static constexpr size_t field_count = sizeof...(fields_type);
+  static constexpr size_t field_idx = field_count - remaining_count;
+  using field_type = typename std::tuple_element<field_idx, std::tuple<fields_type...>>::type;
+  using next_fields = static_object_fields<
+      T,
+      remaining_count - 1,
+      required_idx + (field_type::is_required ? 1 : 0),
+      fields_type...>;
+
+  static constexpr size_t num_required_fields =
+      (field_type::is_required ? 1 : 0) + next_fields::num_required_fields;
+
+  /**
+   * Find the index of the field with the given (unescaped) name, or
+   * json_size_t_max if there is no such field.
+   */
+  json_force_inline static size_t find(
+      const std::tuple<fields_type...> &fields,
+      const char *key,
+      size_t key_size) {
+    const auto &field = std::get<field_idx>(fields);
+    if (key_size == field_type::key_size && std::memcmp(key, field.key(), field_type::key_size) == 0) {
+      return field_idx;
+    }
+    return next_fields::find(fields, key, key_size);
+  }
+
+  /**
+   * Skip past the quoted key of the field with the given index if the input
+   * at the current position is exactly that key. Returns false otherwise.
+   */
+  json_force_inline static bool skip_key(
+      const std::tuple<fields_type...> &fields,
+      size_t idx,
+      decode_context &context) {
+    if (idx != field_idx) {
+      return next_fields::skip_key(fields, idx, context);
+    }
+
+    const auto &field = std::get<field_idx>(fields);
+    const auto quoted_key_size = (field_type::key_size + 2);
+    if (context.remaining() >= quoted_key_size &&
+        std::memcmp(context.position, field.escaped_key.data(), quoted_key_size) == 0) {
+      skip_unchecked_n(context, quoted_key_size);
+      return true;
+    }
+    return false;
+  }
+
+  template <bool into_existing, typename bitset_type>
+  json_force_inline static void decode(
+      const std::tuple<fields_type...> &fields,
+      size_t idx,
+      decode_context &context,
+      T &object,
+      bitset_type &seen_required,
+      uint_fast32_t &uniq_seen_required) {
+    if (idx != field_idx) {
+      return next_fields::template decode<into_existing>(
+          fields, idx, context, object, seen_required, uniq_seen_required);
+    }
+
+    const auto &field = std::get<field_idx>(fields);
+    field.accessor.template decode<into_existing>(field.codec, context, object);
+    if (field_type::is_required) {
+      const auto seen = seen_required.test_and_set(required_idx);
+      uniq_seen_required += (1 - seen);  // 'seen' is 1 when the field is a duplicate; 0 otherwise
+    }
+  }
+
+  /**
+   * Reset the fields that are not in seen to their values in prototype.
+   */
+  template <typename bitset_type>
+  json_force_inline static void reset(
+      const std::tuple<fields_type...> &fields,
+      const bitset_type &seen,
+      const T &prototype,
+      T &object) {
+    if (!seen.test(field_idx)) {
+      std::get<field_idx>(fields).accessor.reset(prototype, object);
+    }
+    next_fields::reset(fields, seen, prototype, object);
+  }
+
+  json_force_inline static void encode(
+      const std::tuple<fields_type...> &fields,
+      encode_context &context,
+      const T &object) {
+    const auto &field = std::get<field_idx>(fields);
+    const auto &value = field.accessor.get(object);
+    if (json_likely(detail::should_encode(field.codec, value))) {
+      context.append(field.escaped_key.data(), field.escaped_key.size());
+      field.codec.encode(context, value);
+      context.append(',');
+    }
+    next_fields::encode(fields, context, object);
+  }
+};
+
+template <typename T, size_t required_idx, typename... fields_type>
+struct static_object_fields<T, 0, required_idx, fields_type...> final {
+  static constexpr size_t num_required_fields = 0;
+
+  json_force_inline static size_t find(const std::tuple<fields_type...> &, const char *, size_t) {
+    return json_size_t_max;
+  }
+
+  json_force_inline static bool skip_key(
+      const std::tuple<fields_type...> &,
+      size_t,
+      decode_context &) {
+    return false;
+  }
+
+  template <bool into_existing, typename bitset_type>
+  json_force_inline static void decode(
+      const std::tuple<fields_type...> &,
+      size_t,
+      decode_context &,
+      T &,
+      bitset_type &,
+      uint_fast32_t &) {}
+
+  template <typename bitset_type>
+  json_force_inline static void reset(
+      const std::tuple<fields_type...> &,
+      const bitset_type &,
+      const T &,
+      T &) {}
+
+  json_force_inline static void encode(
+      const std::tuple<fields_type...> &,
+      encode_context &,
+      const T &) {}
+};
+
+/**
+ * The key of a field of a static_object_t, as a type. Keys are types rather
+ * than strings so that keys that need escaping and duplicate keys are caught
+ * when the codec is compiled. Use json_static_key to get one from a literal.
+ */
+template <char... chars>
+struct static_key final {
+  static constexpr size_t size = sizeof...(chars);
+
+  /**
+   * The key surrounded by quotes and followed by a ':'.
+   */
+  static std::array<char, size + 3> escaped() {
+    return std::array<char, size + 3>{ { '"', chars..., '"', ':' } };
+  }
+};
+
+constexpr bool static_key_char_needs_escaping(char c) {
+  return (static_cast<unsigned char>(c) < 0x20 || c == '"' || c == '\\');
+}
+
+template <typename key_type>
+struct static_key_needs_escaping;
+
+template <>
+struct static_key_needs_escaping<static_key<>> : std::false_type {};
+
+template <char c, char... chars>
+struct static_key_needs_escaping<static_key<c, chars...>> : std::integral_constant<
+    bool,
+    static_key_char_needs_escaping(c) || static_key_needs_escaping<static_key<chars...>>::value> {};
+
+template <typename key_type, typename... key_types>
+struct static_key_is_one_of : std::false_type {};
+
+template <typename key_type, typename other_key_type, typename... key_types>
+struct static_key_is_one_of<key_type, other_key_type, key_types...> : std::integral_constant<
+    bool,
+    std::is_same<key_type, other_key_type>::value ||
+    static_key_is_one_of<key_type, key_types...>::value> {};
+
+template <typename... key_types>
+struct static_keys_have_duplicates : std::false_type {};
+
+template <typename key_type, typename... key_types>
+struct static_keys_have_duplicates<key_type, key_types...> : std::integral_constant<
+    bool,
+    static_key_is_one_of<key_type, key_types...>::value ||
+    static_keys_have_duplicates<key_types...>::value> {};
+
+/**
+ * Take the first size characters of chars. json_static_key pads every key to
+ * the same number of characters, so this is what turns equal keys into the
+ * same static_key type.
+ */
+template <bool done, size_t size, typename key_type, char... chars>
+struct make_static_key;
+
+template <size_t size, char... key_chars, char c, char... chars>
+struct make_static_key<false, size, static_key<key_chars...>, c, chars...>
+    : make_static_key<size == 1, size - 1, static_key<key_chars..., c>, chars...> {};
+
+template <size_t size, char... key_chars, char... chars>
+struct make_static_key<true, size, static_key<key_chars...>, chars...> {
+  using type = static_key<key_chars...>;
+};
+
+constexpr size_t static_key_max_size = 64;
+
+template <size_t size, char... chars>
+struct static_key_from_chars final {
+  static_assert(
+      size <= static_key_max_size,
+      "Keys of static objects must be at most 64 characters long");
+  using type = typename make_static_key<
+      (size == 0 || size > static_key_max_size), size, static_key<>, chars...>::type;
+};
+
+template <size_t N>
+constexpr char static_key_char(const char (&name)[N], size_t i) {
+  return (i < N ? name[i] : '\0');
+}
+
+#define json_static_key_chars_4(name, i) \
+  ::spotify::json::detail::static_key_char(name, (i)), \
+  ::spotify::json::detail::static_key_char(name, (i) + 1), \
+  ::spotify::json::detail::static_key_char(name, (i) + 2), \
+  ::spotify::json::detail::static_key_char(name, (i) + 3)
+#define json_static_key_chars_16(name, i) \
+  json_static_key_chars_4(name, (i)), \
+  json_static_key_chars_4(name, (i) + 4), \
+  json_static_key_chars_4(name, (i) + 8), \
+  json_static_key_chars_4(name, (i) + 12)
+#define json_static_key_chars_64(name) \
+  json_static_key_chars_16(name, 0), \
+  json_static_key_chars_16(name, 16), \
+  json_static_key_chars_16(name, 32), \
+  json_static_key_chars_16(name, 48)
+
+/**
+ * A field of a static_object_t. The key is stored inline, already escaped and
+ * surrounded by quotes and followed by a ':', so that encoding the key is a
+ * single copy of a constant number of bytes.
+ */
+template <bool required, typename static_key_type, typename accessor_type, typename codec_type>
+struct static_field_t final {
+  using key_type = static_key_type;
+  static constexpr bool is_required = required;
+  static constexpr size_t key_size = key_type::size;
+
+  static_assert(
+      !static_key_needs_escaping<key_type>::value,
+      "Keys of static objects must not need to be escaped");
+
+  static_field_t(accessor_type accessor, codec_type codec)
+      : escaped_key(key_type::escaped()),
+        accessor(std::move(accessor)),
+        codec(std::move(codec)) {}
+
+  json_force_inline const char *key() const { return &escaped_key[1]; }
+
+  std::array<char, key_size + 3> escaped_key;
+  accessor_type accessor;
+  codec_type codec;
+};
+
+template <bool required, typename key_type, typename value_type, typename object_type, typename codec_type>
+static_field_t<required, key_type, static_member_var<value_type object_type::*>, typename std::decay<codec_type>::type>
+make_static_field(key_type, value_type object_type::*member, codec_type &&codec) {
+  using accessor_type = static_member_var<value_type object_type::*>;
+  return static_field_t<required, key_type, accessor_type, typename std::decay<codec_type>::type>(
+      accessor_type{ member }, std::forward<codec_type>(codec));
+}
+
+template <
+    bool required,
+    typename key_type,
+    typename get_type,
+    typename set_type,
+    typename get_object_type,
+    typename set_object_type,
+    typename codec_type>
+static_field_t<
+    required,
+    key_type,
+    static_member_fn<
+        get_type (get_object_type::*)() const,
+        void (set_object_type::*)(set_type)>,
+    typename std::decay<codec_type>::type>
+make_static_field(
+    key_type,
+    get_type (get_object_type::*getter)() const,
+    void (set_object_type::*setter)(set_type),
+    codec_type &&codec) {
+  using accessor_type = static_member_fn<
+      get_type (get_object_type::*)() const,
+      void (set_object_type::*)(set_type)>;
+  return static_field_t<required, key_type, accessor_type, typename std::decay<codec_type>::type>(
+      accessor_type{ getter, setter }, std::forward<codec_type>(codec));
+}
+
+}  // namespace detail
+
+namespace codec {
+
+template <typename T, typename... fields_type>
+class static_object_t final {
+  using fields = detail::static_object_fields<T, sizeof...(fields_type), 0, fields_type...>;
+
+ public:
+  using object_type = T;
+
+  static_assert(
+      std::is_default_constructible<T>::value,
+      "static_object_t can only be used for default constructible types");
+  static_assert(
+      !detail::static_keys_have_duplicates<typename fields_type::key_type...>::value,
+      "Keys of static objects must be unique");
+
+  explicit static_object_t(fields_type... fields)
+      : _fields(std::move(fields)...) {}
+
+  object_type decode(decode_context &context) const {
+    object_type output;
+    decode_fields<false>(context, output);
+    return output;
+  }
+
+  /**
+   * Decode into an existing object, like object_t::decode_into. Fields that
+   * are not present in the input are reset to their default values.
+   */
+  void decode_into(decode_context &context, object_type &output) const {
+    decode_fields<true>(context, output);
+  }
+
+  /**
+   * Decode an object of which the '{' and the first key have already been
+   * consumed, like object_t::decode_after_first_key.
+   */
+  object_type decode_after_first_key(decode_context &context, const char *key, size_t key_size) const {
+    object_type output;
+    decode_fields<false, true>(context, output, fields::find(_fields, key, key_size));
+    return output;
+  }
+
+  void encode(encode_context &context, const object_type &value) const {
+    context.append('{');
+    fields::encode(_fields, context, value);
+    context.append_or_replace(',', '}');
+  }
+
+  detail::token_set leading_tokens() const {
+    return detail::token_object;
+  }
+
+ private:
+  template <bool into_existing, bool after_first_key = false>
+  json_force_inline void decode_fields(
+      decode_context &context,
+      object_type &output,
+      const size_t first_field_idx = json_size_t_max) const {
+    uint_fast32_t uniq_seen_required = 0;
+    detail::bitset<fields::num_required_fields> seen_required(fields::num_required_fields);
+    size_t uniq_seen = 0;
+    detail::bitset<sizeof...(fields_type)> seen(sizeof...(fields_type));
+
+    size_t expected_field_idx = 0;
+    const auto decode_value = [&](const size_t field_idx) {
+      if (json_unlikely(field_idx == json_size_t_max)) {
+        return detail::skip_value(context);
+      }
+
+      expected_field_idx = field_idx + 1;
+      fields::template decode<into_existing>(
+          _fields, field_idx, context, output, seen_required, uniq_seen_required);
+      if (into_existing) {
+        uniq_seen += (1 - seen.test_and_set(field_idx));
+      }
+    };
+
+    const auto decode_field = [&]{
+      const auto field_idx = decode_key(context, expected_field_idx);
+      detail::skip_any_whitespace(context);
+      detail::skip_1(context, ':');
+      if (json_unlikely(context.has_failed())) {
+        return;
+      }
+      detail::skip_any_whitespace(context);
+      decode_value(field_idx);
+    };
+
+    if (!after_first_key) {
+      detail::decode_comma_separated(context, '{', '}', decode_field);
+    } else {
+      detail::decode_comma_separated_after_first(
+          context, '}', [&]{ decode_value(first_field_idx); }, decode_field);
+    }
+
+    if (json_unlikely(context.has_failed())) {
+      return;
+    }
+
+    const auto is_missing_req_fields = (uniq_seen_required != fields::num_required_fields);
+    if (detail::fail_if(context, is_missing_req_fields, "Missing required field(s)")) {
+      return;
+    }
+
+    if (into_existing && uniq_seen != sizeof...(fields_type)) {
+      reset_fields(seen, output);
+    }
+  }
+
+  template <typename bitset_type>
+  json_never_inline void reset_fields(const bitset_type &seen, object_type &output) const {
+    const object_type prototype{};
+    fields::reset(_fields, seen, prototype, output);
+  }
+
+  /**
+   * Like object_t, first check if the key is the key of the field that follows
+   * the previously decoded field, which is usually the case.
+   */
+  json_force_inline size_t decode_key(decode_context &context, const size_t expected_idx) const {
+    if (json_likely(fields::skip_key(_fields, expected_idx, context))) {
+      return expected_idx;
+    }
+
+    detail::skip_1(context, '"');
+    if (json_unlikely(context.has_failed())) {
+      return json_size_t_max;
+    }
+
+    const auto begin = context.position;
+    detail::skip_any_simple_characters(context);
+
+    switch (detail::next(context, "Unterminated string")) {
+      case '"': return fields::find(_fields, begin, context.position - begin - 1);
+      case '\\': return decode_escaped_key(context, begin - 1);
+      default: return json_size_t_max;  // The input ended, so decoding has failed
+    }
+  }
+
+  json_never_inline size_t decode_escaped_key(decode_context &context, const char *begin) const {
+    context.position = begin;
+    const auto key = string_t().decode(context);
+    return fields::find(_fields, key.data(), key.size());
+  }
+
+  std::tuple<fields_type...> _fields;
+};
+
+template <typename T, typename... fields_type>
+static_object_t<T, typename std::decay<fields_type>::type...> static_object(fields_type &&...fields) {
+  return static_object_t<T, typename std::decay<fields_type>::type...>(
+      std::forward<fields_type>(fields)...);
+}
+
+/**
+ * Fields for static_object(). These take the same arguments as the required()
+ * and optional() methods of object_t, except for free getters and setters and
+ * fields without a member, and the name is a json_static_key.
+ */
+template <typename key_type, typename value_type, typename object_type>
+auto required_field(key_type name, value_type object_type::*member)
+    -> decltype(detail::make_static_field<true>(name, member, default_codec<value_type>())) {
+  return detail::make_static_field<true>(name, member, default_codec<value_type>());
+}
+
+template <typename key_type, typename value_type, typename object_type, typename codec_type>
+auto required_field(key_type name, value_type object_type::*member, codec_type &&codec)
+    -> decltype(detail::make_static_field<true>(name, member, std::forward<codec_type>(codec))) {
+  return detail::make_static_field<true>(name, member, std::forward<codec_type>(codec));
+}
+
+template <typename key_type, typename get_type, typename set_type, typename get_object_type, typename set_object_type>
+auto required_field(
+    key_type name,
+    get_type (get_object_type::*getter)() const,
+    void (set_object_type::*setter)(set_type))
+    -> decltype(detail::make_static_field<true>(
+        name, getter, setter, default_codec<typename std::decay<get_type>::type>())) {
+  return detail::make_static_field<true>(
+      name, getter, setter, default_codec<typename std::decay<get_type>::type>());
+}
+
+template <
+    typename key_type,
+    typename get_type,
+    typename set_type,
+    typename get_object_type,
+    typename set_object_type,
+    typename codec_type>
+auto required_field(
+    key_type name,
+    get_type (get_object_type::*getter)() const,
+    void (set_object_type::*setter)(set_type),
+    codec_type &&codec)
+    -> decltype(detail::make_static_field<true>(name, getter, setter, std::forward<codec_type>(codec))) {
+  return detail::make_static_field<true>(name, getter, setter, std::forward<codec_type>(codec));
+}
+
+template <typename key_type, typename value_type, typename object_type>
+auto optional_field(key_type name, value_type object_type::*member)
+    -> decltype(detail::make_static_field<false>(name, member, default_codec<value_type>())) {
+  return detail::make_static_field<false>(name, member, default_codec<value_type>());
+}
+
+template <typename key_type, typename value_type, typename object_type, typename codec_type>
+auto optional_field(key_type name, value_type object_type::*member, codec_type &&codec)
+    -> decltype(detail::make_static_field<false>(name, member, std::forward<codec_type>(codec))) {
+  return detail::make_static_field<false>(name, member, std::forward<codec_type>(codec));
+}
+
+template <typename key_type, typename get_type, typename set_type, typename get_object_type, typename set_object_type>
+auto optional_field(
+    key_type name,
+    get_type (get_object_type::*getter)() const,
+    void (set_object_type::*setter)(set_type))
+    -> decltype(detail::make_static_field<false>(
+        name, getter, setter, default_codec<typename std::decay<get_type>::type>())) {
+  return detail::make_static_field<false>(
+      name, getter, setter, default_codec<typename std::decay<get_type>::type>());
+}
+
+template <
+    typename key_type,
+    typename get_type,
+    typename set_type,
+    typename get_object_type,
+    typename set_object_type,
+    typename codec_type>
+auto optional_field(
+    key_type name,
+    get_type (get_object_type::*getter)() const,
+    void (set_object_type::*setter)(set_type),
+    codec_type &&codec)
+    -> decltype(detail::make_static_field<false>(name, getter, setter, std::forward<codec_type>(codec))) {
+  return detail::make_static_field<false>(name, getter, setter, std::forward<codec_type>(codec));
+}
+
+}  // namespace codec
+}  // namespace json
+}  // namespace spotify
+
+/**
+ * The key of a field of a static_object(), from a string literal of at most 64
+ * characters, for example required_field(json_static_key("x"), &Point::x).
+ */
+#define json_static_key(name) \
+  ::spotify::json::detail::static_key_from_chars< \
+      sizeof(name) - 1, json_static_key_chars_64(name)>::type()
@@ -23,6 +23,7 @@
 #include <spotify/json/default_codec.hpp>
 #include <spotify/json/detail/decode_helpers.hpp>
 #include <spotify/json/detail/escape.hpp>
+#include <spotify/json/detail/leading_tokens.hpp>
 #include <spotify/json/detail/macros.hpp>
 #include <spotify/json/detail/skip_chars.hpp>
 #include <spotify/json/encode_context.hpp>
@@ -31,16 +32,45 @@ namespace spotify {
 namespace json {
 namespace codec {
 
+class string_view_t;
+
 class string_t final {
  public:
   using object_type = std::string;
 
   json_never_inline object_type decode(decode_context &context) const {
+    object_type output;
+    detail::skip_1(context, '"');
+    if (json_likely(!context.has_failed())) {
+      decode_string(context, output);
+    }
+    return output;
+  }
+
+  /**
+   * Decode into an existing string. The string keeps its capacity, so this
+   * does not allocate memory unless the decoded string is longer.
+   */
+  json_never_inline void decode_into(decode_context &context, object_type &output) const {
     detail::skip_1(context, '"');
-    return decode_string(context);
+    if (json_likely(!context.has_failed())) {
+      decode_string(context, output);
+    }
   }
 
-  json_never_inline void encode(encode_context &context, const object_type value) const {
+  json_never_inline void encode(encode_context &context, const object_type &value) const {
+    encode_string(context, value.data(), value.size());
+  }
+
+  detail::token_set leading_tokens() const {
+    return detail::token_string;
+  }
+
+ private:
+  // string_view_t unescapes strings in place with the helpers below.
+  friend class string_view_t;
+
+  json_force_inline static void encode_string(encode_context &context, const char *data, size_t size) {
     context.append('"');
 
     // Write the strings in 1024 byte chunks, so that we do not have to reserve
@@ -49,8 +79,8 @@ class string_t final {
     // character, but that is ok since write_escaped will not escape characters
     // with the high bit set, so the combined escaped string will contain the
     // correct UTF-8 characters in the end.
-    auto chunk_begin = value.data();
-    const auto string_end = chunk_begin + value.size();
+    auto chunk_begin = data;
+    const auto string_end = chunk_begin + size;
 
     while (chunk_begin != string_end) {
       const auto chunk_end = std::min(chunk_begin + 1024, string_end);
@@ -61,38 +91,41 @@ class string_t final {
     context.append('"');
   }
 
- private:
-  json_force_inline static object_type decode_string(decode_context &context) {
+  json_force_inline static void decode_string(decode_context &context, std::string &out) {
     const auto begin_simple = context.position;
     detail::skip_any_simple_characters(context);
 
     switch (detail::next(context, "Unterminated string")) {
-      case '"': return std::string(begin_simple, context.position - 1);
-      case '\\': return decode_escaped_string(context, begin_simple);
-      default: json_unreachable();
+      case '"': out.assign(begin_simple, context.position - 1); break;
+      case '\\': decode_escaped_string(context, begin_simple, out); break;
+      default: break;  // The input ended, so decoding has failed
     }
   }
 
-  json_never_inline static object_type decode_escaped_string(decode_context &context, const char *begin) {
-    std::string unescaped(begin, context.position - 1);
+  json_never_inline static void decode_escaped_string(
+      decode_context &context,
+      const char *begin,
+      std::string &unescaped) {
+    unescaped.assign(begin, context.position - 1);
     decode_escape(context, unescaped);
 
-    while (json_likely(context.remaining())) {
+    while (json_likely(context.remaining() && !context.has_failed())) {
       const auto begin_simple = context.position;
       detail::skip_any_simple_characters(context);
       unescaped.append(begin_simple, context.position);
 
       switch (detail::next(context, "Unterminated string")) {
-        case '"': return unescaped;
+        case '"': return;
         case '\\': decode_escape(context, unescaped); break;
-        default: json_unreachable();
+        default: return;  // The input ended, so decoding has failed
       }
     }
 
     detail::fail(context, "Unterminated string");
   }
 
-  static void decode_escape(decode_context &context, std::string &out) {
+  template <typename string_type>
+  static void decode_escape(decode_context &context, string_type &out) {
     const auto escape_character = detail::next(context, "Unterminated string");
     switch (escape_character) {
       case '"':  out.push_back('"');  break;
@@ -113,10 +146,31 @@ class string_t final {
     if (c >= 'a' && c <= 'f') { return c - 'a' + 0xA; }
     if (c >= 'A' && c <= 'F') { return c - 'A' + 0xA; }
     detail::fail(context, "\\u must be followed by 4 hex digits");
+    return 0;
+  }
+
+  /**
+   * Like decode_hex_number, for when fewer than 4 bytes are left. A byte that
+   * is not a hex digit fails where it would with more input after it, so that
+   * a string fails in the same place however much of the input after it has
+   * been seen (see chunked_decoder).
+   */
+  static unsigned decode_short_hex_number(decode_context &context) {
+    const auto begin = context.position;
+    while (context.position != context.end) {
+      decode_hex_nibble(context, *(context.position++));
+      if (json_unlikely(context.has_failed())) {
+        return 0;
+      }
+    }
+    detail::fail(context, "\\u must be followed by 4 hex digits", begin - context.position);
+    return 0;
   }
 
   static unsigned decode_hex_number(decode_context &context) {
-    detail::require_bytes<4>(context, "\\u must be followed by 4 hex digits");
+    if (json_unlikely(context.remaining() < 4)) {
+      return decode_short_hex_number(context);
+    }
     const auto a = decode_hex_nibble(context, *(context.position++));
     const auto b = decode_hex_nibble(context, *(context.position++));
     const auto c = decode_hex_nibble(context, *(context.position++));
@@ -124,25 +178,32 @@ class string_t final {
     return unsigned((a << 12) | (b << 8) | (c << 4) | d);
   }
 
+  template <typename string_type>
   static void decode_unicode_escape(
       decode_context &context,
-      std::string &out) {
+      string_type &out) {
     const auto p = decode_hex_number(context);
+    if (json_unlikely(context.has_failed())) {
+      return;
+    }
     if (json_likely(!handle_surrogate_pair(context, out, p))) {
       encode_utf8(out, p);
     }
   }
 
+  template <typename string_type>
   static bool handle_surrogate_pair(
       decode_context &context,
-      std::string &out,
+      string_type &out,
       unsigned p) {
     if (json_unlikely(is_high_surrogate(p))) {
       // Parse low surrogate
       if (detail::peek_2(context, '\\', 'u')) {
         detail::skip_unchecked_n(context, 2);
         const auto n = decode_hex_number(context);
-        if (json_likely(is_low_surrogate(n))) {
+        if (json_unlikely(context.has_failed())) {
+          return true;
+        } else if (json_likely(is_low_surrogate(n))) {
           // Any Unicode codepoint encoded by a surrogate pair is 4 bytes in UTF-8
           encode_utf8_4(out, codepoint_from_surrogate_pair(p, n));
           return true;
@@ -156,7 +217,8 @@ class string_t final {
     return false;
   }
 
-  static void encode_utf8(std::string &out, unsigned p) {
+  template <typename string_type>
+  static void encode_utf8(string_type &out, unsigned p) {
     if (json_likely(p <= 0x7F)) {
       encode_utf8_1(out, p);
     } else if (json_likely(p <= 0x07FF)) {
@@ -166,19 +228,22 @@ class string_t final {
     }
   }
 
-  static void encode_utf8_1(std::string &out, unsigned p) {
+  template <typename string_type>
+  static void encode_utf8_1(string_type &out, unsigned p) {
     const char c0 = (p & 0x7F);
     out.push_back(c0);
   }
 
-  static void encode_utf8_2(std::string &out, unsigned p) {
+  template <typename string_type>
+  static void encode_utf8_2(string_type &out, unsigned p) {
     const char c0 = 0xC0 | ((p >> 6) & 0x1F);
     const char c1 = 0x80 | ((p >> 0) & 0x3F);
     const char cc[] = { c0, c1 };
     out.append(&cc[0], 2);
   }
 
-  static void encode_utf8_3(std::string &out, unsigned p) {
+  template <typename string_type>
+  static void encode_utf8_3(string_type &out, unsigned p) {
     const char c0 = 0xE0 | ((p >> 12) & 0x0F);
     const char c1 = 0x80 | ((p >>  6) & 0x3F);
     const char c2 = 0x80 | ((p >>  0) & 0x3F);
@@ -186,7 +251,8 @@ class string_t final {
     out.append(&cc[0], 3);
   }
 
-  static void encode_utf8_4(std::string &out, uint32_t p) {
+  template <typename string_type>
+  static void encode_utf8_4(string_type &out, uint32_t p) {
     const char c0 = 0xF0 | ((p >> 18) & 0x07);
     const char c1 = 0x80 | ((p >> 12) & 0x3F);
     const char c2 = 0x80 | ((p >>  6) & 0x3F);
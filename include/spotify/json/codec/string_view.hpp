@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <cstring>
+
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/decode_context.hpp>
+#include <spotify/json/default_codec.hpp>
+#include <spotify/json/detail/decode_helpers.hpp>
+#include <spotify/json/detail/leading_tokens.hpp>
+#include <spotify/json/detail/macros.hpp>
+#include <spotify/json/detail/skip_chars.hpp>
+#include <spotify/json/encode_context.hpp>
+#include <spotify/json/string_view.hpp>
+
+namespace spotify {
+namespace json {
+namespace codec {
+
+/**
+ * Decodes JSON strings into string_view objects that point directly into the
+ * input, without allocating or copying. Strings that contain escape sequences
+ * can only be decoded when the decode_context was constructed over mutable
+ * input (see json::decode_in_situ), in which case they are unescaped in place.
+ * Unescaping never makes a string longer, so the unescaped string always fits
+ * where the escaped one was.
+ */
+class string_view_t final {
+ public:
+  using object_type = json::string_view;
+
+  json_never_inline object_type decode(decode_context &context) const {
+    detail::skip_1(context, '"');
+    if (json_unlikely(context.has_failed())) {
+      return object_type();
+    }
+
+    const auto begin_simple = context.position;
+    detail::skip_any_simple_characters(context);
+
+    switch (detail::next(context, "Unterminated string")) {
+      case '"': return object_type(begin_simple, context.position - begin_simple - 1);
+      case '\\': return decode_escaped_string(context, begin_simple);
+      default: return object_type();  // The input ended, so decoding has failed
+    }
+  }
+
+  json_never_inline void encode(encode_context &context, const object_type &value) const {
+    string_t::encode_string(context, value.data(), value.size());
+  }
+
+  detail::token_set leading_tokens() const {
+    return detail::token_string;
+  }
+
+ private:
+  /**
+   * Writes unescaped characters over the input that has already been read.
+   * It has the subset of the std::string interface that string_t's escape
+   * helpers use.
+   */
+  struct in_situ_writer {
+    void push_back(const char c) {
+      *(end++) = c;
+    }
+
+    void append(const char *data, const size_t size) {
+      std::memmove(end, data, size);
+      end += size;
+    }
+
+    char *end;
+  };
+
+  json_never_inline static object_type decode_escaped_string(
+      decode_context &context,
+      const char *begin) {
+    if (detail::fail_if(
+        context,
+        !context.has_mutable_input,
+        "Escaped strings can only be decoded as views of mutable input",
+        -1)) {
+      return object_type();
+    }
+
+    in_situ_writer unescaped{ context.mutable_position() - 1 };
+    string_t::decode_escape(context, unescaped);
+
+    while (json_likely(context.remaining() && !context.has_failed())) {
+      const auto begin_simple = context.position;
+      detail::skip_any_simple_characters(context);
+      unescaped.append(begin_simple, context.position - begin_simple);
+
+      switch (detail::next(context, "Unterminated string")) {
+        case '"': return object_type(begin, unescaped.end - begin);
+        case '\\': string_t::decode_escape(context, unescaped); break;
+        default: return object_type();  // The input ended, so decoding has failed
+      }
+    }
+
+    detail::fail(context, "Unterminated string");
+    return object_type();
+  }
+};
+
+inline string_view_t string_view() {
+  return string_view_t();
+}
+
+}  // namespace codec
+
+template <>
+struct default_codec_t<string_view> {
+  static codec::string_view_t codec() {
+    return codec::string_view_t();
+  }
+};
+
+}  // namespace json
+}  // namespace spotify
@@ -0,0 +1,331 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <typeindex>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#include <spotify/json/codec/smart_ptr.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/decode_context.hpp>
+#include <spotify/json/detail/decode_helpers.hpp>
+#include <spotify/json/detail/encode_helpers.hpp>
+#include <spotify/json/detail/leading_tokens.hpp>
+#include <spotify/json/detail/macros.hpp>
+#include <spotify/json/detail/skip_chars.hpp>
+#include <spotify/json/detail/skip_value.hpp>
+#include <spotify/json/encode_context.hpp>
+#include <spotify/json/string_view.hpp>
+
+namespace spotify {
+namespace json {
+namespace codec {
+
+/**
+ * Codec for polymorphic objects, where a discriminator field in the JSON
+ * object (such as "type" in {"type":"track","name":"..."}) tells which class
+ * the object is an instance of. Each class is added together with the value
+ * of the discriminator and the codec to use for it.
+ *
+ * When decoding, the discriminator is found first. If it is the first field of
+ * the object, as it is in objects encoded by this codec, and the codec of the
+ * class has a decode_after_first_key method (object_t and static_object_t do),
+ * that codec continues at the value of the discriminator, so the object is
+ * decoded in a single pass. Otherwise the object is decoded in two passes: the
+ * fields before the discriminator are skipped over without being decoded, and
+ * then the whole object is decoded by the codec of the class, which should
+ * ignore the discriminator (object_t does this for unknown fields).
+ *
+ * When encoding, the codec is picked by the dynamic type of the object, and
+ * the discriminator is written as the first field of the object.
+ */
+template <typename T>
+class tagged_union_t final {
+ public:
+  using object_type = T;
+  using base_type = typename T::element_type;
+
+  explicit tagged_union_t(std::string discriminator)
+      : _discriminator(std::move(discriminator)) {}
+
+  /**
+   * Use codec, which must decode JSON objects into instances of a class that
+   * derives from the element type of T, for objects where the discriminator
+   * has the given value.
+   */
+  template <typename codec_type>
+  void add(const std::string &tag, codec_type codec) {
+    using derived_type = typename codec_type::object_type;
+    static_assert(
+        std::is_base_of<base_type, derived_type>::value,
+        "The codecs of a tagged_union_t must decode classes that derive from its element type");
+
+    encode_context context;
+    string_t().encode(context, _discriminator);
+    context.append(':');
+    string_t().encode(context, tag);
+
+    _alternatives.push_back(alternative{
+        tag,
+        std::string(context.data(), context.size()),
+        std::type_index(typeid(derived_type)),
+        std::make_shared<erased_codec_impl<codec_type>>(std::move(codec)) });
+  }
+
+  object_type decode(decode_context &context) const {
+    const auto begin = context.position;
+    bool is_first_field = false;
+    const auto alternative = find_alternative(context, is_first_field);
+    if (json_unlikely(context.has_failed())) {
+      return object_type();
+    }
+
+    if (json_likely(is_first_field)) {
+      return alternative->codec->decode_after_first_key(context, begin, _discriminator);
+    }
+
+    context.position = begin;
+    return alternative->codec->decode(context);
+  }
+
+  void encode(encode_context &context, const object_type &value) const {
+    detail::fail_if(context, !value, "Cannot encode null smart pointer");
+    const std::type_index type(typeid(*value));
+    for (const auto &alternative : _alternatives) {
+      if (alternative.type == type) {
+        return encode_with_tag(context, alternative, *value);
+      }
+    }
+    detail::fail(context, "Encoding object of a type that is not in the tagged union");
+  }
+
+  detail::token_set leading_tokens() const {
+    return detail::token_object;
+  }
+
+ private:
+  class erased_codec {
+   public:
+    virtual ~erased_codec() = default;
+
+    virtual object_type decode(decode_context &context) const = 0;
+
+    /**
+     * Decode an object of which the '{' and key have been consumed. The
+     * context is positioned at the value of key, and object_begin is the
+     * position of the '{'.
+     */
+    virtual object_type decode_after_first_key(
+        decode_context &context,
+        const char *object_begin,
+        const std::string &key) const = 0;
+
+    virtual void encode(encode_context &context, const base_type &value) const = 0;
+  };
+
+  template <typename codec_type>
+  class erased_codec_impl final : public erased_codec {
+   public:
+    using derived_type = typename codec_type::object_type;
+
+    explicit erased_codec_impl(codec_type codec)
+      : _codec(std::move(codec)) {}
+
+    object_type decode(decode_context &context) const override {
+      return make(context, _codec.decode(context));
+    }
+
+    object_type decode_after_first_key(
+        decode_context &context,
+        const char *object_begin,
+        const std::string &key) const override {
+      using has_method = std::integral_constant<
+          bool,
+          detail::has_decode_after_first_key_method<codec_type>::value>;
+      return make(context, decode_after_first_key(context, object_begin, key, has_method()));
+    }
+
+    void encode(encode_context &context, const base_type &value) const override {
+      // The dynamic type of value has been checked by the caller.
+      _codec.encode(context, static_cast<const derived_type &>(value));
+    }
+
+   private:
+    derived_type decode_after_first_key(
+        decode_context &context,
+        const char *,
+        const std::string &key,
+        std::true_type) const {
+      return _codec.decode_after_first_key(context, key.data(), key.size());
+    }
+
+    derived_type decode_after_first_key(
+        decode_context &context,
+        const char *object_begin,
+        const std::string &,
+        std::false_type) const {
+      context.position = object_begin;
+      return _codec.decode(context);
+    }
+
+    static object_type make(decode_context &context, derived_type &&value) {
+      if (json_unlikely(context.has_failed())) {
+        return object_type();
+      }
+      return make_smart_ptr_t<object_type>::make(std::move(value));
+    }
+
+    codec_type _codec;
+  };
+
+  struct alternative {
+    std::string tag;
+    std::string encoded_field;  // e.g. "\"type\":\"track\""
+    std::type_index type;
+    std::shared_ptr<const erased_codec> codec;
+  };
+
+  /**
+   * Skim the object for the discriminator and return the alternative that it
+   * refers to. Values of other fields are skipped, not decoded. When this
+   * returns, the context is positioned at the value of the discriminator, and
+   * is_first_field tells if the discriminator is the first field.
+   */
+  json_never_inline const alternative *find_alternative(
+      decode_context &context,
+      bool &is_first_field) const {
+    detail::skip_1(context, '{');
+    detail::skip_any_whitespace(context);
+    std::string storage;
+    is_first_field = true;
+
+    while (json_likely(!context.has_failed())) {
+      if (detail::fail_if(context, detail::peek(context) == '}', "Missing discriminator field")) {
+        return nullptr;
+      }
+
+      const auto key = decode_string(context, storage);
+      detail::skip_any_whitespace(context);
+      detail::skip_1(context, ':');
+      if (json_unlikely(context.has_failed())) {
+        return nullptr;
+      }
+      detail::skip_any_whitespace(context);
+
+      if (key == json::string_view(_discriminator)) {
+        const auto tag_position = context.position;
+        const auto tag = decode_string(context, storage);
+        if (json_unlikely(context.has_failed())) {
+          return nullptr;
+        }
+        for (const auto &alternative : _alternatives) {
+          if (tag == json::string_view(alternative.tag)) {
+            context.position = tag_position;
+            return &alternative;
+          }
+        }
+        detail::fail(context, "Unknown discriminator value", tag_position - context.position);
+        return nullptr;
+      }
+
+      is_first_field = false;
+      detail::skip_value(context);
+      detail::skip_any_whitespace(context);
+      if (json_unlikely(context.has_failed())) {
+        return nullptr;
+      }
+      if (detail::peek(context) != '}') {
+        detail::skip_1(context, ',');
+        detail::skip_any_whitespace(context);
+      }
+    }
+
+    return nullptr;
+  }
+
+  /**
+   * Strings without escape sequences are returned as views of the input. Only
+   * escaped strings are unescaped into storage.
+   */
+  json_force_inline static json::string_view decode_string(
+      decode_context &context,
+      std::string &storage) {
+    const auto begin = context.position;
+    detail::skip_1(context, '"');
+    if (json_unlikely(context.has_failed())) {
+      return json::string_view();
+    }
+
+    const auto begin_simple = context.position;
+    detail::skip_any_simple_characters(context);
+    if (json_likely(context.remaining() && *context.position == '"')) {
+      context.position++;
+      return json::string_view(begin_simple, context.position - begin_simple - 1);
+    }
+
+    context.position = begin;
+    storage = string_t().decode(context);
+    return json::string_view(storage);
+  }
+
+  /**
+   * Encode value with the codec of the alternative, and splice the
+   * discriminator in as the first field of the encoded object.
+   */
+  json_never_inline static void encode_with_tag(
+      encode_context &context,
+      const alternative &alternative,
+      const base_type &value) {
+    const auto begin = context.size();
+    alternative.codec->encode(context, value);
+    const auto encoded_size = context.size() - begin;
+    detail::fail_if(
+        context,
+        encoded_size < 2 || context.data()[begin] != '{',
+        "The codecs of a tagged_union_t must encode JSON objects");
+
+    const auto is_empty = (encoded_size == 2);
+    const auto &field = alternative.encoded_field;
+    const auto inserted_size = field.size() + (is_empty ? 0 : 1);
+    const auto end = context.reserve(inserted_size);
+    const auto object = end - encoded_size;
+    std::memmove(object + 1 + inserted_size, object + 1, encoded_size - 1);
+    std::memcpy(object + 1, field.data(), field.size());
+    if (!is_empty) {
+      object[1 + field.size()] = ',';
+    }
+    context.advance(inserted_size);
+  }
+
+  std::string _discriminator;
+  std::vector<alternative> _alternatives;
+};
+
+template <typename T>
+tagged_union_t<T> tagged_union(std::string discriminator) {
+  return tagged_union_t<T>(std::move(discriminator));
+}
+
+}  // namespace codec
+}  // namespace json
+}  // namespace spotify
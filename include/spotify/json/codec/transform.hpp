@@ -16,10 +16,15 @@
 
 #pragma once
 
+#include <string>
 #include <utility>
 
 #include <spotify/json/decode_context.hpp>
+#include <spotify/json/decode_exception.hpp>
 #include <spotify/json/default_codec.hpp>
+#include <spotify/json/detail/decode_helpers.hpp>
+#include <spotify/json/detail/leading_tokens.hpp>
+#include <spotify/json/detail/macros.hpp>
 #include <spotify/json/encode_context.hpp>
 
 namespace spotify {
@@ -106,9 +111,9 @@ namespace codec {
  * JSON as a string.
  *
  * The provided transform function for decoding can throw a decode_exception, if
- * the JSON value can't be parsed. The decode transform function is provided
- * with two parameters: The value to decode and the offset of decoding, to be
- * passed to decode_exception if something goes wrong.
+ * the JSON value can't be parsed. The offset of the exception is replaced with
+ * the offset of the transformed value. When the decode_context does not throw
+ * on failure, the exception is caught and recorded in the context instead.
  */
 template <
     typename codec_type,
@@ -129,17 +134,35 @@ class transform_t final {
   object_type decode(decode_context &context) const {
     const auto offset_before_decoding = context.offset();
     auto decoded_value = _inner_codec.decode(context);
+    if (json_unlikely(context.has_failed())) {
+      return detail::failed_value<object_type>(context);
+    }
+
+#if json_has_exceptions
     try {
       return _decode_transform(std::move(decoded_value));
     } catch (decode_exception &exception) {
-      throw decode_exception(std::move(exception), offset_before_decoding);
+      if (context.throw_on_failure) {
+        throw decode_exception(std::move(exception), offset_before_decoding);
+      }
+      const auto d = ptrdiff_t(offset_before_decoding) - ptrdiff_t(context.offset());
+      context.set_error(std::string(exception.what()), d);
+      return detail::failed_value<object_type>(context);
     }
+#else
+    (void)offset_before_decoding;
+    return _decode_transform(std::move(decoded_value));
+#endif
   }
 
   void encode(encode_context &context, const object_type &value) const {
     _inner_codec.encode(context, _encode_transform(value));
   }
 
+  detail::token_set leading_tokens() const {
+    return detail::leading_tokens(_inner_codec);
+  }
+
  private:
   codec_type _inner_codec;
   encode_transform _encode_transform;
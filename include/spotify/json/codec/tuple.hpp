@@ -19,6 +19,12 @@
 #include <tuple>
 #include <utility>
 
+#include <spotify/json/decode_context.hpp>
+#include <spotify/json/default_codec.hpp>
+#include <spotify/json/detail/decode_helpers.hpp>
+#include <spotify/json/detail/leading_tokens.hpp>
+#include <spotify/json/encode_context.hpp>
+
 namespace spotify {
 namespace json {
 namespace detail {
@@ -34,11 +40,17 @@ struct tuple_field final {
       T &object) {
     if (element_idx != 0) {
       skip_1(context, ',');
+      if (json_unlikely(context.has_failed())) {
+        return;
+      }
       skip_any_whitespace(context);
     }
 
     const auto &codec = std::get<element_idx>(codecs);
     std::get<element_idx>(object) = codec.decode(context);
+    if (json_unlikely(context.has_failed())) {
+      return;
+    }
     skip_any_whitespace(context);
     tuple_field<T, remaining_count - 1, codecs_type...>::decode(codecs, context, object);
   }
@@ -79,10 +91,15 @@ class tuple_t final {
   object_type decode(decode_context &context) const {
     object_type output;
     detail::skip_1(context, '[');
+    if (json_unlikely(context.has_failed())) {
+      return output;
+    }
     detail::skip_any_whitespace(context);
     detail::tuple_field<object_type, element_count, codecs_type...>::decode(
         _codecs, context, output);
-    detail::skip_1(context, ']');
+    if (json_likely(!context.has_failed())) {
+      detail::skip_1(context, ']');
+    }
     return output;
   }
 
@@ -93,6 +110,10 @@ class tuple_t final {
     context.append_or_replace(',', ']');
   }
 
+  detail::token_set leading_tokens() const {
+    return detail::token_array;
+  }
+
  private:
   std::tuple<codecs_type ...> _codecs;
 };
@@ -17,11 +17,18 @@
 #pragma once
 
 #include <cstring>
+#include <limits>
+#include <string>
+#include <utility>
 
 #include <spotify/json/decode_context.hpp>
+#include <spotify/json/decode_policy.hpp>
 #include <spotify/json/default_codec.hpp>
 #include <spotify/json/detail/decode_helpers.hpp>
 #include <spotify/json/detail/macros.hpp>
+#include <spotify/json/detail/nesting.hpp>
+#include <spotify/json/detail/skip_chars.hpp>
+#include <spotify/json/detail/utf8.hpp>
 
 namespace spotify {
 namespace json {
@@ -56,37 +63,252 @@ typename codec_type::object_type decode(const codec_type &codec, const string_ty
 
 template <typename value_type>
 value_type decode(const char *data, size_t size) {
-  return decode(default_codec<value_type>(), data, size);
+  return decode(cached_default_codec<value_type>(), data, size);
 }
 
 template <typename value_type>
 value_type decode(const char *cstr) {
-  return decode(default_codec<value_type>(), cstr);
+  return decode(cached_default_codec<value_type>(), cstr);
 }
 
 template <typename value_type, typename string_type>
 value_type decode(const string_type &string) {
-  return decode(default_codec<value_type>(), string);
+  return decode(cached_default_codec<value_type>(), string);
+}
+
+/*
+ * json::decode_padded(codec, data, size)
+ */
+
+/**
+ * Decode like decode(), for input that is followed by at least decode_padding
+ * bytes that may be read, such as input in a larger receive buffer or in a
+ * memory mapped file. The kernels then read whole vectors without checking
+ * how close they are to the end of the input. The padding is never decoded.
+ */
+template <typename codec_type>
+typename codec_type::object_type decode_padded(const codec_type &codec, const char *data, size_t size) {
+  decode_context c(data, data + size, decode_context::padded_input_t());
+  detail::skip_any_whitespace(c);
+  const auto result = codec.decode(c);
+  detail::skip_any_whitespace(c);
+  detail::fail_if(c, c.position != c.end, "Unexpected trailing input");
+  return result;
+}
+
+/*
+ * json::decode_padded(data, size)
+ */
+
+template <typename value_type>
+value_type decode_padded(const char *data, size_t size) {
+  return decode_padded(cached_default_codec<value_type>(), data, size);
+}
+
+/*
+ * json::decode_with_policy<policy>(codec, data...)
+ */
+
+/**
+ * Decode like decode(), with the trade-offs of a decode policy (see
+ * default_decode_policy). The policy is a template parameter, so the checks
+ * that it turns off are not compiled into this function. Trusted input is
+ * flagged for skip_value. UTF-8 and the nesting depth are checked over the
+ * whole input before it is decoded, so the codecs do not count nesting levels;
+ * each check is one more pass over the input with the kernels in use.
+ */
+template <typename policy_type, typename codec_type>
+typename codec_type::object_type decode_with_policy(const codec_type &codec, const char *data, size_t size) {
+  decode_context c(data, data + size);
+  c.trusted_input = policy_type::trusted;
+  if (policy_type::validate_utf8) {
+    const auto invalid = detail::find_invalid_utf8(c.begin, c.end);
+    detail::fail_if(c, invalid != c.end, "Invalid UTF-8", invalid - c.position);
+  }
+  if (policy_type::max_depth != std::numeric_limits<size_t>::max()) {
+    const auto too_deep = detail::find_too_deep_nesting(c.begin, c.end, policy_type::max_depth);
+    detail::fail_if(c, too_deep != c.end, "Too deeply nested", too_deep - c.position);
+  }
+
+  detail::skip_any_whitespace(c);
+  const auto result = codec.decode(c);
+  if (!policy_type::allow_trailing_input) {
+    detail::skip_any_whitespace(c);
+    detail::fail_if(c, c.position != c.end, "Unexpected trailing input");
+  }
+  return result;
+}
+
+template <typename policy_type, typename codec_type>
+typename codec_type::object_type decode_with_policy(const codec_type &codec, const char *cstr) {
+  return decode_with_policy<policy_type>(codec, cstr, cstr ? std::strlen(cstr) : 0);
+}
+
+template <typename policy_type, typename codec_type, typename string_type>
+typename codec_type::object_type decode_with_policy(const codec_type &codec, const string_type &string) {
+  return decode_with_policy<policy_type>(codec, string.data(), string.size());
+}
+
+/*
+ * json::decode_with_policy<policy, value_type>(data...)
+ */
+
+template <typename policy_type, typename value_type>
+value_type decode_with_policy(const char *data, size_t size) {
+  return decode_with_policy<policy_type>(cached_default_codec<value_type>(), data, size);
+}
+
+template <typename policy_type, typename value_type>
+value_type decode_with_policy(const char *cstr) {
+  return decode_with_policy<policy_type>(cached_default_codec<value_type>(), cstr);
+}
+
+template <typename policy_type, typename value_type, typename string_type>
+value_type decode_with_policy(const string_type &string) {
+  return decode_with_policy<policy_type>(cached_default_codec<value_type>(), string);
+}
+
+/*
+ * json::decode_into(codec, data..., &object)
+ */
+
+/**
+ * Decode into an existing object, reusing the memory that it already owns
+ * where the codecs support it (see detail::decode_into). This is useful when
+ * decoding many similar values in a loop. When decoding fails, the object is
+ * left in a valid but unspecified state.
+ */
+template <typename codec_type>
+void decode_into(
+    const codec_type &codec,
+    const char *data,
+    size_t size,
+    typename codec_type::object_type &object) {
+  decode_context c(data, data + size);
+  detail::skip_any_whitespace(c);
+  detail::decode_into(codec, c, object);
+  detail::skip_any_whitespace(c);
+  detail::fail_if(c, c.position != c.end, "Unexpected trailing input");
+}
+
+template <typename codec_type>
+void decode_into(
+    const codec_type &codec,
+    const char *cstr,
+    typename codec_type::object_type &object) {
+  decode_into(codec, cstr, cstr ? std::strlen(cstr) : 0, object);
+}
+
+template <typename codec_type, typename string_type>
+void decode_into(
+    const codec_type &codec,
+    const string_type &string,
+    typename codec_type::object_type &object) {
+  decode_into(codec, string.data(), string.size(), object);
+}
+
+/*
+ * json::decode_into(data..., &object)
+ */
+
+template <typename value_type>
+void decode_into(const char *data, size_t size, value_type &object) {
+  decode_into(cached_default_codec<value_type>(), data, size, object);
+}
+
+template <typename value_type>
+void decode_into(const char *cstr, value_type &object) {
+  decode_into(cached_default_codec<value_type>(), cstr, object);
+}
+
+template <typename value_type, typename string_type>
+void decode_into(const string_type &string, value_type &object) {
+  decode_into(cached_default_codec<value_type>(), string, object);
+}
+
+/*
+ * json::decode_in_situ(codec, data...)
+ */
+
+/**
+ * Decode mutable input. Codecs are allowed to modify the input while decoding,
+ * which codec::string_view_t uses to unescape strings in place. The decoded
+ * object may refer to the input, which must then outlive it.
+ */
+template <typename codec_type>
+typename codec_type::object_type decode_in_situ(const codec_type &codec, char *data, size_t size) {
+  decode_context c(data, data + size, decode_context::mutable_input_t());
+  detail::skip_any_whitespace(c);
+  const auto result = codec.decode(c);
+  detail::skip_any_whitespace(c);
+  detail::fail_if(c, c.position != c.end, "Unexpected trailing input");
+  return result;
+}
+
+template <typename codec_type>
+typename codec_type::object_type decode_in_situ(const codec_type &codec, std::string &string) {
+  return decode_in_situ(codec, &string[0], string.size());
+}
+
+/*
+ * json::decode_in_situ(data...)
+ */
+
+template <typename value_type>
+value_type decode_in_situ(char *data, size_t size) {
+  return decode_in_situ(cached_default_codec<value_type>(), data, size);
+}
+
+template <typename value_type>
+value_type decode_in_situ(std::string &string) {
+  return decode_in_situ(cached_default_codec<value_type>(), string);
 }
 
 /*
  * json::try_decode(&object, codec, data...)
  */
 
+/**
+ * Decode the JSON between context.position and context.end without throwing.
+ * The context records the failure instead, so the error message and its offset
+ * are available from it if decoding fails. context.throw_on_failure is left as
+ * it was. Failures are not exceptions, so
+ * this is cheap even when much of the input is invalid.
+ */
 template <typename codec_type>
 bool try_decode(
     typename codec_type::object_type &object,
     const codec_type &codec,
-    const char *data,
-    size_t size) noexcept {
-  try {
-    object = decode(codec, data, size);
+    decode_context &context) noexcept {
+  detail::no_throw_scope no_throw(context);
+  json_try {
+    detail::skip_any_whitespace(context);
+    auto result = codec.decode(context);
+    if (json_unlikely(context.has_failed())) {
+      return false;
+    }
+    detail::skip_any_whitespace(context);
+    if (detail::fail_if(context, context.position != context.end, "Unexpected trailing input")) {
+      return false;
+    }
+    object = std::move(result);
     return true;
-  } catch (...) {
+  } json_catch(...) {
+    // Custom codecs may throw, and memory allocation may fail.
     return false;
   }
 }
 
+template <typename codec_type>
+bool try_decode(
+    typename codec_type::object_type &object,
+    const codec_type &codec,
+    const char *data,
+    size_t size) noexcept {
+  decode_context c(data, data + size);
+  return try_decode(object, codec, c);
+}
+
 template <typename codec_type>
 bool try_decode(
     typename codec_type::object_type &object,
@@ -109,17 +331,17 @@ bool try_decode(
 
 template <typename value_type>
 bool try_decode(value_type &object, const char *data, size_t size) noexcept {
-  return try_decode(object, default_codec<value_type>(), data, size);
+  return try_decode(object, cached_default_codec<value_type>(), data, size);
 }
 
 template <typename value_type>
 bool try_decode(value_type &object, const char *cstr) noexcept {
-  return try_decode(object, default_codec<value_type>(), cstr);
+  return try_decode(object, cached_default_codec<value_type>(), cstr);
 }
 
 template <typename value_type, typename string_type>
 bool try_decode(value_type &object, const string_type &string) noexcept {
-  return try_decode(object, default_codec<value_type>(), string);
+  return try_decode(object, cached_default_codec<value_type>(), string);
 }
 
 }  // namespace json
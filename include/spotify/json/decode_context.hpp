@@ -16,33 +16,114 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstddef>
+#include <string>
 
 #include <spotify/json/decode_exception.hpp>
-#include <spotify/json/detail/cpuid.hpp>
 #include <spotify/json/detail/macros.hpp>
+#include <spotify/json/instruction_set.hpp>
 
 namespace spotify {
 namespace json {
 
+/**
+ * The number of bytes after the end of the input that must be readable when
+ * decoding padded input (see decode_context::padded_input_t). Their values do
+ * not matter.
+ */
+constexpr size_t decode_padding = 64;
+
+struct decode_context;
+
+namespace detail {
+
+using skip_function = void (*)(decode_context &context);
+
+void skip_any_whitespace_scalar(decode_context &context);
+
+/**
+ * The whitespace kernel in use (see detail::kernels), or nullptr before the
+ * kernels have been picked. The table of kernels is not visible here, so the
+ * kernel is kept apart from it for decode_context to read with one load.
+ */
+extern std::atomic<skip_function> active_whitespace_skipper;
+
+/**
+ * Pick the kernels, if that has not been done yet, and return the whitespace
+ * kernel in use.
+ */
+skip_function resolve_whitespace_skipper();
+
+json_force_inline skip_function default_whitespace_skipper() {
+  const auto skipper = active_whitespace_skipper.load(std::memory_order_relaxed);
+  return json_likely(skipper != nullptr) ? skipper : resolve_whitespace_skipper();
+}
+
+}  // namespace detail
+
 /**
  * A decode_context has the information that is kept while decoding JSON with
  * codecs. It has information about the data to read and whether the decoding
  * has failed.
  */
+json_begin_deprecated_definitions  // for has_sse42
 struct decode_context final {
+  /**
+   * Tag type for constructing a decode_context over input that the codecs are
+   * allowed to modify. Codecs such as codec::string_view_t use this to unescape
+   * strings in place instead of copying them.
+   */
+  struct mutable_input_t {};
+
+  /**
+   * Tag type for constructing a decode_context over input that is followed by
+   * at least decode_padding readable bytes, for example in a larger receive
+   * buffer. The kernels then read whole vectors up to and past the end of the
+   * input instead of reading the last few bytes one by one.
+   */
+  struct padded_input_t {};
+
   decode_context(const char *begin, const char *end)
-      : has_sse42(detail::cpuid().has_sse42()),
+      : has_mutable_input(false),
+        has_padded_input(false),
+        throw_on_failure(true),
         position(begin),
         begin(begin),
         end(end) {}
 
   decode_context(const char *data, size_t size)
-      : has_sse42(detail::cpuid().has_sse42()),
+      : has_mutable_input(false),
+        has_padded_input(false),
+        throw_on_failure(true),
         position(data),
         begin(data),
         end(data + size) {}
 
+  decode_context(char *begin, char *end, mutable_input_t)
+      : has_mutable_input(true),
+        has_padded_input(false),
+        throw_on_failure(true),
+        position(begin),
+        begin(begin),
+        end(end) {}
+
+  decode_context(const char *begin, const char *end, padded_input_t)
+      : has_mutable_input(false),
+        has_padded_input(true),
+        throw_on_failure(true),
+        position(begin),
+        begin(begin),
+        end(end) {}
+
+  /**
+   * Pointer to the byte at the given position, which may only be written to
+   * when the context was constructed with mutable_input_t.
+   */
+  json_force_inline char *mutable_position() const {
+    return const_cast<char *>(position);
+  }
+
   json_force_inline size_t offset() const {
     return (position - begin);
   }
@@ -55,11 +136,100 @@ struct decode_context final {
     return (end - position);
   }
 
-  const bool has_sse42;
+  /**
+   * True if decoding has failed. This can only happen when throw_on_failure is
+   * false; otherwise a decode_exception is thrown instead.
+   */
+  json_force_inline bool has_failed() const {
+    return _has_failed;
+  }
+
+  /**
+   * The message and offset of the first error that was recorded in this
+   * context. Only meaningful if has_failed() is true.
+   */
+  const char *error() const {
+    return _error ? _error : _error_storage.c_str();
+  }
+
+  size_t error_offset() const {
+    return _error_offset;
+  }
+
+  /**
+   * Record that decoding failed at position + d. Only the first error is kept.
+   * This is normally called through detail::fail.
+   */
+  void set_error(const char *error, const ptrdiff_t d = 0) {
+    if (json_likely(!has_failed())) {
+      _has_failed = true;
+      _error = error;
+      _error_offset = offset(d);
+    }
+  }
+
+  void set_error(const std::string &error, const ptrdiff_t d = 0) {
+    if (json_likely(!has_failed())) {
+      _has_failed = true;
+      _error = nullptr;
+      _error_storage = error;
+      _error_offset = offset(d);
+    }
+  }
+
+  void clear_error() {
+    _has_failed = false;
+  }
+
+  /**
+   * Whether the codecs may modify the input. This is set when the context was
+   * constructed with mutable_input_t, and cleared again (see
+   * detail::immutable_input_scope) while a codec tries to decode a value that
+   * it may have to decode again from the same position. It must never be set
+   * for input that is not actually mutable.
+   */
+  bool has_mutable_input;
+  const bool has_padded_input;
+
+  /**
+   * Whether the kernels in use (see instruction_set.hpp) use SSE 4.2. The
+   * kernels are picked once per process, so codecs no longer need this. Only
+   * the scalar kernels have the scalar whitespace kernel, so comparing with it
+   * tells without calling into the library.
+   */
+  json_deprecated("Use spotify::json::active_instruction_set() instead")
+  const bool has_sse42 = (detail::default_whitespace_skipper() != &detail::skip_any_whitespace_scalar);
+
+  /**
+   * Whether a failure throws a decode_exception (the default) or is only
+   * recorded in the context, in which case the codecs return early and leave
+   * it to the caller to check has_failed(). Recording errors is much cheaper
+   * than unwinding the stack, which matters when failures are common, and it
+   * is the only mode that works when exceptions are disabled.
+   */
+  bool throw_on_failure;
+
+  /**
+   * Whether the input is known to be valid JSON, for example because it was
+   * written by a trusted service. Objects and arrays that the codecs skip
+   * without decoding them (such as unknown fields of an object_t and values of
+   * an ignore_t) are then skipped by finding the matching closing bracket,
+   * which is much faster than validating their contents. Invalid JSON inside
+   * them goes unnoticed, so this must not be set for untrusted input.
+   */
+  bool trusted_input = false;
+
   const char *position;
   const char *const begin;
   const char *const end;
+
+ private:
+  bool _has_failed = false;
+  const char *_error = nullptr;
+  size_t _error_offset = 0;
+  std::string _error_storage;
 };
+json_end_deprecated_definitions
 
 }  // namespace json
 }  // namespace spotify
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <spotify/json/decode.hpp>
+#include <spotify/json/decode_context.hpp>
+#include <spotify/json/thread_pool.hpp>
+
+namespace spotify {
+namespace json {
+
+/**
+ * The outcome of decoding one of the inputs of decode_many.
+ */
+template <typename value_type>
+struct decode_result final {
+  value_type value = value_type();
+  bool has_failed = false;
+  std::string error;
+  size_t error_offset = 0;
+};
+
+/**
+ * Decode each of count independent inputs, such as the messages of a batch,
+ * with one shared codec, spread over the threads of pool. Results are in the
+ * same order as the inputs. A failure to decode one input is recorded in its
+ * result and does not affect the others.
+ *
+ * The codec is only used through a const reference and is never copied, so
+ * the threads do not touch the reference counts of the shared_ptrs inside
+ * codecs like object_t and any_codec_t. Decoding with a const codec does not
+ * write to it, which is what makes sharing it between threads safe.
+ */
+template <typename codec_type, typename string_type>
+std::vector<decode_result<typename codec_type::object_type>> decode_many(
+    const codec_type &codec,
+    const string_type *inputs,
+    const size_t count,
+    thread_pool &pool) {
+  std::vector<decode_result<typename codec_type::object_type>> results(count);
+  pool.parallel_for(count, [&](const size_t begin, const size_t end) {
+    for (auto i = begin; i < end; i++) {
+      auto &result = results[i];
+      decode_context context(inputs[i].data(), inputs[i].data() + inputs[i].size());
+      if (!try_decode(result.value, codec, context)) {
+        result.has_failed = true;
+        result.error = (context.has_failed() ? context.error() : "Decoding failed");
+        result.error_offset = context.error_offset();
+      }
+    }
+  });
+  return results;
+}
+
+template <typename codec_type, typename string_type>
+std::vector<decode_result<typename codec_type::object_type>> decode_many(
+    const codec_type &codec,
+    const std::vector<string_type> &inputs,
+    thread_pool &pool) {
+  return decode_many(codec, inputs.data(), inputs.size(), pool);
+}
+
+template <typename value_type, typename string_type>
+std::vector<decode_result<value_type>> decode_many(
+    const std::vector<string_type> &inputs,
+    thread_pool &pool) {
+  return decode_many(cached_default_codec<value_type>(), inputs, pool);
+}
+
+}  // namespace json
+}  // namespace spotify
@@ -0,0 +1,245 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <spotify/json/decode.hpp>
+#include <spotify/json/decode_context.hpp>
+#include <spotify/json/default_codec.hpp>
+#include <spotify/json/detail/container_elements.hpp>
+#include <spotify/json/detail/decode_helpers.hpp>
+#include <spotify/json/detail/macros.hpp>
+#include <spotify/json/detail/split_elements.hpp>
+#include <spotify/json/thread_pool.hpp>
+
+namespace spotify {
+namespace json {
+
+/**
+ * The default number of bytes that decode_parallel hands to each task when it
+ * looks for the boundaries between elements. Inputs that are shorter than two
+ * chunks are decoded on the calling thread.
+ */
+constexpr size_t decode_parallel_chunk_size = 256 * 1024;
+
+namespace detail {
+
+/**
+ * Room for a fixed number of elements, which are constructed one at a time,
+ * possibly on different threads, so that they do not need to be default
+ * constructible. The elements that have been constructed are destroyed with
+ * the storage. Unlike a std::vector<bool>, the flags are separate bytes, so
+ * different threads can construct different elements.
+ */
+template <typename T>
+class element_storage final {
+ public:
+  explicit element_storage(const size_t count)
+      : _slots(new slot[count]),
+        _is_constructed(new bool[count]()),
+        _count(count) {}
+
+  ~element_storage() {
+    for (size_t i = 0; i < _count; i++) {
+      if (_is_constructed[i]) {
+        (*this)[i].~T();
+      }
+    }
+  }
+
+  element_storage(const element_storage &) = delete;
+  element_storage &operator=(const element_storage &) = delete;
+
+  void construct(const size_t i, T &&value) {
+    new (&_slots[i]) T(std::move(value));
+    _is_constructed[i] = true;
+  }
+
+  T &operator[](const size_t i) {
+    return *reinterpret_cast<T *>(&_slots[i]);
+  }
+
+ private:
+  using slot = typename std::aligned_storage<sizeof(T), alignof(T)>::type;
+
+  std::unique_ptr<slot[]> _slots;
+  std::unique_ptr<bool[]> _is_constructed;
+  const size_t _count;
+};
+
+/**
+ * Decode the element between context.position and context.end, which must be
+ * all of it, like try_decode does for whole values, and construct element i of
+ * elements from it.
+ */
+template <typename codec_type>
+bool try_decode_element(
+    const codec_type &codec,
+    decode_context &context,
+    element_storage<typename container_elements<codec_type>::element_type> &elements,
+    const size_t i) noexcept {
+  context.throw_on_failure = false;
+  json_try {
+    skip_any_whitespace(context);
+    auto result = container_elements<codec_type>::decode(codec, context);
+    if (json_unlikely(context.has_failed())) {
+      return false;
+    }
+    skip_any_whitespace(context);
+    if (fail_if(context, context.position != context.end, "Unexpected trailing input")) {
+      return false;
+    }
+    elements.construct(i, std::move(result));
+    return true;
+  } json_catch(...) {
+    return false;
+  }
+}
+
+}  // namespace detail
+
+/*
+ * json::decode_parallel(codec, data...)
+ */
+
+/**
+ * Decode a document that is one large array or object, such as a big export
+ * file, on the threads of pool. The boundaries between the elements are found
+ * in parallel (see detail::split_elements), after which the elements are
+ * decoded in parallel with the inner codec and merged into the container in
+ * order on the calling thread. The codec must be an array_t or a map_t, for
+ * example the default codec of a std::vector or a std::map.
+ *
+ * The result is the same as that of decode(). When the input is invalid, it is
+ * decoded again with decode() to throw the same decode_exception. Inputs that
+ * are shorter than two chunks, and pools of a single thread, are decoded with
+ * decode() right away.
+ */
+template <typename codec_type>
+typename codec_type::object_type decode_parallel(
+    const codec_type &codec,
+    const char *data,
+    size_t size,
+    thread_pool &pool,
+    size_t chunk_size = decode_parallel_chunk_size) {
+  using elements = detail::container_elements<codec_type>;
+  static_assert(elements::is_supported, "decode_parallel needs an array_t or a map_t codec");
+  using element_type = typename elements::element_type;
+
+  chunk_size = (chunk_size + 63) & ~size_t(63);  // Whole blocks for the kernels
+  decode_context c(data, data + size);
+  detail::skip_any_whitespace(c);
+  if (pool.size() == 1 ||
+      c.remaining() < 2 * chunk_size ||
+      detail::peek(c) != elements::opening) {
+    return decode(codec, data, size);
+  }
+
+  const auto contents = c.position + 1;
+  std::vector<const char *> separators;
+  if (!detail::split_elements(contents, c.end, chunk_size, pool, separators)) {
+    return decode(codec, data, size);
+  }
+
+  const auto closing = separators.back();
+  c.position = closing + 1;
+  detail::skip_any_whitespace(c);
+  if (c.position != c.end) {
+    return decode(codec, data, size);
+  }
+
+  // The one bracket of an empty container follows only whitespace.
+  c.position = contents;
+  detail::skip_any_whitespace(c);
+  if (c.position == closing) {
+    separators.clear();
+  }
+
+  const auto count = separators.size();
+  detail::element_storage<element_type> decoded(count);
+  std::atomic<bool> failed(false);
+  pool.parallel_for(count, [&](const size_t begin, const size_t end) {
+    for (auto i = begin; i < end && !failed.load(std::memory_order_relaxed); i++) {
+      const auto element_begin = (i == 0 ? contents : separators[i - 1] + 1);
+      decode_context context(element_begin, separators[i]);
+      if (!detail::try_decode_element(codec, context, decoded, i)) {
+        failed.store(true, std::memory_order_relaxed);
+      }
+    }
+  });
+
+  if (failed.load()) {
+    return decode(codec, data, size);
+  }
+
+  typename codec_type::object_type output;
+  typename elements::state state = elements::init_state;
+  c.throw_on_failure = false;
+  for (size_t i = 0; i < count && !c.has_failed(); i++) {
+    state = elements::insert(c, state, output, std::move(decoded[i]));
+  }
+  if (!c.has_failed()) {
+    elements::validate(c, state, output);
+  }
+  if (c.has_failed()) {
+    return decode(codec, data, size);
+  }
+  return output;
+}
+
+template <typename codec_type>
+typename codec_type::object_type decode_parallel(
+    const codec_type &codec,
+    const char *cstr,
+    thread_pool &pool) {
+  return decode_parallel(codec, cstr, cstr ? std::strlen(cstr) : 0, pool);
+}
+
+template <typename codec_type, typename string_type>
+typename codec_type::object_type decode_parallel(
+    const codec_type &codec,
+    const string_type &string,
+    thread_pool &pool,
+    size_t chunk_size = decode_parallel_chunk_size) {
+  return decode_parallel(codec, string.data(), string.size(), pool, chunk_size);
+}
+
+/*
+ * json::decode_parallel(data...)
+ */
+
+template <typename value_type>
+value_type decode_parallel(const char *data, size_t size, thread_pool &pool) {
+  return decode_parallel(cached_default_codec<value_type>(), data, size, pool);
+}
+
+template <typename value_type, typename string_type>
+value_type decode_parallel(const string_type &string, thread_pool &pool) {
+  return decode_parallel(cached_default_codec<value_type>(), string, pool);
+}
+
+}  // namespace json
+}  // namespace spotify
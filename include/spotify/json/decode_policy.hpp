@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+
+#pragma once
+
+#include <cstddef>
+#include <limits>
+
+namespace spotify {
+namespace json {
+
+/**
+ * A decode policy tells json::decode_with_policy what the input is known to be
+ * like, so that only the work that such input needs is done. Policies derive
+ * from default_decode_policy and hide the members that they change:
+ *
+ *   struct internal_traffic : json::default_decode_policy {
+ *     static constexpr bool trusted = true;
+ *   };
+ *
+ *   json::decode_with_policy<internal_traffic>(codec, json);
+ *
+ * The default policy decodes exactly like json::decode.
+ */
+struct default_decode_policy {
+  /**
+   * The input is valid JSON, so values that are skipped need not be
+   * validated. See decode_context::trusted_input.
+   */
+  static constexpr bool trusted = false;
+
+  /**
+   * Fail if the input is not valid UTF-8. The whole input is checked before
+   * it is decoded, including the parts that are skipped.
+   */
+  static constexpr bool validate_utf8 = false;
+
+  /**
+   * Ignore what comes after the decoded value, instead of failing unless it
+   * is whitespace.
+   */
+  static constexpr bool allow_trailing_input = false;
+
+  /**
+   * Fail if objects and arrays are nested more deeply than this. The depth is
+   * checked over the whole value before it is decoded.
+   */
+  static constexpr size_t max_depth = std::numeric_limits<size_t>::max();
+};
+
+}  // namespace json
+}  // namespace spotify
@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include <spotify/json/instruction_set.hpp>
+
 namespace spotify {
 namespace json {
 
@@ -33,5 +35,33 @@ decltype(default_codec_t<T>::codec()) default_codec() {
   return default_codec_t<T>::codec();
 }
 
+/**
+ * The default codec for T, created the first time that it is needed and then
+ * shared by all threads for the rest of the lifetime of the process. Building
+ * a codec can be expensive (object_t codecs allocate memory for each field),
+ * so the decode and encode functions that do not take a codec use this rather
+ * than default_codec<T>().
+ *
+ * Initialization is thread safe. Once the codec has been created, getting it
+ * is a single load and compare and never takes a lock.
+ */
+template <typename T>
+const decltype(default_codec<T>()) &cached_default_codec() {
+  static const decltype(default_codec<T>()) codec = default_codec<T>();
+  return codec;
+}
+
+/**
+ * Create the cached default codecs for the given types and detect the
+ * features of the CPU ahead of time, so that this is not done when the first
+ * value of each type is decoded or encoded. Call this during startup.
+ */
+template <typename... types>
+void warm_up() {
+  active_instruction_set();
+  const int codecs[] = { 0, (cached_default_codec<types>(), 0)... };
+  (void)codecs;
+}
+
 }  // namespace json
 }  // namespace spotify
@@ -52,6 +52,12 @@ struct bitset {
     }
   }
 
+  json_force_inline bool test(const std::size_t index) const {
+    const auto byte = (index / 8);
+    const auto mask = (1 << (index & 7));
+    return ((_vector ? (*_vector)[byte] : _array[byte]) & mask) != 0;
+  }
+
  private:
   static constexpr auto _num_inline_bytes = ((inline_size + 7) / 8);
   std::unique_ptr<std::vector<uint8_t>> _vector;
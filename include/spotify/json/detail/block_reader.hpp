@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <spotify/json/string_view.hpp>
+
+namespace spotify {
+namespace json {
+namespace detail {
+
+/**
+ * Reads a file a block at a time on a thread of its own, so that the blocks
+ * are read ahead of the caller. There is a fixed number of blocks of a fixed
+ * size, and a block is only refilled once the caller has moved on to the one
+ * after it, so memory use does not depend on the size of the file.
+ *
+ * The file descriptor may be a pipe or a socket too. Blocks of those are handed
+ * over as soon as a read returns data, instead of when they are full, so that
+ * the caller gets data from a slow writer as it arrives. The thread waits for
+ * the file descriptor to become readable with poll(), together with a pipe of
+ * its own that the destructor writes to, so destroying the reader does not
+ * hang on a stream that sends nothing. On Windows, where reads cannot be woken up like this,
+ * the file descriptor must be a regular file.
+ */
+class block_reader final {
+ public:
+  /**
+   * Read from the file descriptor fd, which is closed by the destructor if
+   * owns_fd is true.
+   */
+  block_reader(int fd, bool owns_fd, size_t block_size, size_t block_count);
+
+  /**
+   * Open the file at path and read from it.
+   *
+   * @throws std::system_error if the file cannot be opened.
+   */
+  block_reader(const std::string &path, size_t block_size, size_t block_count);
+
+  ~block_reader();
+
+  block_reader(const block_reader &) = delete;
+  block_reader &operator=(const block_reader &) = delete;
+
+  /**
+   * Wait for the next block of the file, and hand the previous one back to
+   * be refilled. At the end of the file, the block is empty.
+   *
+   * @throws std::system_error if reading from the file fails.
+   */
+  json::string_view next();
+
+ private:
+  struct block {
+    std::unique_ptr<char[]> data;
+    size_t size;
+  };
+
+  void start();
+  void read_ahead();
+  void close_fds();
+
+  const int _fd;
+  const bool _owns_fd;
+  const size_t _block_size;
+  std::vector<block> _blocks;
+
+  std::mutex _mutex;
+  std::condition_variable _filled_changed;
+  std::condition_variable _free_changed;
+  std::deque<block *> _filled;
+  std::deque<block *> _free;
+  block *_current = nullptr;
+  int _error = 0;
+  bool _is_stopping = false;
+  bool _is_regular_file = true;  // Blocks of other files are handed over when partly full
+  int _wake_fds[2] = { -1, -1 };  // The pipe that wakes the thread from poll()
+  std::thread _thread;
+};
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
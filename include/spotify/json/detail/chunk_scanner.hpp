@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include <spotify/json/detail/structural_index.hpp>
+
+namespace spotify {
+namespace json {
+namespace detail {
+
+/**
+ * Finds where a JSON value ends in input that arrives in chunks. The scan of
+ * each chunk continues from the state that the previous one ended in, so every
+ * byte is looked at once however the input is split. Objects and arrays are
+ * scanned with the skip_container kernel, which means that the value is not
+ * validated here; that is left to the codec that decodes it.
+ */
+class chunk_scanner final {
+ public:
+  /**
+   * Scan the next chunk of input. The first chunk must start with the first
+   * character of the value. Returns the position after the last character of
+   * the value if it ends in this chunk, or nullptr if more input is needed.
+   *
+   * Numbers, true, false and null end at the first whitespace or structural
+   * character after them, so when they are the whole value and the input ends
+   * right after them, this returns nullptr.
+   */
+  const char *scan(const char *begin, const char *end);
+
+ private:
+  enum class kind : uint8_t { unknown, container, string, scalar };
+
+  kind _kind = kind::unknown;
+  container_state _state;
+};
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <string>
+#include <utility>
+
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/codec/map.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/decode_context.hpp>
+#include <spotify/json/detail/decode_helpers.hpp>
+#include <spotify/json/detail/macros.hpp>
+
+namespace spotify {
+namespace json {
+namespace detail {
+
+/**
+ * How the elements of an array or object are decoded one at a time with the
+ * codec of the container, and inserted into it. This is what lets a container
+ * be decoded in pieces, like decode_parallel and chunked_decoder do. There are
+ * specializations for array_t and map_t; for all other codecs, is_supported is
+ * false.
+ *
+ * decode() decodes the element at context.position, which must not be
+ * whitespace, and leaves the position right after it. For objects, an element
+ * is a key, a ':' and a value. insert() and validate() fail like decoding the
+ * container does, with the context positioned after the element and after
+ * the closing bracket, respectively.
+ */
+template <typename codec_type>
+struct container_elements {
+  using state = int;
+  static constexpr bool is_supported = false;
+  static constexpr state init_state = 0;
+};
+
+template <typename T, typename inner_codec_type>
+struct container_elements<codec::array_t<T, inner_codec_type>> {
+  using element_type = typename inner_codec_type::object_type;
+  using inserter = container_inserter<T>;
+  using state = typename inserter::state;
+  static constexpr bool is_supported = true;
+  static constexpr bool has_keys = false;
+  static constexpr char opening = '[';
+  static constexpr char closing = ']';
+  static constexpr state init_state = inserter::init_state;
+
+  static element_type decode(
+      const codec::array_t<T, inner_codec_type> &codec,
+      decode_context &context) {
+    return codec.inner_codec().decode(context);
+  }
+
+  static state insert(decode_context &context, const state s, T &output, element_type &&element) {
+    return inserter::insert(context, s, output, std::move(element));
+  }
+
+  static void validate(decode_context &context, const state s, T &output) {
+    inserter::validate(context, s, output);
+  }
+};
+
+template <typename T, typename inner_codec_type>
+struct container_elements<codec::map_t<T, inner_codec_type>> {
+  using element_type = std::pair<std::string, typename inner_codec_type::object_type>;
+  using state = int;
+  static constexpr bool is_supported = true;
+  static constexpr bool has_keys = true;
+  static constexpr char opening = '{';
+  static constexpr char closing = '}';
+  static constexpr state init_state = 0;
+
+  static element_type decode(
+      const codec::map_t<T, inner_codec_type> &codec,
+      decode_context &context) {
+    auto key = codec::string_t().decode(context);
+    if (json_likely(!context.has_failed())) {
+      skip_any_whitespace(context);
+      skip_1(context, ':');
+    }
+    if (json_unlikely(context.has_failed())) {
+      return failed_value<element_type>(context);
+    }
+    skip_any_whitespace(context);
+    auto value = codec.inner_codec().decode(context);
+    return element_type(std::move(key), std::move(value));
+  }
+
+  static state insert(decode_context &, const state s, T &output, element_type &&element) {
+    output.insert(typename T::value_type(std::move(element.first), std::move(element.second)));
+    return s;
+  }
+
+  static void validate(decode_context &, state, T &) {
+    // Nothing to validate
+  }
+};
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
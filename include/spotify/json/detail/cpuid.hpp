@@ -33,27 +33,51 @@ class cpuid {
  public:
   cpuid() {
 #if defined(json_arch_x86)
-    const uint32_t cpuid_function(1);
-#if defined(_MSC_VER)
-    ::__cpuid(reinterpret_cast<int *>(_registers.data()), cpuid_function);
-#elif defined(__GNUC__)
-    __asm__ __volatile__ (
-        "cpuid ;\n"
-        : "=a" (_registers[cpu_register::eax]),
-          "=b" (_registers[cpu_register::ebx]),
-          "=c" (_registers[cpu_register::ecx]),
-          "=d" (_registers[cpu_register::edx])
-        : "a" (cpuid_function)
-        :);
-#endif  // defined(_MSC_VER)
+    const auto max_function = query(0)[cpu_register::eax];
+    _leaf_1 = query(1);
+    if (max_function >= 7) {
+      _leaf_7 = query(7);
+    }
+
+    // The OS must save the AVX (and AVX-512) registers on context switches for
+    // the instructions to be usable, which it reports through XCR0.
+    if (has_feature_bit(_leaf_1, cpu_register::ecx, cpu_feature_bit::osxsave)) {
+      _xcr0 = read_xcr0();
+    }
 #endif  // defined(json_arch_x86)
   }
 
+  /**
+   * The cpuid instruction is slow, and may even trap to the hypervisor when
+   * running in a virtual machine, so it is executed once per process and the
+   * result is kept. Decode and encode contexts are created very often.
+   */
+  static const cpuid &get() {
+    static const cpuid instance;
+    return instance;
+  }
+
   bool has_sse42() const {
-    return has_feature_bit(cpu_register::ecx, cpu_feature_bit::sse_42);
+    return has_feature_bit(_leaf_1, cpu_register::ecx, cpu_feature_bit::sse_42);
+  }
+
+  bool has_avx2() const {
+    return
+        has_feature_bit(_leaf_1, cpu_register::ecx, cpu_feature_bit::avx) &&
+        has_feature_bit(_leaf_7, cpu_register::ebx, cpu_feature_bit::avx2) &&
+        (_xcr0 & xcr0_avx_state) == xcr0_avx_state;
+  }
+
+  bool has_avx512bw() const {
+    return
+        has_feature_bit(_leaf_7, cpu_register::ebx, cpu_feature_bit::avx512f) &&
+        has_feature_bit(_leaf_7, cpu_register::ebx, cpu_feature_bit::avx512bw) &&
+        (_xcr0 & xcr0_avx512_state) == xcr0_avx512_state;
   }
 
  private:
+  using registers = std::array<uint32_t, 4>;
+
   struct cpu_register {
     enum type {
       eax = 0,
@@ -65,17 +89,63 @@ class cpuid {
 
   struct cpu_feature_bit {
     enum type {
+      // Function 1, ecx
       sse_42 = 20,
+      osxsave = 27,
+      avx = 28,
+      // Function 7, ebx
+      avx2 = 5,
+      avx512f = 16,
+      avx512bw = 30,
     };
   };
 
-  bool has_feature_bit(
+  // XMM and YMM state, and additionally opmask, ZMM0-15 and ZMM16-31 state.
+  static constexpr uint64_t xcr0_avx_state = 0x06;
+  static constexpr uint64_t xcr0_avx512_state = 0xE6;
+
+  static bool has_feature_bit(
+      const registers &values,
       const cpu_register::type &reg,
-      const cpu_feature_bit::type &bit) const {
-    return (_registers[reg] & (1 << bit)) != 0;
+      const cpu_feature_bit::type &bit) {
+    return (values[reg] & (1u << bit)) != 0;
   }
 
-  std::array<uint32_t, 4> _registers;
+#if defined(json_arch_x86)
+  static registers query(const uint32_t cpuid_function) {
+    registers result = {{ 0, 0, 0, 0 }};
+#if defined(_MSC_VER)
+    ::__cpuidex(reinterpret_cast<int *>(result.data()), cpuid_function, 0);
+#elif defined(__GNUC__)
+    __asm__ __volatile__ (
+        "cpuid ;\n"
+        : "=a" (result[cpu_register::eax]),
+          "=b" (result[cpu_register::ebx]),
+          "=c" (result[cpu_register::ecx]),
+          "=d" (result[cpu_register::edx])
+        : "a" (cpuid_function), "c" (0)
+        :);
+#endif  // defined(_MSC_VER)
+    return result;
+  }
+
+  static uint64_t read_xcr0() {
+#if defined(_MSC_VER)
+    return ::_xgetbv(0);
+#elif defined(__GNUC__)
+    uint32_t eax, edx;
+    // xgetbv, spelled out for assemblers that do not know the mnemonic.
+    __asm__ __volatile__ (".byte 0x0f, 0x01, 0xd0" : "=a" (eax), "=d" (edx) : "c" (0));
+    return (static_cast<uint64_t>(edx) << 32) | eax;
+#else
+    return 0;
+#endif  // defined(_MSC_VER)
+  }
+#endif  // defined(json_arch_x86)
+
+  registers _leaf_1 = {{ 0, 0, 0, 0 }};
+  registers _leaf_7 = {{ 0, 0, 0, 0 }};
+  uint64_t _xcr0 = 0;
 };
 
 }  // namespace detail
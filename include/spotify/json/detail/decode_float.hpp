@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace spotify {
+namespace json {
+namespace detail {
+
+/**
+ * Compute the floating point number closest to mantissa * 10^exponent, with
+ * the sign bit set if is_negative is true. These are the fast paths of the
+ * floating point codecs: they return false instead of guessing whenever they
+ * cannot be sure to get the correctly rounded result (subnormals, overflow,
+ * and the rare products that are too close to halfway between two floating
+ * point numbers). The caller must then use a slower, exact algorithm. When
+ * they return true, the result is bit-identical to what such an algorithm
+ * would have returned.
+ *
+ * The implementation is the Clinger fast path for small exponents and the
+ * Eisel-Lemire algorithm for everything else.
+ */
+bool decimal_to_double(uint64_t mantissa, int64_t exponent, bool is_negative, double &value);
+bool decimal_to_float(uint64_t mantissa, int64_t exponent, bool is_negative, float &value);
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
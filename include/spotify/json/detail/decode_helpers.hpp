@@ -20,7 +20,9 @@
 #include <cstdint>
 #include <cstring>
 #include <string>
+#include <type_traits>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include <spotify/json/decode_context.hpp>
@@ -35,35 +37,124 @@ namespace spotify {
 namespace json {
 namespace detail {
 
+/**
+ * Fail decoding at position + d. If context.throw_on_failure is set, this
+ * throws a decode_exception. Otherwise the error is recorded in the context and
+ * this function returns; the caller must then stop decoding and return as soon
+ * as possible. The value that a codec returns from a failed decode is ignored.
+ */
 template <typename string_type>
-json_never_inline json_noreturn void fail(
-    const decode_context &context,
+json_never_inline void fail(
+    decode_context &context,
     const string_type &error,
     const ptrdiff_t d = 0) {
-  throw decode_exception(error, context.offset(d));
+  if (context.throw_on_failure) {
+    json_throw(decode_exception(error, context.offset(d)));
+  }
+  context.set_error(error, d);
 }
 
+/**
+ * Fail decoding if condition is true. Returns the condition, so that callers
+ * can return early when the context does not throw on failure.
+ */
 template <typename string_type, typename condition_type>
-json_force_inline void fail_if(
-    const decode_context &context,
+json_force_inline bool fail_if(
+    decode_context &context,
     const condition_type condition,
     const string_type &error,
     const ptrdiff_t d = 0) {
   if (json_unlikely(condition)) {
     fail(context, error, d);
+    return true;
   }
+  return false;
 }
 
 template <size_t num_required_bytes, typename string_type>
-json_force_inline void require_bytes(const decode_context &context, const string_type &error) {
-  fail_if(context, context.remaining() < num_required_bytes, error);
+json_force_inline bool require_bytes(decode_context &context, const string_type &error) {
+  return fail_if(context, context.remaining() < num_required_bytes, error);
 }
 
 template <size_t num_required_bytes>
-json_force_inline void require_bytes(const decode_context &context) {
-  require_bytes<num_required_bytes>(context, "Unexpected end of input");
+json_force_inline bool require_bytes(decode_context &context) {
+  return require_bytes<num_required_bytes>(context, "Unexpected end of input");
 }
 
+/**
+ * The value that a codec returns when decoding has failed and the context does
+ * not throw on failure. The caller ignores it, so a default constructed value
+ * is used. Types that are not default constructible have no such value, so for
+ * them the failure is thrown even if the context does not throw on failure.
+ * Without exceptions that would abort, so such types can not be decoded then.
+ */
+template <typename T>
+json_force_inline typename std::enable_if<std::is_default_constructible<T>::value, T>::type
+failed_value(const decode_context &) {
+  return T();
+}
+
+template <typename T>
+json_never_inline typename std::enable_if<!std::is_default_constructible<T>::value, T>::type
+failed_value(const decode_context &context) {
+  static_assert(
+      json_has_exceptions || sizeof(T) == 0,
+      "Without exceptions, only default constructible types can be decoded");
+  json_throw(decode_exception(context.error(), context.error_offset()));
+}
+
+/**
+ * Clears context.throw_on_failure while it is alive. Codecs that try to decode
+ * a value in more than one way, like one_of_t, use this so that they can fall
+ * back to the next alternative without throwing and catching an exception.
+ */
+class no_throw_scope final {
+ public:
+  explicit no_throw_scope(decode_context &context)
+      : _context(context),
+        _throw_on_failure(context.throw_on_failure) {
+    context.throw_on_failure = false;
+  }
+
+  ~no_throw_scope() {
+    _context.throw_on_failure = _throw_on_failure;
+  }
+
+  no_throw_scope(const no_throw_scope &) = delete;
+  no_throw_scope &operator=(const no_throw_scope &) = delete;
+
+ private:
+  decode_context &_context;
+  const bool _throw_on_failure;
+};
+
+/**
+ * Clears context.has_mutable_input while it is alive. Codecs that may rewind
+ * the context and decode the same input again, like one_of_t, use this while
+ * they try an alternative, since codecs that modify the input (such as
+ * codec::string_view_t, which unescapes strings in place) would otherwise
+ * leave input behind that can not be decoded a second time.
+ */
+class immutable_input_scope final {
+ public:
+  explicit immutable_input_scope(decode_context &context)
+      : _context(context),
+        _has_mutable_input(context.has_mutable_input) {
+    context.has_mutable_input = false;
+  }
+
+  ~immutable_input_scope() {
+    _context.has_mutable_input = _has_mutable_input;
+  }
+
+  immutable_input_scope(const immutable_input_scope &) = delete;
+  immutable_input_scope &operator=(const immutable_input_scope &) = delete;
+
+ private:
+  decode_context &_context;
+  const bool _has_mutable_input;
+};
+
 json_force_inline char peek_unchecked(const decode_context &context) {
   return *context.position;
 }
@@ -94,9 +185,15 @@ json_force_inline char next_unchecked(decode_context &context) {
   return *(context.position++);
 }
 
+/**
+ * Read the next character. At the end of the input, decoding fails and '\0' is
+ * returned without advancing the position.
+ */
 template <typename string_type>
 json_force_inline char next(decode_context &context, const string_type &error) {
-  require_bytes<1>(context, error);
+  if (require_bytes<1>(context, error)) {
+    return 0;
+  }
   return next_unchecked(context);
 }
 
@@ -113,34 +210,71 @@ json_force_inline void skip_unchecked_n(decode_context &context, const size_t nu
 }
 
 json_force_inline void skip_any_n(decode_context &context, const size_t num_bytes) {
-  fail_if(context, context.remaining() < num_bytes, "Unexpected end of input");
+  if (fail_if(context, context.remaining() < num_bytes, "Unexpected end of input")) {
+    return;
+  }
   skip_unchecked_n(context, num_bytes);
 }
 
 json_force_inline void skip_any_1(decode_context &context) {
-  require_bytes<1>(context, "Unexpected end of input");
+  if (require_bytes<1>(context, "Unexpected end of input")) {
+    return;
+  }
   context.position++;
 }
 
 /**
  * Skip past a specific character. If the context position does not point to a
- * matching character, a decode_exception is thrown.
+ * matching character, decoding fails.
  */
 json_force_inline void skip_1(decode_context &context, char character) {
-  fail_if(context, next(context) != character, "Unexpected input", -1);
+  if (require_bytes<1>(context)) {
+    return;
+  }
+  fail_if(context, next_unchecked(context) != character, "Unexpected input", -1);
 }
 
 /**
  * Skip past four specific characters. If the context position does not point to
- * matching characters, a decode_exception is thrown. 'characters' must be a C
- * string of at least length 4. Only the first four characters will be read.
+ * matching characters, decoding fails. 'characters' must be a C string of at
+ * least length 4. Only the first four characters will be read.
  */
 json_force_inline void skip_4(decode_context &context, const char characters[4]) {
-  require_bytes<4>(context);
-  fail_if(context, memcmp(characters, context.position, 4), "Unexpected input");
+  if (require_bytes<4>(context) ||
+      fail_if(context, memcmp(characters, context.position, 4), "Unexpected input")) {
+    return;
+  }
   context.position += 4;
 }
 
+/**
+ * Decode the elements of a comma separated entity that follow the first one,
+ * and the outro character. The context must be positioned right after the
+ * first element.
+ */
+template <typename parse_function>
+json_force_inline void decode_remaining_comma_separated(
+    decode_context &context,
+    char outro,
+    parse_function &parse) {
+  skip_any_whitespace(context);
+
+  while (json_likely(peek(context) != outro)) {
+    skip_1(context, ',');
+    if (json_unlikely(context.has_failed())) {
+      return;
+    }
+    skip_any_whitespace(context);
+    parse();
+    if (json_unlikely(context.has_failed())) {
+      return;
+    }
+    skip_any_whitespace(context);
+  }
+
+  context.position++;
+}
+
 /**
  * Helper function for parsing the comma separated entities in JSON: objects
  * and arrays. intro and outro are the characters before and after the entity:
@@ -151,26 +285,46 @@ json_force_inline void skip_4(decode_context &context, const char characters[4])
  * The parse callback must mark the context as failed if it sees a premature end
  * of input, otherwise this function might enter an infinite loop!
  *
- * context.has_failed() must be false when this function is called.
+ * context.has_failed() must be false when this function is called. When it
+ * returns, the caller must check context.has_failed().
  */
 template <typename parse_function>
 json_never_inline void decode_comma_separated(decode_context &context, char intro, char outro, parse_function parse) {
   skip_1(context, intro);
+  if (json_unlikely(context.has_failed())) {
+    return;
+  }
+
   skip_any_whitespace(context);
 
-  if (json_likely(peek(context) != outro)) {
-    parse();
-    skip_any_whitespace(context);
+  if (json_unlikely(peek(context) == outro)) {
+    context.position++;
+    return;
+  }
 
-    while (json_likely(peek(context) != outro)) {
-      skip_1(context, ',');
-      skip_any_whitespace(context);
-      parse();
-      skip_any_whitespace(context);
-    }
+  parse();
+  if (json_unlikely(context.has_failed())) {
+    return;
   }
+  decode_remaining_comma_separated(context, outro, parse);
+}
 
-  context.position++;
+/**
+ * Like decode_comma_separated, for an entity of which the caller has already
+ * skipped the intro character and a part of the first element. parse_first
+ * decodes the rest of the first element, and parse the elements after it.
+ */
+template <typename parse_first_function, typename parse_function>
+json_never_inline void decode_comma_separated_after_first(
+    decode_context &context,
+    char outro,
+    parse_first_function parse_first,
+    parse_function parse) {
+  parse_first();
+  if (json_unlikely(context.has_failed())) {
+    return;
+  }
+  decode_remaining_comma_separated(context, outro, parse);
 }
 
 /**
@@ -184,13 +338,78 @@ json_force_inline void decode_object(decode_context &context, const callback_fun
   auto codec = key_codec_type();
   decode_comma_separated(context, '{', '}', [&]{
     auto key = codec.decode(context);
+    if (json_unlikely(context.has_failed())) {
+      return;
+    }
     skip_any_whitespace(context);
     skip_1(context, ':');
+    if (json_unlikely(context.has_failed())) {
+      return;
+    }
     skip_any_whitespace(context);
     callback(std::move(key));
   });
 }
 
+template <typename T>
+struct has_decode_into_method {
+  template <typename U>
+  static auto test(int) -> decltype(
+      std::declval<const U &>().decode_into(
+          std::declval<decode_context &>(),
+          std::declval<typename U::object_type &>()),
+      std::true_type());
+
+  template <typename>
+  static std::false_type test(...);
+
+ public:
+  static constexpr bool value = std::is_same<decltype(test<T>(0)), std::true_type>::value;
+};
+
+/**
+ * Object codecs that can continue decoding an object after its first key, when
+ * the caller has consumed the '{' and the key, have a decode_after_first_key
+ * method. tagged_union_t uses it to avoid decoding the discriminator twice.
+ */
+template <typename T>
+struct has_decode_after_first_key_method {
+  template <typename U>
+  static auto test(int) -> decltype(
+      std::declval<const U &>().decode_after_first_key(
+          std::declval<decode_context &>(),
+          std::declval<const char *>(),
+          std::declval<size_t>()),
+      std::true_type());
+
+  template <typename>
+  static std::false_type test(...);
+
+ public:
+  static constexpr bool value = std::is_same<decltype(test<T>(0)), std::true_type>::value;
+};
+
+/**
+ * Decode into an existing value. Codecs that can reuse the memory of the value
+ * (such as the capacity of strings and vectors) have a decode_into method; for
+ * all other codecs, the decoded value is assigned to the existing value.
+ */
+template <typename codec_type, typename value_type>
+typename std::enable_if<!(
+    has_decode_into_method<codec_type>::value &&
+    std::is_same<typename std::decay<value_type>::type, typename codec_type::object_type>::value)>::type
+json_force_inline decode_into(const codec_type &codec, decode_context &context, value_type &&value) {
+  value = codec.decode(context);
+}
+
+template <typename codec_type, typename value_type>
+typename std::enable_if<(
+    has_decode_into_method<codec_type>::value &&
+    std::is_same<typename std::decay<value_type>::type, typename codec_type::object_type>::value)>::type
+json_force_inline decode_into(const codec_type &codec, decode_context &context, value_type &&value) {
+  codec.decode_into(context, value);
+}
+
 json_force_inline void skip_true(decode_context &context) {
   skip_4(context, "true");
 }
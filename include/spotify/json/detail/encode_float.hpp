@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <spotify/json/encode_context.hpp>
+
+namespace spotify {
+namespace json {
+namespace detail {
+
+/**
+ * Write the shortest decimal number that decodes back to exactly the given
+ * value (for floats, when decoded as a float). The formatting is that of
+ * ECMAScript's Number.prototype.toString(), with an explicit '+' in positive
+ * exponents: exponential notation is used for numbers below 1e-6 and from
+ * 1e21 and up. Negative zero is written as '0'. The value must be finite.
+ */
+void encode_floating_point(encode_context &context, float value);
+void encode_floating_point(encode_context &context, double value);
+
+/**
+ * Write the value rounded to the given number of decimals (at most 17), but
+ * without trailing zeros. Values that are too large to be rounded this way,
+ * from 1e19 / 10^decimals and up, are written like encode_floating_point does
+ * instead. The value must be finite.
+ */
+void encode_fixed_precision(encode_context &context, float value, unsigned decimals);
+void encode_fixed_precision(encode_context &context, double value, unsigned decimals);
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
@@ -28,7 +28,7 @@ template <typename string_type>
 json_never_inline json_noreturn void fail(
     const encode_context &context,
     const string_type &error) {
-  throw encode_exception(error);
+  json_throw(encode_exception(error));
 }
 
 template <typename string_type, typename condition_type>
@@ -29,6 +29,8 @@ void encode_negative_integer_32(encode_context &context, int32_t value);
 void encode_negative_integer_64(encode_context &context, int64_t value);
 void encode_positive_integer_32(encode_context &context, uint32_t value);
 void encode_positive_integer_64(encode_context &context, uint64_t value);
+void encode_signed_integer_32(encode_context &context, int32_t value);
+void encode_signed_integer_64(encode_context &context, int64_t value);
 
 template <typename T>
 json_force_inline void encode_negative_integer(encode_context &context, T value) {
@@ -44,6 +46,13 @@ json_force_inline void encode_positive_integer(encode_context &context, T value)
     encode_positive_integer_64(context, static_cast<uint64_t>(value));
 }
 
+template <typename T>
+json_force_inline void encode_signed_integer(encode_context &context, T value) {
+  return (sizeof(T) <= sizeof(int32_t)) ?
+    encode_signed_integer_32(context, static_cast<int32_t>(value)) :
+    encode_signed_integer_64(context, static_cast<int64_t>(value));
+}
+
 }  // namespace detail
 }  // namespace json
 }  // namespace spotify
@@ -17,6 +17,7 @@
 #pragma once
 
 #include <spotify/json/encode_context.hpp>
+#include <spotify/json/detail/kernels.hpp>
 #include <spotify/json/detail/macros.hpp>
 
 namespace spotify {
@@ -47,12 +48,7 @@ json_force_inline void write_escaped(
     encode_context &context,
     const char *begin,
     const char *end) {
-#if defined(json_arch_x86_sse42)
-  if (json_likely(context.has_sse42)) {
-    return write_escaped_sse42(context, begin, end);
-  }
-#endif  // defined(json_arch_x86_sse42)
-  write_escaped_scalar(context, begin, end);
+  get_kernels().write_escaped(context, begin, end);
 }
 
 }  // namespace detail
@@ -16,39 +16,130 @@
 
 #pragma once
 
+#include <cstddef>
 #include <memory>
 #include <string>
-#include <unordered_map>
-#include <utility>
 #include <vector>
 
+#include <spotify/json/decode_context.hpp>
+#include <spotify/json/detail/macros.hpp>
+#include <spotify/json/encode_context.hpp>
+
 namespace spotify {
 namespace json {
 namespace detail {
 
+/**
+ * The fields of an object codec, compiled into one contiguous table. Each
+ * entry holds the escaped key of the field, a type erased pointer to the field
+ * (its codec and accessors) and plain function pointers that decode and encode
+ * it, so that no virtual calls are needed to get to a field.
+ *
+ * The table is immutable once shared: copying a registry only copies a single
+ * shared pointer, and saving a field to a registry that shares its table with
+ * another registry first makes a private copy of the table.
+ */
 // Non-templated class to reduce code bloat.
 class field_registry final {
  public:
-  using field_vec = std::vector<std::pair<std::string, std::shared_ptr<const void>>>;
-  using field_map = std::unordered_map<std::string, std::shared_ptr<const void>>;
-  using const_iterator = typename field_vec::const_iterator;
+  using decode_function = void (*)(
+      const void *field,
+      decode_context &context,
+      void *object);
+  using reset_function = void (*)(
+      const void *field,
+      void *prototype,
+      void *object);
+  using encode_function = void (*)(
+      const void *field,
+      encode_context &context,
+      const std::string &escaped_key,
+      const void *object);
+
+  struct entry {
+    json_force_inline bool is_required() const { return (required_field_idx != json_size_t_max); }
+
+    std::string escaped_key;  // including quotes and a trailing ':', e.g. "\"name\":"
+    const void *field;
+    decode_function decode;
+    decode_function decode_into;  // decodes into the existing value of the field
+    reset_function reset;  // moves the value of the field in prototype to object
+    encode_function encode;
+    size_t required_field_idx;  // json_size_t_max for optional fields
+  };
+
+  using const_iterator = const entry *;
 
   field_registry();
   ~field_registry();
   field_registry(const field_registry &);
-  field_registry(field_registry &&);
+  field_registry(field_registry &&) noexcept;
 
   // Forward the iterator implementation so range based for works.
-  inline const_iterator begin() const noexcept { return _field_list.begin(); }
-  inline const_iterator end() const noexcept { return _field_list.end(); }
+  inline const_iterator begin() const noexcept { return _entries; }
+  inline const_iterator end() const noexcept { return _entries + _size; }
+
+  /**
+   * Save a field to the registry. The field_size is the number of bytes owned
+   * by the field, which is only used to report the memory footprint. Fields
+   * with the same name as an already saved field are ignored.
+   */
+  void save(
+      const std::string &name,
+      bool required,
+      std::shared_ptr<const void> field,
+      size_t field_size,
+      decode_function decode,
+      decode_function decode_into,
+      reset_function reset,
+      encode_function encode);
 
-  void save(const std::string &name, bool required, const std::shared_ptr<void> &f);
-  const void *find(const std::string &name) const noexcept;
   size_t num_required_fields() const noexcept { return _num_required_fields; }
+  size_t size() const noexcept { return _size; }
+
+  /**
+   * The field at the given index, in registration order.
+   */
+  const entry &at(size_t index) const noexcept { return _entries[index]; }
+
+  /**
+   * Find the index of the field with the given (unescaped) name, or
+   * json_size_t_max if there is no such field. The name does not have to be
+   * null terminated, which makes it possible to match keys directly against
+   * the bytes of the JSON input without first copying them into a string.
+   */
+  size_t find_index(const char *name, size_t size) const noexcept;
+
+  const entry *find(const char *name, size_t size) const noexcept {
+    const auto index = find_index(name, size);
+    return (index != json_size_t_max ? &at(index) : nullptr);
+  }
+
+  const entry *find(const std::string &name) const noexcept {
+    return find(name.data(), name.size());
+  }
+
+  /**
+   * The number of bytes of memory used by the registry, including the memory
+   * of the table that may be shared with copies of the registry.
+   */
+  size_t memory_footprint() const noexcept;
 
  private:
-  field_vec _field_list;
-  field_map _fields;
+  struct key_entry {
+    std::string name;
+    size_t index;
+  };
+
+  struct table;
+
+  table &mutable_table();
+
+  std::shared_ptr<table> _table;
+
+  // Cached from _table, to avoid an extra pointer chase when decoding.
+  const entry *_entries = nullptr;
+  size_t _size = 0;
   size_t _num_required_fields = 0;
 };
 
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include <spotify/json/decode_context.hpp>
+#include <spotify/json/detail/macros.hpp>
+#include <spotify/json/detail/structural_index.hpp>
+#include <spotify/json/encode_context.hpp>
+#include <spotify/json/instruction_set.hpp>
+
+namespace spotify {
+namespace json {
+namespace detail {
+
+/**
+ * A table of the kernels for one instruction set. There is one table for each
+ * instruction set that the library is built with, and the one that is in use
+ * is picked the first time a kernel is called. Selecting the kernels once per
+ * process means that the contexts do not need to know about the CPU, and that
+ * calls to the kernels do not branch on its features.
+ *
+ * The kernels that find offsets write them to memory that the caller provides,
+ * and return when fewer than 64 slots are left, so that the caller can make
+ * room and call again. Standard containers are kept out of the files that are
+ * built for an instruction set, since their inline functions would be emitted
+ * there as weak symbols that the linker may pick for callers on any CPU.
+ */
+struct kernels final {
+  instruction_set isa;
+  void (*skip_any_simple_characters)(decode_context &context);
+  void (*skip_any_whitespace)(decode_context &context);
+  void (*write_escaped)(encode_context &context, const char *begin, const char *end);
+  uint32_t *(*find_structurals)(
+      structural_state &state,
+      const char *begin,
+      const char *end,
+      uint32_t *out,
+      uint32_t *out_end);
+  const char *(*skip_container)(container_state &state, const char *begin, const char *end);
+  void (*summarize_chunk)(const char *begin, const char *end, bool escape_next, chunk_summary &summary);
+  uint32_t *(*find_separators)(
+      separator_state &state,
+      const char *begin,
+      const char *end,
+      uint32_t *out,
+      uint32_t *out_end);
+};
+
+/**
+ * The kernels that are in use. Before they have been picked, this points to a
+ * table of kernels that pick them and then call the picked kernel. It is never
+ * null, not even during static initialization.
+ */
+extern std::atomic<const kernels *> active_kernels;
+
+/**
+ * The table of kernels for the instruction set, or nullptr if it is not
+ * supported by the CPU or by this build of the library.
+ */
+const kernels *find_kernels(instruction_set isa);
+
+/**
+ * Pick the kernels, if that has not been done yet, and return the ones in use.
+ */
+const kernels &resolve_kernels();
+
+json_force_inline const kernels &get_kernels() {
+  return *active_kernels.load(std::memory_order_relaxed);
+}
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
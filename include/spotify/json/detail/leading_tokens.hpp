@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include <spotify/json/decode_context.hpp>
+#include <spotify/json/detail/macros.hpp>
+
+namespace spotify {
+namespace json {
+namespace detail {
+
+/**
+ * A set of kinds of tokens that a JSON value can start with. Codecs can tell
+ * which kinds of tokens they are able to decode (see codec_interface), which
+ * lets codecs like one_of_t pick a codec by looking at a single character.
+ */
+using token_set = uint8_t;
+
+constexpr token_set token_object = 1 << 0;  // {
+constexpr token_set token_array = 1 << 1;  // [
+constexpr token_set token_string = 1 << 2;  // "
+constexpr token_set token_number = 1 << 3;  // - + . 0-9
+constexpr token_set token_true = 1 << 4;  // t
+constexpr token_set token_false = 1 << 5;  // f
+constexpr token_set token_null = 1 << 6;  // n
+constexpr token_set token_other = 1 << 7;  // Anything else, including end of input
+constexpr token_set token_boolean = token_true | token_false;
+constexpr token_set token_any = 0xFF;
+
+json_force_inline token_set token_of(const char c) {
+  switch (c) {
+    case '{': return token_object;
+    case '[': return token_array;
+    case '"': return token_string;
+    case '-': case '+': case '.':
+    case '0': case '1': case '2': case '3': case '4':
+    case '5': case '6': case '7': case '8': case '9': return token_number;
+    case 't': return token_true;
+    case 'f': return token_false;
+    case 'n': return token_null;
+    default: return token_other;
+  }
+}
+
+/**
+ * The kind of token at context.position, without consuming it.
+ */
+json_force_inline token_set peek_token(const decode_context &context) {
+  return context.remaining() ? token_of(*context.position) : token_other;
+}
+
+template <typename T>
+struct has_leading_tokens_method {
+  template <typename U>
+  static auto test(int) -> decltype(
+      std::declval<const U &>().leading_tokens(),
+      std::true_type());
+
+  template <typename>
+  static std::false_type test(...);
+
+ public:
+  static constexpr bool value = std::is_same<decltype(test<T>(0)), std::true_type>::value;
+};
+
+/**
+ * The kinds of tokens that the codec is able to decode. Codecs that do not
+ * say are assumed to be able to decode anything.
+ */
+template <typename codec_type>
+typename std::enable_if<!has_leading_tokens_method<codec_type>::value, token_set>::type
+json_force_inline leading_tokens(const codec_type &) {
+  return token_any;
+}
+
+template <typename codec_type>
+typename std::enable_if<has_leading_tokens_method<codec_type>::value, token_set>::type
+json_force_inline leading_tokens(const codec_type &codec) {
+  return codec.leading_tokens();
+}
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
@@ -25,6 +25,11 @@
   #define json_likely(expr) (expr)
   #define json_unlikely(expr) (expr)
   #define json_unreachable() std::abort()
+  #define json_deprecated(message) __declspec(deprecated(message))
+  #define json_begin_deprecated_definitions \
+    __pragma(warning(push)) \
+    __pragma(warning(disable: 4996))
+  #define json_end_deprecated_definitions __pragma(warning(pop))
 #elif defined(__GNUC__)
   #define json_force_inline __attribute__((always_inline)) inline
   #define json_never_inline __attribute__((noinline))
@@ -32,6 +37,11 @@
   #define json_likely(expr) __builtin_expect(!!(expr), 1)
   #define json_unlikely(expr) __builtin_expect(!!(expr), 0)
   #define json_unreachable() __builtin_unreachable()
+  #define json_deprecated(message) __attribute__((deprecated(message)))
+  #define json_begin_deprecated_definitions \
+    _Pragma("GCC diagnostic push") \
+    _Pragma("GCC diagnostic ignored \"-Wdeprecated-declarations\"")
+  #define json_end_deprecated_definitions _Pragma("GCC diagnostic pop")
 #else
   #define json_force_inline inline
   #define json_never_inline
@@ -39,6 +49,9 @@
   #define json_likely(expr) (expr)
   #define json_unlikely(expr) (expr)
   #define json_unreachable() std::abort()
+  #define json_deprecated(message)
+  #define json_begin_deprecated_definitions
+  #define json_end_deprecated_definitions
 #endif  // _MSC_VER
 
 #ifdef max
@@ -51,6 +64,23 @@
 
 #define json_size_t_max static_cast<size_t>(-1)
 
+// When the library is built with -fno-exceptions, failures that can not be
+// reported in any other way abort the process, and json_catch blocks are never
+// entered (they can not name the caught exception for that reason). The
+// exception is still named in an unevaluated operand, so that what it is built
+// from does not become unused.
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+  #define json_has_exceptions 1
+  #define json_throw(exception) throw exception
+  #define json_try try
+  #define json_catch(declaration) catch (declaration)
+#else
+  #define json_has_exceptions 0
+  #define json_throw(exception) ((void)sizeof((exception)), std::abort())
+  #define json_try if (true)
+  #define json_catch(declaration) else
+#endif
+
 // http://graphics.stanford.edu/~seander/bithacks.html
 #define json_haszero_1(v) (!(v))
 #define json_haszero_2(v) uint16_t(((v) - 0x0101U) & ~(v) & 0x8080U)
@@ -87,3 +117,11 @@
 #if defined(json_arch_x86) && defined(SPOTIFY_JSON_USE_SSE42)
   #define json_arch_x86_sse42
 #endif
+
+#if defined(json_arch_x86) && defined(SPOTIFY_JSON_USE_AVX2)
+  #define json_arch_x86_avx2
+#endif
+
+#if defined(json_arch_x86) && defined(SPOTIFY_JSON_USE_AVX512)
+  #define json_arch_x86_avx512
+#endif
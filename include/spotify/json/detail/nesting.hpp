@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+namespace spotify {
+namespace json {
+namespace detail {
+
+/**
+ * The first '{' or '[' in the JSON value that starts in [begin, end) (after
+ * whitespace) that is nested more than max_depth levels deep, or end if there
+ * is none. Brackets in strings are not counted, and scanning stops at the end
+ * of the value, so input that follows it is not looked at. The brackets are
+ * found with the find_structurals kernel in use, 64 bytes at a time, so this
+ * costs about as much as building a structural_index of the value.
+ */
+const char *find_too_deep_nesting(const char *begin, const char *end, size_t max_depth);
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
@@ -17,6 +17,7 @@
 #pragma once
 
 #include <spotify/json/decode_context.hpp>
+#include <spotify/json/detail/kernels.hpp>
 #include <spotify/json/detail/macros.hpp>
 
 namespace spotify {
@@ -27,6 +28,12 @@ void skip_any_simple_characters_scalar(decode_context &context);
 #if defined(json_arch_x86_sse42)
 void skip_any_simple_characters_sse42(decode_context &context);
 #endif  // defined(json_arch_x86_sse42)
+#if defined(json_arch_x86_avx2)
+void skip_any_simple_characters_avx2(decode_context &context);
+#endif  // defined(json_arch_x86_avx2)
+#if defined(json_arch_x86_avx512)
+void skip_any_simple_characters_avx512(decode_context &context);
+#endif  // defined(json_arch_x86_avx512)
 
 /**
  * Skip past the bytes of the string until either a " or a \ character is
@@ -36,33 +43,33 @@ void skip_any_simple_characters_sse42(decode_context &context);
  * single read operation.
  */
 json_force_inline void skip_any_simple_characters(decode_context &context) {
-#if defined(json_arch_x86_sse42)
-  if (json_likely(context.has_sse42)) {
-    return skip_any_simple_characters_sse42(context);
-  }
-#endif  // defined(json_arch_x86_sse42)
-  return skip_any_simple_characters_scalar(context);
+  get_kernels().skip_any_simple_characters(context);
 }
 
 void skip_any_whitespace_scalar(decode_context &context);
 #if defined(json_arch_x86_sse42)
 void skip_any_whitespace_sse42(decode_context &context);
 #endif  // defined(json_arch_x86_sse42)
+#if defined(json_arch_x86_avx2)
+void skip_any_whitespace_avx2(decode_context &context);
+#endif  // defined(json_arch_x86_avx2)
+#if defined(json_arch_x86_avx512)
+void skip_any_whitespace_avx512(decode_context &context);
+#endif  // defined(json_arch_x86_avx512)
 
 /**
  * Skip past the bytes of the string until a non-whitespace character is
- * found. This method attempts to skip as large chunks of memory as possible
- * at each step, by making sure that the context position is aligned to the
- * appropriate address and then reading and comparing several bytes in a
- * single read operation.
+ * found. The next character is checked here, so that input without whitespace
+ * between tokens, such as minified input, never calls the whitespace kernel.
  */
 json_force_inline void skip_any_whitespace(decode_context &context) {
-#if defined(json_arch_x86_sse42)
-  if (json_likely(context.has_sse42)) {
-    return skip_any_whitespace_sse42(context);
+  // All whitespace characters are less than or equal to ' ', and no token
+  // starts with such a character.
+  const auto position = context.position;
+  if (position == context.end || static_cast<unsigned char>(*position) > ' ') {
+    return;
   }
-#endif  // defined(json_arch_x86_sse42)
-  skip_any_whitespace_scalar(context);
+  get_kernels().skip_any_whitespace(context);
 }
 
 }  // namespace detail
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <spotify/json/thread_pool.hpp>
+
+namespace spotify {
+namespace json {
+namespace detail {
+
+/**
+ * Find the commas between the elements of the array or object whose contents
+ * start at begin, and the bracket that closes it, on the threads of pool.
+ *
+ * The input is split into chunks of chunk_size bytes at arbitrary offsets, so
+ * a chunk may start inside a string. Each chunk is first summarized on its own
+ * under both guesses of whether it starts inside a string (see
+ * chunk_summary). Going through the summaries in order then tells which guess
+ * was right for every chunk and how deeply nested its start is, after which
+ * the chunks are searched for separators in parallel.
+ *
+ * The separators are stored in order, ending with the closing bracket.
+ * Returns false if the container does not end before end. The contents of the
+ * container are not validated.
+ */
+bool split_elements(
+    const char *begin,
+    const char *end,
+    size_t chunk_size,
+    thread_pool &pool,
+    std::vector<const char *> &separators);
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <spotify/json/detail/macros.hpp>
+
+namespace spotify {
+namespace json {
+namespace detail {
+
+/**
+ * Where a scan of skip_container stopped when it reached the end of the input
+ * before the end of the object or array: the nesting depth, and whether the
+ * input ended inside a string or right after a backslash.
+ */
+struct container_state final {
+  uint64_t depth = 0;
+  bool in_string = false;
+  bool escape_next = false;
+};
+
+/**
+ * What a chunk of input does to the nesting depth if it starts outside a
+ * string (index 0) and if it starts inside one (index 1), and whether it ends
+ * in the other string state than it starts in.
+ */
+struct chunk_summary final {
+  int64_t depth_change[2];
+  bool flips_string;
+};
+
+/**
+ * Where a scan of find_structurals stopped when there was no more room for
+ * offsets: the offset of the next block, and the state that crosses block
+ * boundaries (see structural_scanner).
+ */
+struct structural_state final {
+  size_t offset = 0;
+  bool in_string = false;
+  bool escape_next = false;
+  bool follows_separator = true;
+};
+
+/**
+ * Where a scan of find_separators stopped when there was no more room for
+ * offsets: the offset of the next block from the start of the chunk, and the
+ * nesting depth and string state there.
+ */
+struct separator_state final {
+  explicit separator_state(const container_state &state)
+      : depth(static_cast<int64_t>(state.depth)),
+        in_string(state.in_string),
+        escape_next(state.escape_next) {}
+
+  size_t offset = 0;
+  int64_t depth;
+  bool in_string;
+  bool escape_next;
+};
+
+uint32_t *find_structurals_scalar(structural_state &state, const char *begin, const char *end, uint32_t *out, uint32_t *out_end);
+const char *skip_container_scalar(container_state &state, const char *begin, const char *end);
+void summarize_chunk_scalar(const char *begin, const char *end, bool escape_next, chunk_summary &summary);
+uint32_t *find_separators_scalar(separator_state &state, const char *begin, const char *end, uint32_t *out, uint32_t *out_end);
+#if defined(json_arch_x86_sse42)
+uint32_t *find_structurals_sse42(structural_state &state, const char *begin, const char *end, uint32_t *out, uint32_t *out_end);
+const char *skip_container_sse42(container_state &state, const char *begin, const char *end);
+void summarize_chunk_sse42(const char *begin, const char *end, bool escape_next, chunk_summary &summary);
+uint32_t *find_separators_sse42(separator_state &state, const char *begin, const char *end, uint32_t *out, uint32_t *out_end);
+#endif  // defined(json_arch_x86_sse42)
+#if defined(json_arch_x86_avx2)
+uint32_t *find_structurals_avx2(structural_state &state, const char *begin, const char *end, uint32_t *out, uint32_t *out_end);
+const char *skip_container_avx2(container_state &state, const char *begin, const char *end);
+void summarize_chunk_avx2(const char *begin, const char *end, bool escape_next, chunk_summary &summary);
+uint32_t *find_separators_avx2(separator_state &state, const char *begin, const char *end, uint32_t *out, uint32_t *out_end);
+#endif  // defined(json_arch_x86_avx2)
+#if defined(json_arch_x86_avx512)
+uint32_t *find_structurals_avx512(structural_state &state, const char *begin, const char *end, uint32_t *out, uint32_t *out_end);
+const char *skip_container_avx512(container_state &state, const char *begin, const char *end);
+void summarize_chunk_avx512(const char *begin, const char *end, bool escape_next, chunk_summary &summary);
+uint32_t *find_separators_avx512(separator_state &state, const char *begin, const char *end, uint32_t *out, uint32_t *out_end);
+#endif  // defined(json_arch_x86_avx512)
+
+/**
+ * The offsets of the structural characters ({, }, [, ], : and ,) and of the
+ * first character of every string and other value that is not inside a
+ * string, found with the find_structurals kernel in use in one pass over the
+ * whole input, 64 bytes at a time. The index takes four bytes per token, plus
+ * at most as much again of room that it grew into, and the input must be
+ * smaller than 4 GB; for larger input the index is left empty.
+ */
+class structural_index final {
+ public:
+  structural_index(const char *begin, const char *end);
+
+  const std::vector<uint32_t> &offsets() const {
+    return _offsets;
+  }
+
+ private:
+  std::vector<uint32_t> _offsets;
+};
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
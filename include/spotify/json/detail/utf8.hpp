@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+
+#pragma once
+
+namespace spotify {
+namespace json {
+namespace detail {
+
+/**
+ * The first byte in [begin, end) that starts a sequence that is not valid
+ * UTF-8, or end if all of it is valid. Valid UTF-8 is as in RFC 3629, so
+ * overlong encodings, surrogates and code points above U+10FFFF are invalid.
+ */
+const char *find_invalid_utf8(const char *begin, const char *end);
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
@@ -37,7 +37,7 @@ json_never_inline std::string encode(
 
 template <typename object_type>
 json_never_inline std::string encode(const object_type &object) {
-  return encode(default_codec<object_type>(), object);
+  return encode(cached_default_codec<object_type>(), object);
 }
 
 template <typename codec_type, typename value_type>
@@ -51,7 +51,7 @@ json_never_inline encoded_value encode_value(
 
 template <typename value_type>
 json_never_inline encoded_value encode_value(const value_type &value) {
-  return encode_value(default_codec<value_type>(), value);
+  return encode_value(cached_default_codec<value_type>(), value);
 }
 
 }  // namespace json
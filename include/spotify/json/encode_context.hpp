@@ -24,8 +24,8 @@
 #include <limits>
 #include <memory>
 
-#include <spotify/json/detail/cpuid.hpp>
 #include <spotify/json/detail/macros.hpp>
+#include <spotify/json/instruction_set.hpp>
 
 namespace spotify {
 namespace json {
@@ -35,16 +35,16 @@ namespace detail {
  * An encode_context has the information that is kept while encoding JSON with
  * codecs. It keeps a buffer of data that can be expanded and written to.
  */
+json_begin_deprecated_definitions  // for has_sse42
 template <typename size_type = std::size_t>
 struct base_encode_context final {
   base_encode_context(const size_type capacity = 4096)
-      : has_sse42(detail::cpuid().has_sse42()),
-        _buf(static_cast<char *>(capacity ? std::malloc(capacity) : nullptr)),
+      : _buf(static_cast<char *>(capacity ? std::malloc(capacity) : nullptr)),
         _ptr(_buf),
         _end(_buf + capacity),
         _capacity(capacity) {
     if (json_unlikely(!_buf && _capacity > 0)) {
-      throw std::bad_alloc();
+      json_throw(std::bad_alloc());
     }
   }
 
@@ -113,7 +113,12 @@ struct base_encode_context final {
     return std::unique_ptr<void, decltype(std::free) *>(data, &std::free);
   }
 
-  const bool has_sse42;
+  /**
+   * Whether the kernels in use (see instruction_set.hpp) use SSE 4.2. The
+   * kernels are picked once per process, so codecs no longer need this.
+   */
+  json_deprecated("Use spotify::json::active_instruction_set() instead")
+  const bool has_sse42 = (active_instruction_set() != instruction_set::scalar);
 
  private:
   json_never_inline void grow_buffer(const size_type num_bytes) {
@@ -122,7 +127,7 @@ struct base_encode_context final {
     if (json_unlikely(new_size < old_size)) {
       // If we overflow the size integer, it means that we need more memory than
       // we can possibly provide, so we should throw an allocation exception.
-      throw std::bad_alloc();
+      json_throw(std::bad_alloc());
     }
 
     auto new_capacity = size_type(_capacity * 2);
@@ -139,7 +144,7 @@ struct base_encode_context final {
     const auto actual_capacity = std::max(new_size, new_capacity);
     _buf = static_cast<char *>(std::realloc(_buf, actual_capacity));
     if (json_unlikely(!_buf)) {
-      throw std::bad_alloc();
+      json_throw(std::bad_alloc());
     }
 
     _ptr = _buf + old_size;
@@ -152,6 +157,7 @@ struct base_encode_context final {
   const char *_end;
   size_type _capacity;
 };
+json_end_deprecated_definitions
 
 }  // namespace detail
 
@@ -159,7 +159,7 @@ inline encoded_value::encoded_value(const char *data, std::size_t size, const un
     : _size(size),
       _data(std::malloc(size), &std::free) {
   if (json_unlikely(!_data && size)) {
-    throw std::bad_alloc();
+    json_throw(std::bad_alloc());
   }
   std::memcpy(_data.get(), data, _size);
 }
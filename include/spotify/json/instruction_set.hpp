@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+
+#pragma once
+
+namespace spotify {
+namespace json {
+
+/**
+ * The instruction sets that the library has kernels for. The kernels are the
+ * routines that skip whitespace and string characters when decoding and that
+ * escape strings when encoding. They are picked once per process, for the
+ * widest instruction set that is supported both by the CPU and by the build of
+ * the library (see the SPOTIFY_JSON_USE_* CMake options).
+ */
+enum class instruction_set {
+  scalar,
+  sse42,
+  avx2,
+  avx512bw
+};
+
+/**
+ * The name of the instruction set, e.g. "avx2".
+ */
+const char *instruction_set_name(instruction_set isa);
+
+/**
+ * Whether the library has kernels for the instruction set and the CPU is able
+ * to run them. The scalar kernels are always supported.
+ */
+bool is_instruction_set_supported(instruction_set isa);
+
+/**
+ * The instruction set of the kernels that are currently in use.
+ */
+instruction_set active_instruction_set();
+
+/**
+ * Use the kernels for the given instruction set from now on. This is meant for
+ * tests and benchmarks that compare the kernels. All kernels produce the same
+ * results, so it is safe to call while other threads are decoding or encoding.
+ * Returns false, and keeps the current kernels, if the instruction set is not
+ * supported.
+ */
+bool use_instruction_set(instruction_set isa);
+
+}  // namespace json
+}  // namespace spotify
@@ -16,12 +16,20 @@
 
 #pragma once
 
+#include <spotify/json/chunked_decoder.hpp>
 #include <spotify/json/codec.hpp>
 #include <spotify/json/decode.hpp>
 #include <spotify/json/decode_exception.hpp>
+#include <spotify/json/decode_many.hpp>
+#include <spotify/json/decode_parallel.hpp>
 #include <spotify/json/decode_context.hpp>
+#include <spotify/json/decode_policy.hpp>
 #include <spotify/json/default_codec.hpp>
 #include <spotify/json/encode.hpp>
 #include <spotify/json/encode_exception.hpp>
 #include <spotify/json/encode_context.hpp>
 #include <spotify/json/encoded_value.hpp>
+#include <spotify/json/instruction_set.hpp>
+#include <spotify/json/ndjson_reader.hpp>
+#include <spotify/json/string_view.hpp>
+#include <spotify/json/thread_pool.hpp>
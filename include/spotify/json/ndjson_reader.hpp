@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <utility>
+
+#include <spotify/json/decode_context.hpp>
+#include <spotify/json/decode_exception.hpp>
+#include <spotify/json/default_codec.hpp>
+#include <spotify/json/detail/block_reader.hpp>
+#include <spotify/json/detail/decode_helpers.hpp>
+#include <spotify/json/detail/macros.hpp>
+#include <spotify/json/detail/skip_chars.hpp>
+#include <spotify/json/string_view.hpp>
+
+namespace spotify {
+namespace json {
+
+/**
+ * The size and number of the blocks that an ndjson_reader reads ahead.
+ */
+constexpr size_t ndjson_block_size = 1 << 20;
+constexpr size_t ndjson_block_count = 4;
+
+/**
+ * Reads newline-delimited JSON (also known as JSON Lines) from a file, one
+ * record at a time. The file is read ahead in blocks on a thread of its own
+ * (see detail::block_reader), so decoding does not wait for reads, and memory
+ * use does not depend on the size of the file: it is the blocks, plus a buffer
+ * for records that span two blocks, which is as large as the largest such
+ * record.
+ *
+ * A newline cannot occur inside a JSON string, where it has to be escaped, so
+ * every newline in the file ends a record. Records are found with memchr and
+ * decoded in place, in the block that they were read into. Each record is
+ * decoded like decode() would decode it, so a record with trailing input after
+ * its value fails. Lines that are empty or only whitespace are skipped.
+ *
+ * Values that point into the input, such as those of codec::string_view_t, are
+ * only valid until the next call to next().
+ */
+template <typename codec_type>
+class ndjson_reader final {
+ public:
+  using object_type = typename codec_type::object_type;
+
+  /**
+   * Read from the file at path.
+   *
+   * @throws std::system_error if the file cannot be opened.
+   */
+  ndjson_reader(
+      codec_type codec,
+      const std::string &path,
+      const size_t block_size = ndjson_block_size,
+      const size_t block_count = ndjson_block_count)
+      : _codec(std::move(codec)),
+        _reader(path, block_size, block_count) {}
+
+  /**
+   * Read from the file descriptor fd. It is not closed by the reader. It may
+   * be a pipe or a socket, except on Windows, where it must be a regular file.
+   */
+  ndjson_reader(
+      codec_type codec,
+      const int fd,
+      const size_t block_size = ndjson_block_size,
+      const size_t block_count = ndjson_block_count)
+      : _codec(std::move(codec)),
+        _reader(fd, false, block_size, block_count) {}
+
+  /**
+   * Decode the next record into value. A record that fails to decode leaves
+   * value unchanged.
+   *
+   * @return false at the end of the file.
+   * @throws decode_exception if a record fails to decode. The offset of the
+   *     exception counts from the start of the file.
+   * @throws std::system_error if reading from the file fails.
+   */
+  bool next(object_type &value) {
+    for (;;) {
+      if (_position == _block.end()) {
+        if (!next_block()) {
+          return finish_record(value);
+        }
+      }
+
+      const auto remaining = static_cast<size_t>(_block.end() - _position);
+      const auto newline = static_cast<const char *>(std::memchr(_position, '\n', remaining));
+      if (!newline) {
+        begin_carry();
+        _carry.append(_position, remaining);
+        _position = _block.end();
+        continue;
+      }
+
+      const auto begin = _position;
+      _position = newline + 1;
+      if (_carry.empty()) {
+        if (decode_record(begin, newline, _block_offset + (begin - _block.data()), value)) {
+          return true;
+        }
+      } else if (finish_record(begin, newline, value)) {
+        return true;
+      }
+    }
+  }
+
+ private:
+  bool next_block() {
+    _block_offset += _block.size();
+    _block = _reader.next();
+    _position = _block.data();
+    return !_block.empty();
+  }
+
+  void begin_carry() {
+    if (_carry.empty()) {
+      _carry_offset = _block_offset + (_position - _block.data());
+    }
+  }
+
+  /**
+   * Decode the record that started in an earlier block and ends at end. The
+   * carry is moved out while decoding, so that it is empty even if the record
+   * fails to decode, and the next record does not get appended to it.
+   */
+  bool finish_record(const char *begin, const char *end, object_type &value) {
+    std::string record;
+    record.swap(_carry);
+    record.append(begin, end - begin);
+    const auto decoded = decode_record(record.data(), record.data() + record.size(), _carry_offset, value);
+    record.clear();
+    _carry.swap(record);  // Keep the capacity for the next record
+    return decoded;
+  }
+
+  /**
+   * Decode the last record of a file that does not end with a newline.
+   */
+  bool finish_record(object_type &value) {
+    return finish_record(_position, _position, value);
+  }
+
+  /**
+   * Decode the record between begin and end, which is at offset in the file.
+   * Returns false if the record is only whitespace. Like decode(), a record
+   * that fails to decode leaves value untouched.
+   */
+  bool decode_record(const char *begin, const char *end, const size_t offset, object_type &value) {
+    decode_context context(begin, end);
+    context.throw_on_failure = false;
+    detail::skip_any_whitespace(context);
+    if (context.position == context.end) {
+      return false;
+    }
+
+    auto decoded = _codec.decode(context);
+    detail::skip_any_whitespace(context);
+    detail::fail_if(context, context.position != context.end, "Unexpected trailing input");
+    if (json_unlikely(context.has_failed())) {
+      json_throw(decode_exception(context.error(), offset + context.error_offset()));
+    }
+    value = std::move(decoded);
+    return true;
+  }
+
+  codec_type _codec;
+  detail::block_reader _reader;
+  json::string_view _block;
+  const char *_position = _block.data();
+  size_t _block_offset = 0;  // Of the start of _block in the file
+  std::string _carry;  // The start of a record that continues in the next block
+  size_t _carry_offset = 0;
+};
+
+}  // namespace json
+}  // namespace spotify
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <ostream>
+#include <string>
+
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
+
+namespace spotify {
+namespace json {
+
+/**
+ * A non-owning reference to a range of characters, used by codec::string_view_t
+ * to hand out strings that point directly into the JSON input. The referenced
+ * memory must outlive the view.
+ */
+struct string_view final {
+  string_view()
+      : _data(""),
+        _size(0) {}
+
+  string_view(const char *data, std::size_t size)
+      : _data(data),
+        _size(size) {}
+
+  string_view(const char *cstr)
+      : string_view(cstr, std::strlen(cstr)) {}
+
+  string_view(const std::string &string)
+      : string_view(string.data(), string.size()) {}
+
+  const char *data() const { return _data; }
+  std::size_t size() const { return _size; }
+  bool empty() const { return _size == 0; }
+
+  const char *begin() const { return _data; }
+  const char *end() const { return _data + _size; }
+
+  char operator[](std::size_t index) const { return _data[index]; }
+
+  explicit operator std::string() const {
+    return std::string(_data, _size);
+  }
+
+#if __cplusplus >= 201703L
+  operator std::string_view() const {
+    return std::string_view(_data, _size);
+  }
+#endif
+
+ private:
+  const char *_data;
+  std::size_t _size;
+};
+
+inline bool operator==(const string_view &a, const string_view &b) {
+  return
+      a.size() == b.size() &&
+      (a.data() == b.data() || std::memcmp(a.data(), b.data(), a.size()) == 0);
+}
+
+inline bool operator!=(const string_view &a, const string_view &b) {
+  return !(a == b);
+}
+
+inline bool operator<(const string_view &a, const string_view &b) {
+  const auto result = std::memcmp(a.data(), b.data(), std::min(a.size(), b.size()));
+  return result < 0 || (result == 0 && a.size() < b.size());
+}
+
+inline std::ostream &operator <<(std::ostream &stream, const string_view &value) {
+  stream.write(value.data(), value.size());
+  return stream;
+}
+
+}  // namespace json
+}  // namespace spotify
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace spotify {
+namespace json {
+
+/**
+ * A fixed set of threads for spreading work over cores, used by decode_many
+ * and decode_parallel. The work is a range of indices that is split up front
+ * into one part for each thread, so threads do not share a queue. A thread
+ * that runs out of work steals the second half of what is left of the part of
+ * another thread, which keeps the threads busy when some items take much
+ * longer than others.
+ */
+class thread_pool final {
+ public:
+  /**
+   * Start a pool that runs work on the given number of threads, counting the
+   * thread that calls parallel_for. By default, one thread per core.
+   */
+  explicit thread_pool(size_t threads = std::thread::hardware_concurrency());
+  ~thread_pool();
+
+  thread_pool(const thread_pool &) = delete;
+  thread_pool &operator=(const thread_pool &) = delete;
+
+  /**
+   * The number of threads that run work, including the calling thread.
+   */
+  size_t size() const {
+    return _workers.size() + 1;
+  }
+
+  /**
+   * Call fn(begin, end) for ranges of indices that together cover [0, count)
+   * exactly once, on the threads of the pool and the calling thread, and
+   * return when all calls have returned. fn must not throw. Calls from several
+   * threads at once run one at a time.
+   */
+  void parallel_for(size_t count, const std::function<void (size_t begin, size_t end)> &fn);
+
+ private:
+  struct part;
+
+  void work(size_t self);
+  bool run_one(size_t self);
+  void run_worker(size_t self);
+
+  std::vector<std::thread> _workers;
+  std::unique_ptr<part[]> _parts;
+
+  std::mutex _run_mutex;  // Held by the thread in parallel_for
+
+  std::mutex _mutex;
+  std::condition_variable _work_changed;
+  std::condition_variable _done_changed;
+  const std::function<void (size_t, size_t)> *_fn = nullptr;
+  size_t _grain = 1;
+  size_t _generation = 0;
+  size_t _busy_workers = 0;
+  bool _is_stopping = false;
+};
+
+}  // namespace json
+}  // namespace spotify
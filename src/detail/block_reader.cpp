@@ -0,0 +1,233 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <spotify/json/detail/block_reader.hpp>
+
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <system_error>
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+#include <spotify/json/detail/macros.hpp>
+
+namespace spotify {
+namespace json {
+namespace detail {
+namespace {
+
+int open_for_reading(const std::string &path) {
+#if defined(_WIN32)
+  const auto fd = ::_open(path.c_str(), _O_RDONLY | _O_BINARY);
+#else
+  const auto fd = ::open(path.c_str(), O_RDONLY);
+#endif
+  if (fd < 0) {
+    json_throw(std::system_error(errno, std::generic_category(), "Could not open " + path));
+  }
+  return fd;
+}
+
+void close_fd(const int fd) {
+#if defined(_WIN32)
+  ::_close(fd);
+#else
+  ::close(fd);
+#endif
+}
+
+bool is_regular_file(const int fd) {
+#if defined(_WIN32)
+  (void)fd;
+  return true;  // Nothing else is supported there
+#else
+  struct stat status;
+  return (::fstat(fd, &status) == 0 && S_ISREG(status.st_mode));
+#endif
+}
+
+/**
+ * Read a block. If fill is true, reads until the buffer is full or the file
+ * ends. Otherwise, which is for pipes and sockets, returns as soon as there is
+ * any data, so that records are not held back until a slow writer has filled
+ * the whole block. Stops early when wake_fd becomes readable. Returns -1 on
+ * failure.
+ */
+ptrdiff_t read_block(const int fd, const int wake_fd, const bool fill, char *buffer, const size_t size) {
+  size_t filled = 0;
+  while (filled < size && (fill || filled == 0)) {
+#if defined(_WIN32)
+    (void)wake_fd;
+    const auto n = ::_read(fd, buffer + filled, static_cast<unsigned>(size - filled));
+#else
+    pollfd fds[2] = { { fd, POLLIN, 0 }, { wake_fd, POLLIN, 0 } };
+    if (::poll(fds, 2, -1) < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return -1;
+    } else if (fds[1].revents) {
+      break;
+    }
+    const auto n = ::read(fd, buffer + filled, size - filled);
+#endif
+    if (n == 0) {
+      break;
+    } else if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return -1;
+    }
+    filled += n;
+  }
+  return static_cast<ptrdiff_t>(filled);
+}
+
+}  // namespace
+
+block_reader::block_reader(
+    const int fd,
+    const bool owns_fd,
+    const size_t block_size,
+    const size_t block_count)
+    : _fd(fd),
+      _owns_fd(owns_fd),
+      _block_size(block_size),
+      _blocks(block_count < 2 ? 2 : block_count) {
+  // The destructor is not run if starting fails, so close the fds here then.
+  struct fd_closer {
+    block_reader *reader;
+    ~fd_closer() {
+      if (reader) {
+        reader->close_fds();
+      }
+    }
+  } closer = { this };
+  start();
+  closer.reader = nullptr;
+}
+
+block_reader::block_reader(
+    const std::string &path,
+    const size_t block_size,
+    const size_t block_count)
+    : block_reader(open_for_reading(path), true, block_size, block_count) {}
+
+block_reader::~block_reader() {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _is_stopping = true;
+  }
+  _free_changed.notify_one();
+#if !defined(_WIN32)
+  const char wake = 0;
+  while (::write(_wake_fds[1], &wake, 1) < 0 && errno == EINTR) {}
+#endif
+  _thread.join();
+  close_fds();
+}
+
+json::string_view block_reader::next() {
+  std::unique_lock<std::mutex> lock(_mutex);
+  if (_current) {
+    _free.push_back(_current);
+    _current = nullptr;
+    _free_changed.notify_one();
+  }
+
+  _filled_changed.wait(lock, [this] { return !_filled.empty(); });
+  const auto filled = _filled.front();
+  if (filled->size == 0) {
+    // The end of the file stays at the front, for any later calls.
+    if (_error) {
+      json_throw(std::system_error(_error, std::generic_category(), "Could not read file"));
+    }
+    return json::string_view();
+  }
+
+  _filled.pop_front();
+  _current = filled;
+  return json::string_view(filled->data.get(), filled->size);
+}
+
+void block_reader::start() {
+#if !defined(_WIN32)
+  if (::pipe(_wake_fds) != 0) {
+    json_throw(std::system_error(errno, std::generic_category(), "Could not create pipe"));
+  }
+#endif
+  _is_regular_file = is_regular_file(_fd);
+#if !defined(_WIN32) && defined(POSIX_FADV_SEQUENTIAL)
+  ::posix_fadvise(_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+  for (auto &block : _blocks) {
+    block.data.reset(new char[_block_size]);
+    block.size = 0;
+    _free.push_back(&block);
+  }
+  _thread = std::thread([this] { read_ahead(); });
+}
+
+void block_reader::read_ahead() {
+  for (;;) {
+    block *free;
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _free_changed.wait(lock, [this] { return _is_stopping || !_free.empty(); });
+      if (_is_stopping) {
+        return;
+      }
+      free = _free.front();
+      _free.pop_front();
+    }
+
+    const auto size = read_block(_fd, _wake_fds[0], _is_regular_file, free->data.get(), _block_size);
+    const auto error = (size < 0 ? errno : 0);
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      free->size = (size < 0 ? 0 : static_cast<size_t>(size));
+      _error = error;
+      _filled.push_back(free);
+    }
+    _filled_changed.notify_one();
+
+    if (size <= 0) {
+      return;
+    }
+  }
+}
+
+void block_reader::close_fds() {
+  for (const auto fd : _wake_fds) {
+    if (fd >= 0) {
+      close_fd(fd);
+    }
+  }
+  if (_owns_fd) {
+    close_fd(_fd);
+  }
+}
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <spotify/json/detail/chunk_scanner.hpp>
+
+#include <spotify/json/detail/kernels.hpp>
+#include <spotify/json/detail/macros.hpp>
+
+namespace spotify {
+namespace json {
+namespace detail {
+namespace {
+
+json_force_inline bool is_separator(const char c) {
+  switch (c) {
+    case ' ': case '\t': case '\n': case '\r':
+    case '{': case '}': case '[': case ']': case ':': case ',': case '"':
+      return true;
+    default:
+      return false;
+  }
+}
+
+const char *scan_string(container_state &state, const char *begin, const char *end) {
+  for (auto position = begin; position != end; position++) {
+    if (state.escape_next) {
+      state.escape_next = false;
+    } else if (*position == '\\') {
+      state.escape_next = true;
+    } else if (*position == '"') {
+      return position + 1;
+    }
+  }
+  return nullptr;
+}
+
+const char *scan_scalar(const char *begin, const char *end) {
+  for (auto position = begin; position != end; position++) {
+    if (is_separator(*position)) {
+      return position;
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace
+
+const char *chunk_scanner::scan(const char *begin, const char *end) {
+  if (json_unlikely(begin == end)) {
+    return nullptr;
+  }
+
+  if (_kind == kind::unknown) {
+    switch (*begin) {
+      case '{': case '[': _kind = kind::container; break;
+      case '"': _kind = kind::string; begin++; break;
+      default: _kind = kind::scalar; begin++; break;  // A lone } or ] is a scalar too
+    }
+  }
+
+  switch (_kind) {
+    case kind::container: return get_kernels().skip_container(_state, begin, end);
+    case kind::string: return scan_string(_state, begin, end);
+    default: return scan_scalar(begin, end);
+  }
+}
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
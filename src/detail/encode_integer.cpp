@@ -16,139 +16,87 @@
 
 #include <spotify/json/detail/encode_integer.hpp>
 
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#include "integer_common.hpp"
+
 namespace spotify {
 namespace json {
 namespace detail {
 namespace {
 
-template <typename T, int num_digits>
-struct negative final {
-  json_force_inline static void encode(encode_context &context, T value) {
-    constexpr auto num_bytes = num_digits + 1;  // + 1 for the '-' sign character
-    const auto p = context.reserve(num_bytes);
-    p[0] = '-';
-    for (int i = num_digits; i >= 1; i--) {
-      const auto v = value;
-      value /= 10;
-      p[i] = ('0' + static_cast<uint8_t>(value * 10 - v));
-    }
-    context.advance(num_bytes);
+/**
+ * Write the magnitude, with a '-' in front of it if is_negative is true. The
+ * '-' is always written, and is overwritten by the first digit when it should
+ * not be there, so there is no branch on the sign. The digits are written two
+ * at a time (see write_digits) after counting them (see decimal_length).
+ *
+ * Most integers are small, and counting their digits costs more than writing
+ * them, so magnitudes below 1000 are written without counting. Below 100, two
+ * bytes are copied from two_digits, starting at the second digit for a single
+ * digit value, and only the digits are kept when advancing.
+ */
+template <typename T>
+json_force_inline void encode_magnitude(encode_context &context, const T magnitude, const bool is_negative) {
+  constexpr auto max_bytes = 1 + std::numeric_limits<T>::digits10 + 1;
+  const auto p = context.reserve(max_bytes);
+  p[0] = '-';
+  if (magnitude < 100) {
+    const auto is_single_digit = (magnitude < 10);
+    std::memcpy(p + is_negative, two_digits(static_cast<uint32_t>(magnitude)) + is_single_digit, 2);
+    context.advance(2 - is_single_digit + is_negative);
+    return;
   }
-};
-
-template <typename T, int num_digits>
-struct positive final {
-  json_force_inline static void encode(encode_context &context, T value) {
-    constexpr auto num_bytes = num_digits;
-    const auto p = context.reserve(num_bytes);
-    for (int i = num_digits - 1; i >= 0; i--) {
-      const auto v = value;
-      value /= 10;
-      p[i] = ('0' + static_cast<uint8_t>(v - value * 10));
-    }
-    context.advance(num_bytes);
+  if (magnitude < 1000) {
+    const auto m = static_cast<uint32_t>(magnitude);
+    p[is_negative] = static_cast<char>('0' + m / 100);
+    std::memcpy(p + is_negative + 1, two_digits(m % 100), 2);
+    context.advance(3 + is_negative);
+    return;
   }
-};
+
+  const auto num_digits = decimal_length(magnitude);
+  write_digits(p + is_negative, magnitude, num_digits);
+  context.advance(num_digits + is_negative);
+}
+
+/**
+ * The magnitude of value, computed without a branch. This works for the most
+ * negative value too, since the arithmetic is done on the unsigned type.
+ */
+template <typename T>
+json_force_inline typename std::make_unsigned<T>::type magnitude_of(const T value) {
+  using unsigned_type = typename std::make_unsigned<T>::type;
+  const auto mask = unsigned_type(0) - static_cast<unsigned_type>(value < 0);
+  return (static_cast<unsigned_type>(value) ^ mask) - mask;
+}
 
 }  // namespace
 
-void encode_negative_integer_32(encode_context &context, int32_t value) {
-  #define ENCODE(bits, digits) do { \
-    using type = int_fast ## bits ## _t; \
-    return negative<type, digits>::encode(context, type(value)); \
-  } while (false)
-  #define CUTOFF(bits, digits, cutoff) if (value > cutoff ## LL) ENCODE(bits, digits);
-  CUTOFF(32,  1, -10);
-  CUTOFF(32,  2, -100);
-  CUTOFF(32,  3, -1000);
-  CUTOFF(32,  4, -10000);
-  CUTOFF(32,  5, -100000);
-  CUTOFF(32,  6, -1000000);
-  CUTOFF(32,  7, -10000000);
-  CUTOFF(32,  8, -100000000);
-  CUTOFF(32,  9, -1000000000);
-  ENCODE(32, 10);
-  #undef CUTOFF
-  #undef ENCODE
+void encode_negative_integer_32(encode_context &context, const int32_t value) {
+  encode_magnitude(context, magnitude_of(value), true);
+}
+
+void encode_negative_integer_64(encode_context &context, const int64_t value) {
+  encode_magnitude(context, magnitude_of(value), true);
+}
+
+void encode_positive_integer_32(encode_context &context, const uint32_t value) {
+  encode_magnitude(context, value, false);
 }
 
-void encode_negative_integer_64(encode_context &context, int64_t value) {
-  #define ENCODE(bits, digits) do { \
-    using type = int_fast ## bits ## _t; \
-    return negative<type, digits>::encode(context, type(value)); \
-  } while (false)
-  #define CUTOFF(bits, digits, cutoff) if (value > cutoff ## LL) ENCODE(bits, digits);
-  CUTOFF(32,  1, -10);
-  CUTOFF(32,  2, -100);
-  CUTOFF(32,  3, -1000);
-  CUTOFF(32,  4, -10000);
-  CUTOFF(32,  5, -100000);
-  CUTOFF(32,  6, -1000000);
-  CUTOFF(32,  7, -10000000);
-  CUTOFF(32,  8, -100000000);
-  CUTOFF(32,  9, -1000000000);
-  CUTOFF(64, 10, -10000000000);
-  CUTOFF(64, 11, -100000000000);
-  CUTOFF(64, 12, -1000000000000);
-  CUTOFF(64, 13, -10000000000000);
-  CUTOFF(64, 14, -100000000000000);
-  CUTOFF(64, 15, -1000000000000000);
-  CUTOFF(64, 16, -10000000000000000);
-  CUTOFF(64, 17, -100000000000000000);
-  CUTOFF(64, 18, -1000000000000000000);
-  ENCODE(64, 19);
-  #undef CUTOFF
-  #undef ENCODE
+void encode_positive_integer_64(encode_context &context, const uint64_t value) {
+  encode_magnitude(context, value, false);
 }
 
-void encode_positive_integer_32(encode_context &context, uint32_t value) {
-  #define ENCODE(bits, digits) do { \
-    using type = uint_fast ## bits ## _t; \
-    return positive<type, digits>::encode(context, type(value)); \
-  } while (false)
-  #define CUTOFF(bits, digits, cutoff) if (value < cutoff ## UL) ENCODE(bits, digits);
-  CUTOFF(32,  1, 10);
-  CUTOFF(32,  2, 100);
-  CUTOFF(32,  3, 1000);
-  CUTOFF(32,  4, 10000);
-  CUTOFF(32,  5, 100000);
-  CUTOFF(32,  6, 1000000);
-  CUTOFF(32,  7, 10000000);
-  CUTOFF(32,  8, 100000000);
-  CUTOFF(32,  9, 1000000000);
-  ENCODE(32, 10);
-  #undef CUTOFF
-  #undef ENCODE
+void encode_signed_integer_32(encode_context &context, const int32_t value) {
+  encode_magnitude(context, magnitude_of(value), value < 0);
 }
 
-void encode_positive_integer_64(encode_context &context, uint64_t value) {
-  #define ENCODE(bits, digits) do { \
-    using type = uint_fast ## bits ## _t; \
-    return positive<type, digits>::encode(context, type(value)); \
-  } while (false)
-  #define CUTOFF(bits, digits, cutoff) if (value < cutoff ## ULL) ENCODE(bits, digits);
-  CUTOFF(32,  1, 10);
-  CUTOFF(32,  2, 100);
-  CUTOFF(32,  3, 1000);
-  CUTOFF(32,  4, 10000);
-  CUTOFF(32,  5, 100000);
-  CUTOFF(32,  6, 1000000);
-  CUTOFF(32,  7, 10000000);
-  CUTOFF(32,  8, 100000000);
-  CUTOFF(32,  9, 1000000000);
-  CUTOFF(64, 10, 10000000000);
-  CUTOFF(64, 11, 100000000000);
-  CUTOFF(64, 12, 1000000000000);
-  CUTOFF(64, 13, 10000000000000);
-  CUTOFF(64, 14, 100000000000000);
-  CUTOFF(64, 15, 1000000000000000);
-  CUTOFF(64, 16, 10000000000000000);
-  CUTOFF(64, 17, 100000000000000000);
-  CUTOFF(64, 18, 1000000000000000000);
-  CUTOFF(64, 19, 10000000000000000000);
-  ENCODE(64, 20);
-  #undef CUTOFF
-  #undef ENCODE
+void encode_signed_integer_64(encode_context &context, const int64_t value) {
+  encode_magnitude(context, magnitude_of(value), value < 0);
 }
 
 }  // namespace detail
@@ -16,7 +16,11 @@
 
 #include <spotify/json/detail/field_registry.hpp>
 
+#include <algorithm>
+#include <cstring>
+
 #include <spotify/json/codec/string.hpp>
+#include <spotify/json/detail/macros.hpp>
 #include <spotify/json/encode_context.hpp>
 
 namespace spotify {
@@ -29,30 +33,140 @@ std::string escape_key(const std::string &key) {
   context.append(':');
   return std::string(context.data(), context.size());
 }
+
+json_force_inline bool is_name_less(const std::string &a, const char *b, size_t b_size) {
+  // Names of different lengths are never in the same bucket, so this only has
+  // to order names of the same length.
+  return (a.size() != b_size ? a.size() < b_size : std::memcmp(a.data(), b, b_size) < 0);
+}
+
+size_t heap_size(const std::string &string) {
+  // Short strings are usually stored inside the string object itself.
+  const auto data = string.data();
+  const auto self = reinterpret_cast<const char *>(&string);
+  const auto is_inline = (data >= self && data < self + sizeof(string));
+  return (is_inline ? 0 : string.capacity() + 1);
+}
+
+template <typename T>
+size_t heap_size(const std::vector<T> &vector) {
+  return vector.capacity() * sizeof(T);
+}
 } // namespace
 
+struct field_registry::table {
+  std::vector<entry> entries;
+  std::vector<std::shared_ptr<const void>> fields;  // owns entry::field
+
+  // The names of all fields, sorted by length and then by content. The keys of
+  // length n are found in the range [key_buckets[n], key_buckets[n + 1]) so a
+  // lookup only compares the input against names of the right length.
+  std::vector<key_entry> keys;
+  std::vector<size_t> key_buckets;
+  size_t field_sizes = 0;
+
+  void rebuild_key_buckets() {
+    const auto max_size = keys.back().name.size();  // keys is sorted by length
+    key_buckets.assign(max_size + 2, 0);
+    for (const auto &key : keys) {
+      key_buckets[key.name.size() + 1]++;
+    }
+    for (size_t n = 1; n < key_buckets.size(); n++) {
+      key_buckets[n] += key_buckets[n - 1];
+    }
+  }
+};
+
 field_registry::field_registry() = default;
 field_registry::~field_registry() = default;
 field_registry::field_registry(const field_registry &) = default;
-field_registry::field_registry(field_registry &&) = default;
 
-void field_registry::save(const std::string &name, bool required,
-                          const std::shared_ptr<void> &f) {
-  const auto was_saved =
-      _fields.insert(typename field_map::value_type(name, f)).second;
-  if (was_saved) {
-    _field_list.push_back(std::make_pair(escape_key(name), f));
-    _num_required_fields += required ? 1 : 0;
+field_registry::field_registry(field_registry &&other) noexcept
+    : _table(std::move(other._table)),
+      _entries(other._entries),
+      _size(other._size),
+      _num_required_fields(other._num_required_fields) {
+  other._entries = nullptr;
+  other._size = 0;
+  other._num_required_fields = 0;
+}
+
+void field_registry::save(
+    const std::string &name,
+    bool required,
+    std::shared_ptr<const void> field,
+    size_t field_size,
+    decode_function decode,
+    decode_function decode_into,
+    reset_function reset,
+    encode_function encode) {
+  if (find(name)) {
+    return;
   }
+
+  auto &t = mutable_table();
+  const auto it = std::lower_bound(
+      t.keys.begin(), t.keys.end(), name, [](const key_entry &entry, const std::string &name) {
+        return is_name_less(entry.name, name.data(), name.size());
+      });
+  t.keys.insert(it, key_entry{ name, t.entries.size() });
+  t.rebuild_key_buckets();
+
+  const auto required_field_idx = (required ? _num_required_fields : json_size_t_max);
+  t.entries.push_back(entry{
+      escape_key(name), field.get(), decode, decode_into, reset, encode, required_field_idx });
+  t.fields.push_back(std::move(field));
+  t.field_sizes += field_size;
+
+  _entries = t.entries.data();
+  _size = t.entries.size();
+  _num_required_fields += (required ? 1 : 0);
 }
 
-const void *field_registry::find(const std::string &name) const noexcept {
-  const auto field_it = _fields.find(name);
-  if (json_likely(field_it != _fields.end())) {
-    return (*field_it).second.get();
+size_t field_registry::find_index(const char *name, size_t size) const noexcept {
+  if (json_unlikely(!_table || size + 1 >= _table->key_buckets.size())) {
+    return json_size_t_max;  // there are no fields with names this long
+  }
+
+  const auto &keys = _table->keys;
+  const auto first = keys.begin() + _table->key_buckets[size];
+  const auto last = keys.begin() + _table->key_buckets[size + 1];
+  const auto it = std::lower_bound(first, last, name, [=](const key_entry &entry, const char *name) {
+    return std::memcmp(entry.name.data(), name, size) < 0;
+  });
+
+  if (json_likely(it != last && std::memcmp(it->name.data(), name, size) == 0)) {
+    return it->index;
   } else {
-    return nullptr;
+    return json_size_t_max;
+  }
+}
+
+size_t field_registry::memory_footprint() const noexcept {
+  auto footprint = sizeof(*this);
+  if (!_table) {
+    return footprint;
+  }
+
+  const auto &t = *_table;
+  footprint += sizeof(t) + t.field_sizes;
+  footprint += heap_size(t.entries) + heap_size(t.fields) + heap_size(t.keys) + heap_size(t.key_buckets);
+  for (const auto &entry : t.entries) {
+    footprint += heap_size(entry.escaped_key);
+  }
+  for (const auto &key : t.keys) {
+    footprint += heap_size(key.name);
+  }
+  return footprint;
+}
+
+field_registry::table &field_registry::mutable_table() {
+  if (!_table) {
+    _table = std::make_shared<table>();
+  } else if (_table.use_count() > 1) {
+    _table = std::make_shared<table>(*_table);  // copy on write
   }
+  return *_table;
 }
 
 }  // namespace detail
@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif  // defined(_MSC_VER)
+
+#include <spotify/json/detail/macros.hpp>
+
+namespace spotify {
+namespace json {
+namespace detail {
+
+struct uint128 final {
+  uint64_t low;
+  uint64_t high;
+};
+
+/**
+ * The full 128-bit product of two 64-bit integers.
+ */
+json_force_inline uint128 multiply(const uint64_t a, const uint64_t b) {
+  uint128 product;
+#if defined(__SIZEOF_INT128__)
+  const auto full = static_cast<unsigned __int128>(a) * b;
+  product.low = static_cast<uint64_t>(full);
+  product.high = static_cast<uint64_t>(full >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+  product.low = _umul128(a, b, &product.high);
+#else
+  const auto a_low = static_cast<uint32_t>(a);
+  const auto a_high = a >> 32;
+  const auto b_low = static_cast<uint32_t>(b);
+  const auto b_high = b >> 32;
+  const auto low_low = uint64_t(a_low) * b_low;
+  const auto high_low = a_high * b_low;
+  const auto cross = (low_low >> 32) + static_cast<uint32_t>(high_low) + a_low * b_high;
+  product.high = (high_low >> 32) + (cross >> 32) + a_high * b_high;
+  product.low = (cross << 32) | static_cast<uint32_t>(low_low);
+#endif  // defined(__SIZEOF_INT128__)
+  return product;
+}
+
+/**
+ * The number of zero bits above the most significant set bit. The value must
+ * not be zero.
+ */
+json_force_inline int count_leading_zeros(const uint64_t value) {
+#if defined(_MSC_VER) && defined(_M_X64)
+  unsigned long index;
+  _BitScanReverse64(&index, value);
+  return 63 - static_cast<int>(index);
+#elif defined(_MSC_VER)
+  unsigned long index;
+  const auto high = static_cast<uint32_t>(value >> 32);
+  _BitScanReverse(&index, high ? high : static_cast<uint32_t>(value));
+  return (high ? 31 : 63) - static_cast<int>(index);
+#else
+  return __builtin_clzll(value);
+#endif  // defined(_MSC_VER)
+}
+
+/**
+ * The number of decimal digits in value, with one digit for zero. The number
+ * of bits in the value gives an estimate that is at most one digit too small.
+ */
+json_force_inline int decimal_length(const uint64_t value) {
+  static const uint64_t powers_of_10[] = {
+      1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL,
+      100000000ULL, 1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL,
+      10000000000000ULL, 100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+      100000000000000000ULL, 1000000000000000000ULL, 10000000000000000000ULL };
+  const auto num_bits = 64 - count_leading_zeros(value | 1);
+  const auto estimate = (num_bits * 1233) >> 12;  // 1233 / 4096 ~ log10(2)
+  return estimate + ((value | 1) >= powers_of_10[estimate]);
+}
+
+/**
+ * The two digits of a number below 100, so that digits can be written two at
+ * a time with half as many divisions.
+ */
+json_force_inline const char *two_digits(const uint32_t value) {
+  static const char digits[] =
+      "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+      "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+      "8081828384858687888990919293949596979899";
+  return digits + 2 * value;
+}
+
+/**
+ * Write exactly 8 digits, with leading zeros if needed. The two halves are
+ * independent, so the CPU can work on both at once.
+ */
+json_force_inline void write_8_digits(char *out, const uint32_t value) {
+  const auto high = value / 10000;
+  const auto low = value % 10000;
+  std::memcpy(out + 0, two_digits(high / 100), 2);
+  std::memcpy(out + 2, two_digits(high % 100), 2);
+  std::memcpy(out + 4, two_digits(low / 100), 2);
+  std::memcpy(out + 6, two_digits(low % 100), 2);
+}
+
+/**
+ * Write the digits of value, which must have exactly num_digits digits (see
+ * decimal_length), ending at out + num_digits. T is uint32_t or uint64_t.
+ */
+template <typename T>
+json_force_inline void write_digits(char *out, T value, const int num_digits) {
+  auto end = out + num_digits;
+  while (value >= 100000000) {
+    end -= 8;
+    write_8_digits(end, static_cast<uint32_t>(value % 100000000));
+    value /= 100000000;
+  }
+
+  auto rest = static_cast<uint32_t>(value);
+  for (; rest >= 100; rest /= 100) {
+    end -= 2;
+    std::memcpy(end, two_digits(rest % 100), 2);
+  }
+  if (rest >= 10) {
+    std::memcpy(end - 2, two_digits(rest), 2);
+  } else {
+    end[-1] = static_cast<char>('0' + rest);
+  }
+}
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
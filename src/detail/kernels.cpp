@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+
+#include <spotify/json/detail/kernels.hpp>
+
+#include <spotify/json/detail/cpuid.hpp>
+#include <spotify/json/detail/escape.hpp>
+#include <spotify/json/detail/macros.hpp>
+#include <spotify/json/detail/skip_chars.hpp>
+#include <spotify/json/detail/structural_index.hpp>
+
+namespace spotify {
+namespace json {
+namespace detail {
+namespace {
+
+void skip_any_simple_characters_unresolved(decode_context &context) {
+  resolve_kernels().skip_any_simple_characters(context);
+}
+
+void skip_any_whitespace_unresolved(decode_context &context) {
+  resolve_kernels().skip_any_whitespace(context);
+}
+
+void write_escaped_unresolved(encode_context &context, const char *begin, const char *end) {
+  resolve_kernels().write_escaped(context, begin, end);
+}
+
+uint32_t *find_structurals_unresolved(
+    structural_state &state,
+    const char *begin,
+    const char *end,
+    uint32_t *out,
+    uint32_t *out_end) {
+  return resolve_kernels().find_structurals(state, begin, end, out, out_end);
+}
+
+const char *skip_container_unresolved(container_state &state, const char *begin, const char *end) {
+  return resolve_kernels().skip_container(state, begin, end);
+}
+
+void summarize_chunk_unresolved(const char *begin, const char *end, bool escape_next, chunk_summary &summary) {
+  resolve_kernels().summarize_chunk(begin, end, escape_next, summary);
+}
+
+uint32_t *find_separators_unresolved(
+    separator_state &state,
+    const char *begin,
+    const char *end,
+    uint32_t *out,
+    uint32_t *out_end) {
+  return resolve_kernels().find_separators(state, begin, end, out, out_end);
+}
+
+const kernels unresolved_kernels = {
+    instruction_set::scalar,
+    &skip_any_simple_characters_unresolved,
+    &skip_any_whitespace_unresolved,
+    &write_escaped_unresolved,
+    &find_structurals_unresolved,
+    &skip_container_unresolved,
+    &summarize_chunk_unresolved,
+    &find_separators_unresolved };
+
+const kernels scalar_kernels = {
+    instruction_set::scalar,
+    &skip_any_simple_characters_scalar,
+    &skip_any_whitespace_scalar,
+    &write_escaped_scalar,
+    &find_structurals_scalar,
+    &skip_container_scalar,
+    &summarize_chunk_scalar,
+    &find_separators_scalar };
+
+#if defined(json_arch_x86_sse42)
+const kernels sse42_kernels = {
+    instruction_set::sse42,
+    &skip_any_simple_characters_sse42,
+    &skip_any_whitespace_sse42,
+    &write_escaped_sse42,
+    &find_structurals_sse42,
+    &skip_container_sse42,
+    &summarize_chunk_sse42,
+    &find_separators_sse42 };
+#endif  // defined(json_arch_x86_sse42)
+
+#if defined(json_arch_x86_sse42) && defined(json_arch_x86_avx2)
+const kernels avx2_kernels = {
+    instruction_set::avx2,
+    &skip_any_simple_characters_avx2,
+    &skip_any_whitespace_avx2,
+    &write_escaped_sse42,
+    &find_structurals_avx2,
+    &skip_container_avx2,
+    &summarize_chunk_avx2,
+    &find_separators_avx2 };
+#endif  // defined(json_arch_x86_sse42) && defined(json_arch_x86_avx2)
+
+#if defined(json_arch_x86_sse42) && defined(json_arch_x86_avx512)
+const kernels avx512bw_kernels = {
+    instruction_set::avx512bw,
+    &skip_any_simple_characters_avx512,
+    &skip_any_whitespace_avx512,
+    &write_escaped_sse42,
+    &find_structurals_avx512,
+    &skip_container_avx512,
+    &summarize_chunk_avx512,
+    &find_separators_avx512 };
+#endif  // defined(json_arch_x86_sse42) && defined(json_arch_x86_avx512)
+
+}  // namespace
+
+std::atomic<const kernels *> active_kernels(&unresolved_kernels);
+std::atomic<skip_function> active_whitespace_skipper(nullptr);
+
+const kernels *find_kernels(const instruction_set isa) {
+  const auto &cpu = cpuid::get();
+  switch (isa) {
+    case instruction_set::scalar:
+      return &scalar_kernels;
+#if defined(json_arch_x86_sse42)
+    case instruction_set::sse42:
+      return cpu.has_sse42() ? &sse42_kernels : nullptr;
+#endif  // defined(json_arch_x86_sse42)
+#if defined(json_arch_x86_sse42) && defined(json_arch_x86_avx2)
+    case instruction_set::avx2:
+      return cpu.has_sse42() && cpu.has_avx2() ? &avx2_kernels : nullptr;
+#endif  // defined(json_arch_x86_sse42) && defined(json_arch_x86_avx2)
+#if defined(json_arch_x86_sse42) && defined(json_arch_x86_avx512)
+    case instruction_set::avx512bw:
+      return cpu.has_sse42() && cpu.has_avx512bw() ? &avx512bw_kernels : nullptr;
+#endif  // defined(json_arch_x86_sse42) && defined(json_arch_x86_avx512)
+    default:
+      (void)cpu;
+      return nullptr;
+  }
+}
+
+const kernels &resolve_kernels() {
+  auto current = active_kernels.load();
+  if (json_likely(current != &unresolved_kernels)) {
+    return *current;
+  }
+
+  const kernels *widest = &scalar_kernels;
+  for (const auto isa : { instruction_set::sse42, instruction_set::avx2, instruction_set::avx512bw }) {
+    if (const auto candidate = find_kernels(isa)) {
+      widest = candidate;
+    }
+  }
+
+  // Kernels that were forced by another thread in the meantime are kept.
+  active_kernels.compare_exchange_strong(current, widest);
+  const auto &active = *active_kernels.load();
+  active_whitespace_skipper.store(active.skip_any_whitespace);
+  return active;
+}
+
+skip_function resolve_whitespace_skipper() {
+  return resolve_kernels().skip_any_whitespace;
+}
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <spotify/json/detail/nesting.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include <spotify/json/detail/kernels.hpp>
+#include <spotify/json/detail/macros.hpp>
+#include <spotify/json/detail/structural_index.hpp>
+
+namespace spotify {
+namespace json {
+namespace detail {
+namespace {
+
+/**
+ * find_too_deep_nesting for input that is too large for the 32 bit offsets of
+ * the structural kernels. The value starts at pos, with a '{' or '['.
+ */
+const char *find_too_deep_nesting_bytewise(const char *pos, const char *end, const size_t max_depth) {
+  size_t depth = 0;
+  for (; pos != end; ++pos) {
+    switch (*pos) {
+      case '"':
+        for (++pos; pos != end && *pos != '"'; ++pos) {
+          if (*pos == '\\' && ++pos == end) {
+            return end;
+          }
+        }
+        if (json_unlikely(pos == end)) {
+          return end;
+        }
+        break;
+      case '{':
+      case '[':
+        if (json_unlikely(++depth > max_depth)) {
+          return pos;
+        }
+        break;
+      case '}':
+      case ']':
+        if (--depth == 0) {
+          return end;  // The end of the value
+        }
+        break;
+      default:
+        break;
+    }
+  }
+
+  return end;
+}
+
+}  // namespace
+
+const char *find_too_deep_nesting(const char *begin, const char *end, const size_t max_depth) {
+  auto pos = begin;
+  while (pos != end && (*pos == ' ' || *pos == '\t' || *pos == '\n' || *pos == '\r')) {
+    ++pos;
+  }
+
+  // Other values than objects and arrays are not nested.
+  if (pos == end || (*pos != '{' && *pos != '[')) {
+    return end;
+  }
+
+  const auto size = static_cast<size_t>(end - pos);
+  if (static_cast<uint64_t>(size) >= std::numeric_limits<uint32_t>::max()) {
+    return find_too_deep_nesting_bytewise(pos, end, max_depth);
+  }
+
+  // The brackets outside strings are structural characters, so the kernel of
+  // stage 1 (see structural_index) finds them 64 bytes at a time, and only
+  // they are looked at here.
+  uint32_t offsets[1024];
+  structural_state state;
+  size_t depth = 0;
+  while (state.offset != size) {
+    const auto out = get_kernels().find_structurals(state, pos, end, offsets, offsets + 1024);
+    for (auto offset = offsets; offset != out; ++offset) {
+      switch (pos[*offset]) {
+        case '{':
+        case '[':
+          if (json_unlikely(++depth > max_depth)) {
+            return pos + *offset;
+          }
+          break;
+        case '}':
+        case ']':
+          if (--depth == 0) {
+            return end;  // The end of the value
+          }
+          break;
+        default:
+          break;
+      }
+    }
+  }
+
+  return end;
+}
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
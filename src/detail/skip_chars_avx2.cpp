@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+
+#include <spotify/json/detail/skip_chars.hpp>
+
+#if defined(json_arch_x86_avx2)
+
+#include <immintrin.h>
+
+#include "skip_chars_common.hpp"
+
+namespace spotify {
+namespace json {
+namespace detail {
+namespace {
+
+/**
+ * With padded input the chunk at the end of the input can be read in full, so
+ * there is no scalar loop for the last bytes. A match in the padding is the
+ * same as reaching the end.
+ */
+void skip_any_simple_characters_padded_avx2(decode_context &context) {
+  const auto end = context.end;
+  auto pos = context.position;
+
+  const auto quote = _mm256_set1_epi8('"');
+  const auto backslash = _mm256_set1_epi8('\\');
+
+  for (; pos < end; pos += 32) {
+    const auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pos));
+    const auto matches = _mm256_or_si256(
+        _mm256_cmpeq_epi8(chunk, quote),
+        _mm256_cmpeq_epi8(chunk, backslash));
+    const auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(matches));
+    if (mask != 0) {
+      pos += count_trailing_zeros(mask);
+      break;
+    }
+  }
+
+  context.position = (pos < end ? pos : end);
+}
+
+void skip_any_whitespace_padded_avx2(decode_context &context, const __m256i spaces) {
+  const auto end = context.end;
+  auto pos = context.position;
+
+  for (; pos < end; pos += 32) {
+    const auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pos));
+    const auto whitespace = _mm256_cmpeq_epi8(_mm256_shuffle_epi8(spaces, chunk), chunk);
+    const auto mask = ~static_cast<uint32_t>(_mm256_movemask_epi8(whitespace));
+    if (mask != 0) {
+      pos += count_trailing_zeros(mask);
+      break;
+    }
+  }
+
+  context.position = (pos < end ? pos : end);
+}
+
+}  // namespace
+
+void skip_any_simple_characters_avx2(decode_context &context) {
+  if (context.has_padded_input) {
+    return skip_any_simple_characters_padded_avx2(context);
+  }
+
+  const auto end = context.end;
+  auto pos = context.position;
+
+  const auto quote = _mm256_set1_epi8('"');
+  const auto backslash = _mm256_set1_epi8('\\');
+
+  for (; end - pos >= 32; pos += 32) {
+    const auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pos));
+    const auto matches = _mm256_or_si256(
+        _mm256_cmpeq_epi8(chunk, quote),
+        _mm256_cmpeq_epi8(chunk, backslash));
+    const auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(matches));
+    if (mask != 0) {
+      context.position = pos + count_trailing_zeros(mask);
+      return;
+    }
+  }
+
+          JSON_STRING_SKIP_N_SIMPLE(8, x, uint64_t, while, done_8)
+  done_8: JSON_STRING_SKIP_N_SIMPLE(4, x, uint32_t, while, done_4)
+  done_4: JSON_STRING_SKIP_N_SIMPLE(2, x, uint16_t, while, done_2)
+  done_2: JSON_STRING_SKIP_N_SIMPLE(1, x, uint8_t,  while, done_x)
+  done_x: context.position = pos;
+}
+
+void skip_any_whitespace_avx2(decode_context &context) {
+  const auto end = context.end;
+  auto pos = context.position;
+
+  // Most values are preceded by no or very little whitespace.
+  if (pos == end || !is_space(*pos)) {
+    return;
+  }
+
+  // Look up the low nibble of each byte; only the whitespace characters are
+  // equal to the table entry for their own low nibble. Bytes with the high bit
+  // set are looked up as zero, which they can never be equal to.
+  const auto spaces = _mm256_broadcastsi128_si256(_mm_setr_epi8(
+      ' ', 0, 0, 0, 0, 0, 0, 0, 0, '\t', '\n', 0, 0, '\r', 0, 0));
+
+  if (context.has_padded_input) {
+    return skip_any_whitespace_padded_avx2(context, spaces);
+  }
+
+  for (; end - pos >= 32; pos += 32) {
+    const auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pos));
+    const auto whitespace = _mm256_cmpeq_epi8(_mm256_shuffle_epi8(spaces, chunk), chunk);
+    const auto mask = ~static_cast<uint32_t>(_mm256_movemask_epi8(whitespace));
+    if (mask != 0) {
+      context.position = pos + count_trailing_zeros(mask);
+      return;
+    }
+  }
+
+  while (pos < end && is_space(*pos)) {
+    ++pos;
+  }
+
+  context.position = pos;
+}
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
+
+#endif  // defined(json_arch_x86_avx2)
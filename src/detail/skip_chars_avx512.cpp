@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+
+#include <spotify/json/detail/skip_chars.hpp>
+
+#if defined(json_arch_x86_avx512)
+
+#include <immintrin.h>
+
+#include "skip_chars_common.hpp"
+
+namespace spotify {
+namespace json {
+namespace detail {
+namespace {
+
+/**
+ * A mask of the first n bytes of a 64 byte chunk, for n < 64. The tail of the
+ * input is read with a masked load, which does not touch the bytes outside of
+ * the mask, so no scalar loop is needed for it.
+ */
+json_force_inline __mmask64 first_bytes_mask(const ptrdiff_t n) {
+  return (__mmask64(1) << n) - 1;
+}
+
+/**
+ * With padded input the chunk at the end of the input can be read in full,
+ * without a masked load. A match in the padding is the same as reaching the
+ * end.
+ */
+void skip_any_simple_characters_padded_avx512(decode_context &context) {
+  const auto end = context.end;
+  auto pos = context.position;
+
+  const auto quote = _mm512_set1_epi8('"');
+  const auto backslash = _mm512_set1_epi8('\\');
+
+  for (; pos < end; pos += 64) {
+    const auto chunk = _mm512_loadu_si512(pos);
+    const auto mask =
+        _mm512_cmpeq_epi8_mask(chunk, quote) |
+        _mm512_cmpeq_epi8_mask(chunk, backslash);
+    if (mask != 0) {
+      pos += count_trailing_zeros(uint64_t(mask));
+      break;
+    }
+  }
+
+  context.position = (pos < end ? pos : end);
+}
+
+void skip_any_whitespace_padded_avx512(decode_context &context, const __m512i spaces) {
+  const auto end = context.end;
+  auto pos = context.position;
+
+  for (; pos < end; pos += 64) {
+    const auto chunk = _mm512_loadu_si512(pos);
+    const auto mask = ~_mm512_cmpeq_epi8_mask(_mm512_shuffle_epi8(spaces, chunk), chunk);
+    if (mask != 0) {
+      pos += count_trailing_zeros(uint64_t(mask));
+      break;
+    }
+  }
+
+  context.position = (pos < end ? pos : end);
+}
+
+}  // namespace
+
+void skip_any_simple_characters_avx512(decode_context &context) {
+  if (context.has_padded_input) {
+    return skip_any_simple_characters_padded_avx512(context);
+  }
+
+  const auto end = context.end;
+  auto pos = context.position;
+
+  const auto quote = _mm512_set1_epi8('"');
+  const auto backslash = _mm512_set1_epi8('\\');
+
+  for (; end - pos >= 64; pos += 64) {
+    const auto chunk = _mm512_loadu_si512(pos);
+    const auto mask =
+        _mm512_cmpeq_epi8_mask(chunk, quote) |
+        _mm512_cmpeq_epi8_mask(chunk, backslash);
+    if (mask != 0) {
+      context.position = pos + count_trailing_zeros(uint64_t(mask));
+      return;
+    }
+  }
+
+  if (pos < end) {
+    const auto load_mask = first_bytes_mask(end - pos);
+    const auto chunk = _mm512_maskz_loadu_epi8(load_mask, pos);
+    const auto mask =
+        _mm512_mask_cmpeq_epi8_mask(load_mask, chunk, quote) |
+        _mm512_mask_cmpeq_epi8_mask(load_mask, chunk, backslash);
+    pos = mask ? pos + count_trailing_zeros(uint64_t(mask)) : end;
+  }
+
+  context.position = pos;
+}
+
+void skip_any_whitespace_avx512(decode_context &context) {
+  const auto end = context.end;
+  auto pos = context.position;
+
+  // Most values are preceded by no or very little whitespace.
+  if (pos == end || !is_space(*pos)) {
+    return;
+  }
+
+  // See skip_any_whitespace_avx2 for how the lookup table works.
+  const auto spaces = _mm512_set4_epi32(
+      0x00000D00, 0x000A0900, 0, 0x00000020);  // ' ' at 0, '\t' at 9, '\n' at 10, '\r' at 13
+
+  if (context.has_padded_input) {
+    return skip_any_whitespace_padded_avx512(context, spaces);
+  }
+
+  for (; end - pos >= 64; pos += 64) {
+    const auto chunk = _mm512_loadu_si512(pos);
+    const auto mask = ~_mm512_cmpeq_epi8_mask(_mm512_shuffle_epi8(spaces, chunk), chunk);
+    if (mask != 0) {
+      context.position = pos + count_trailing_zeros(uint64_t(mask));
+      return;
+    }
+  }
+
+  if (pos < end) {
+    const auto load_mask = first_bytes_mask(end - pos);
+    const auto chunk = _mm512_maskz_loadu_epi8(load_mask, pos);
+    const auto whitespace = _mm512_cmpeq_epi8_mask(_mm512_shuffle_epi8(spaces, chunk), chunk);
+    const auto mask = load_mask & ~whitespace;
+    pos = mask ? pos + count_trailing_zeros(uint64_t(mask)) : end;
+  }
+
+  context.position = pos;
+}
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
+
+#endif  // defined(json_arch_x86_avx512)
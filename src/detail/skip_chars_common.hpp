@@ -14,6 +14,12 @@
  * the License.
  */
 
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 #include <spotify/json/detail/macros.hpp>
 
 #define json_unaligned_x(ignore) true
@@ -34,6 +40,43 @@ json_force_inline bool is_space(const char c) {
   return (c == ' ' || c == '\t' || c == '\n' || c == '\r');
 }
 
+/**
+ * The index of the least significant set bit. Used to find the first matching
+ * byte in the masks produced by the vector comparisons. The value must not be
+ * zero.
+ */
+json_force_inline unsigned count_trailing_zeros(const uint32_t value) {
+#if defined(_MSC_VER)
+  unsigned long index;
+  _BitScanForward(&index, value);
+  return index;
+#else
+  return __builtin_ctz(value);
+#endif  // defined(_MSC_VER)
+}
+
+json_force_inline unsigned count_trailing_zeros(const uint64_t value) {
+#if defined(_MSC_VER)
+  const auto low = static_cast<uint32_t>(value);
+  return low ? count_trailing_zeros(low) : 32 + count_trailing_zeros(static_cast<uint32_t>(value >> 32));
+#else
+  return __builtin_ctzll(value);
+#endif  // defined(_MSC_VER)
+}
+
+/**
+ * The number of set bits.
+ */
+json_force_inline unsigned count_ones(const uint64_t value) {
+#if defined(_MSC_VER) && defined(_M_X64)
+  return static_cast<unsigned>(__popcnt64(value));
+#elif defined(_MSC_VER)
+  return __popcnt(static_cast<uint32_t>(value)) + __popcnt(static_cast<uint32_t>(value >> 32));
+#else
+  return __builtin_popcountll(value);
+#endif  // defined(_MSC_VER)
+}
+
 }  // namespace detail
 }  // namespace json
 }  // namespace spotify
@@ -25,8 +25,42 @@
 namespace spotify {
 namespace json {
 namespace detail {
+namespace {
+
+alignas(16) const char SIMPLE_CHARS_END[16] = "\"\\";
+alignas(16) const char WHITESPACE_CHARS[16] = " \t\n\r";
+
+/**
+ * With padded input the chunks can be read unaligned and the chunk at the end
+ * of the input can be read in full, so there is no scalar prologue or epilogue.
+ * A match in the padding is the same as reaching the end.
+ */
+template <int polarity>
+json_force_inline void skip_padded_sse42(decode_context &context, const char (&characters)[16], const int count) {
+  const auto end = context.end;
+  auto pos = context.position;
+  const auto chars = _mm_load_si128(reinterpret_cast<const __m128i *>(&characters[0]));
+
+  for (; pos < end; pos += 16) {
+    const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pos));
+    constexpr auto flags = _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY | polarity | _SIDD_LEAST_SIGNIFICANT;
+    const auto index = _mm_cmpestri(chars, count, chunk, 16, flags);
+    if (index != 16) {
+      pos += index;
+      break;
+    }
+  }
+
+  context.position = (pos < end ? pos : end);
+}
+
+}  // namespace
 
 void skip_any_simple_characters_sse42(decode_context &context) {
+  if (context.has_padded_input) {
+    return skip_padded_sse42<_SIDD_POSITIVE_POLARITY>(context, SIMPLE_CHARS_END, 2);
+  }
+
   const auto end = context.end;
   auto pos = context.position;
 
@@ -36,8 +70,7 @@ void skip_any_simple_characters_sse42(decode_context &context) {
   JSON_STRING_SKIP_N_SIMPLE(8, 16, uint64_t, if, done_8)
 
   {
-    alignas(16) static const char CHARS[16] = "\"\\";
-    const auto chars = _mm_load_si128(reinterpret_cast<const __m128i *>(&CHARS[0]));
+    const auto chars = _mm_load_si128(reinterpret_cast<const __m128i *>(&SIMPLE_CHARS_END[0]));
 
     for (; end - pos >= 16; pos += 16) {
       const auto chunk = _mm_load_si128(reinterpret_cast<const __m128i *>(pos));
@@ -58,6 +91,10 @@ void skip_any_simple_characters_sse42(decode_context &context) {
 }
 
 void skip_any_whitespace_sse42(decode_context &context) {
+  if (context.has_padded_input) {
+    return skip_padded_sse42<_SIDD_NEGATIVE_POLARITY>(context, WHITESPACE_CHARS, 4);
+  }
+
   const auto end = context.end;
   auto pos = context.position;
 
@@ -68,8 +105,7 @@ void skip_any_whitespace_sse42(decode_context &context) {
     }
   }
 
-  alignas(16) static const char CHARS[16] = " \t\n\r";
-  const auto chars = _mm_load_si128(reinterpret_cast<const __m128i *>(&CHARS[0]));
+  const auto chars = _mm_load_si128(reinterpret_cast<const __m128i *>(&WHITESPACE_CHARS[0]));
 
   for (; end - pos >= 16; pos += 16) {
     const auto chunk = _mm_load_si128(reinterpret_cast<const __m128i *>(pos));
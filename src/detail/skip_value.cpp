@@ -19,6 +19,7 @@
 #include <limits>
 
 #include <spotify/json/detail/decode_helpers.hpp>
+#include <spotify/json/detail/kernels.hpp>
 #include <spotify/json/detail/macros.hpp>
 #include <spotify/json/detail/stack.hpp>
 
@@ -35,13 +36,19 @@ json_force_inline bool is_hex_digit(const char c) {
   return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
 }
 
+/**
+ * Fails right after the first byte that is not a hex digit, like
+ * codec::string_t, so that the escape fails in the same place however much of
+ * the input after it has been seen (see chunked_decoder).
+ */
 void skip_unicode_escape(decode_context &context) {
-  require_bytes<4>(context, "\\u must be followed by 4 hex digits");
-  const bool h0 = is_hex_digit(*(context.position++));
-  const bool h1 = is_hex_digit(*(context.position++));
-  const bool h2 = is_hex_digit(*(context.position++));
-  const bool h3 = is_hex_digit(*(context.position++));
-  fail_if(context, !(h0 && h1 && h2 && h3), "\\u must be followed by 4 hex digits");
+  const auto begin = context.position;
+  for (auto i = 0; i < 4; i++) {
+    if (fail_if(context, context.position == context.end, "\\u must be followed by 4 hex digits", begin - context.position) ||
+        fail_if(context, !is_hex_digit(*(context.position++)), "\\u must be followed by 4 hex digits")) {
+      return;
+    }
+  }
 }
 
 void skip_escape(decode_context &context) {
@@ -62,12 +69,12 @@ void skip_escape(decode_context &context) {
 void skip_string(decode_context &context) {
   skip_1(context, '"');
 
-  while (json_likely(context.remaining())) {
+  while (json_likely(context.remaining() && !context.has_failed())) {
     detail::skip_any_simple_characters(context);
     switch (next(context, "Unterminated string")) {
       case '"': return;
       case '\\': skip_escape(context); break;
-      default: json_unreachable();
+      default: return;  // The input ended, so decoding has failed
     }
   }
 
@@ -84,14 +91,18 @@ void skip_number(decode_context &context) {
   if (peek(context) == '0') {
     ++context.position;
   } else {
-    fail_if(context, !is_digit(peek(context)), "Expected digit");
+    if (fail_if(context, !is_digit(peek(context)), "Expected digit")) {
+      return;
+    }
     do { ++context.position; } while (is_digit(peek(context)));
   }
 
   // Parse fractional part
   if (peek(context) == '.') {
     ++context.position;
-    fail_if(context, !is_digit(peek(context)), "Expected digit after decimal point");
+    if (fail_if(context, !is_digit(peek(context)), "Expected digit after decimal point")) {
+      return;
+    }
     do { ++context.position; } while (is_digit(peek(context)));
   }
 
@@ -104,7 +115,9 @@ void skip_number(decode_context &context) {
       ++context.position;
     }
 
-    fail_if(context, !is_digit(peek(context)), "Expected digit after exponent sign");
+    if (fail_if(context, !is_digit(peek(context)), "Expected digit after exponent sign")) {
+      return;
+    }
     do { ++context.position; } while (is_digit(peek(context)));
   }
 }
@@ -130,9 +143,31 @@ void skip_simple_value(decode_context &context) {
   }
 }
 
+/**
+ * Advance past the object or array at context.position by finding its closing
+ * bracket, without validating what is inside it. See decode_context's
+ * trusted_input.
+ */
+void skip_trusted_container(decode_context &context) {
+  const auto closer = (peek_unchecked(context) == '{' ? "Expected '}'" : "Expected ']'");
+  container_state state;
+  const auto end = get_kernels().skip_container(state, context.position, context.end);
+  if (json_unlikely(!end)) {
+    return fail(context, closer, context.remaining());
+  }
+  context.position = end;
+}
+
 }  // namespace
 
 void skip_value(decode_context &context) {
+  if (context.trusted_input) {
+    const auto c = peek(context);
+    if (c == '{' || c == '[') {
+      return skip_trusted_container(context);
+    }
+  }
+
   enum state {
     done = 0,
     want = 1 << 0,
@@ -158,7 +193,7 @@ void skip_value(decode_context &context) {
   auto closer = int_fast16_t(std::numeric_limits<int16_t>::max());  // a value outside the range of a 'char'
   auto pstate = need_val;
 
-  while (json_likely(context.remaining() && pstate != done)) {
+  while (json_likely(context.remaining() && pstate != done && !context.has_failed())) {
     if (json_likely(inside)) {
       skip_any_whitespace(context);
     }
@@ -187,10 +222,12 @@ void skip_value(decode_context &context) {
       continue;
     }
 
-    fail_if(context, pstate & read_key, "Expected '\"'");
-    fail_if(context, pstate & read_sep, inside == '{' ?
-        "Expected ',' or '}'" :
-        "Expected ',' or ']");
+    if (fail_if(context, pstate & read_key, "Expected '\"'") ||
+        fail_if(context, pstate & read_sep, inside == '{' ?
+            "Expected ',' or '}'" :
+            "Expected ',' or ']")) {
+      return;
+    }
 
     if (c == '{' || c == '[') {
       skip_unchecked_1(context);
@@ -205,6 +242,10 @@ void skip_value(decode_context &context) {
     pstate = (inside ? want_sep : done);
   }
 
+  if (json_unlikely(context.has_failed())) {
+    return;
+  }
+
   fail_if(context, inside == '{', "Expected '}'");
   fail_if(context, inside == '[', "Expected ']'");
   fail_if(context, pstate != done, "Unexpected EOF");
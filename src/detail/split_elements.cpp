@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <spotify/json/detail/split_elements.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <spotify/json/detail/kernels.hpp>
+#include <spotify/json/detail/structural_index.hpp>
+
+namespace spotify {
+namespace json {
+namespace detail {
+namespace {
+
+/**
+ * Whether the byte at position is escaped, which it is if it follows an odd
+ * number of backslashes. The backslashes are counted back to begin.
+ */
+bool is_escaped(const char *begin, const char *position) {
+  auto backslash = position;
+  while (backslash != begin && backslash[-1] == '\\') {
+    backslash--;
+  }
+  return ((position - backslash) & 1) != 0;
+}
+
+/**
+ * Find the separators of the chunk between begin and end with the kernel that
+ * is in use, growing offsets as it fills up.
+ */
+void find_all_separators(
+    const char *begin,
+    const char *end,
+    const container_state &container,
+    std::vector<uint32_t> &offsets) {
+  const auto size = static_cast<size_t>(end - begin);
+  offsets.resize(size / 16 + 64);
+  separator_state state(container);
+  size_t used = 0;
+  for (;;) {
+    const auto out = get_kernels().find_separators(
+        state, begin, end, offsets.data() + used, offsets.data() + offsets.size());
+    used = static_cast<size_t>(out - offsets.data());
+    if (state.offset == size) {
+      break;
+    }
+    offsets.resize(2 * offsets.size());
+  }
+  offsets.resize(used);
+}
+
+}  // namespace
+
+bool split_elements(
+    const char *begin,
+    const char *end,
+    size_t chunk_size,
+    thread_pool &pool,
+    std::vector<const char *> &separators) {
+  const auto size = static_cast<size_t>(end - begin);
+  const auto count = (size + chunk_size - 1) / chunk_size;
+  const auto chunk_begin = [=](const size_t i) { return begin + i * chunk_size; };
+  const auto chunk_end = [=](const size_t i) { return (i + 1 == count) ? end : begin + (i + 1) * chunk_size; };
+
+  std::vector<chunk_summary> summaries(count);
+  pool.parallel_for(count, [&](const size_t first, const size_t last) {
+    for (auto i = first; i < last; i++) {
+      const auto chunk = chunk_begin(i);
+      get_kernels().summarize_chunk(chunk, chunk_end(i), is_escaped(begin, chunk), summaries[i]);
+    }
+  });
+
+  // Follow the depth and string state from chunk to chunk. Chunks that start
+  // after the container has been closed are not searched.
+  std::vector<container_state> states;
+  int64_t depth = 1;
+  bool in_string = false;
+  for (size_t i = 0; i < count && depth > 0; i++) {
+    container_state state;
+    state.depth = static_cast<uint64_t>(depth);
+    state.in_string = in_string;
+    state.escape_next = is_escaped(begin, chunk_begin(i));
+    states.push_back(state);
+
+    depth += summaries[i].depth_change[in_string ? 1 : 0];
+    in_string ^= summaries[i].flips_string;
+  }
+
+  std::vector<std::vector<uint32_t>> offsets(states.size());
+  pool.parallel_for(states.size(), [&](const size_t first, const size_t last) {
+    for (auto i = first; i < last; i++) {
+      find_all_separators(chunk_begin(i), chunk_end(i), states[i], offsets[i]);
+    }
+  });
+
+  separators.clear();
+  for (size_t i = 0; i < offsets.size(); i++) {
+    for (const auto offset : offsets[i]) {
+      const auto separator = chunk_begin(i) + offset;
+      separators.push_back(separator);
+      if (*separator != ',') {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
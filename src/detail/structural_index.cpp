@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+
+#include <spotify/json/detail/structural_index.hpp>
+
+#include <limits>
+#include <vector>
+
+#include <spotify/json/detail/kernels.hpp>
+
+#include "structural_index_common.hpp"
+
+namespace spotify {
+namespace json {
+namespace detail {
+namespace {
+
+json_force_inline block_masks classify_scalar(const char *block) {
+  block_masks masks = { 0, 0, 0, 0, 0, 0 };
+  for (unsigned i = 0; i < 64; i++) {
+    const uint64_t bit = uint64_t(1) << i;
+    switch (block[i]) {
+      case '\\': masks.backslash |= bit; break;
+      case '"': masks.quote |= bit; break;
+      case ' ': case '\t': case '\n': case '\r': masks.whitespace |= bit; break;
+      case '{': case '[': masks.operators |= bit; masks.opening |= bit; break;
+      case '}': case ']': masks.operators |= bit; masks.closing |= bit; break;
+      case ':': case ',': masks.operators |= bit; break;
+    }
+  }
+  return masks;
+}
+
+/**
+ * Find the structural characters of the input with the kernel that is in use,
+ * growing offsets as it fills up.
+ */
+void find_all_structurals(const char *begin, const char *end, std::vector<uint32_t> &offsets) {
+  // There can be one structural character per byte, but real documents have
+  // far fewer, so the offsets start out at a guess and grow as needed. This
+  // keeps the index at a few bytes per token instead of four per input byte.
+  const auto size = static_cast<size_t>(end - begin);
+  offsets.resize(size / 8 + 64);
+  structural_state state;
+  size_t used = 0;
+  for (;;) {
+    const auto out = get_kernels().find_structurals(
+        state, begin, end, offsets.data() + used, offsets.data() + offsets.size());
+    used = static_cast<size_t>(out - offsets.data());
+    if (state.offset == size) {
+      break;
+    }
+    offsets.resize(2 * offsets.size());
+  }
+
+  // Growing leaves at most twice the needed room, but the first guess can be
+  // much too large for sparse input. Copying the offsets is then cheap. This
+  // is not done with shrink_to_fit, which does nothing without exceptions.
+  if (offsets.capacity() > 2 * used + 128) {
+    std::vector<uint32_t>(offsets.data(), offsets.data() + used).swap(offsets);
+  } else {
+    offsets.resize(used);
+  }
+}
+
+}  // namespace
+
+uint32_t *find_structurals_scalar(
+    structural_state &state,
+    const char *begin,
+    const char *end,
+    uint32_t *out,
+    uint32_t *out_end) {
+  return find_structurals<classify_scalar>(state, begin, end, out, out_end);
+}
+
+const char *skip_container_scalar(container_state &state, const char *begin, const char *end) {
+  return skip_container<classify_scalar>(state, begin, end);
+}
+
+void summarize_chunk_scalar(const char *begin, const char *end, const bool escape_next, chunk_summary &summary) {
+  summarize_chunk<classify_scalar>(begin, end, escape_next, summary);
+}
+
+uint32_t *find_separators_scalar(
+    separator_state &state,
+    const char *begin,
+    const char *end,
+    uint32_t *out,
+    uint32_t *out_end) {
+  return find_separators<classify_scalar>(state, begin, end, out, out_end);
+}
+
+structural_index::structural_index(const char *begin, const char *end) {
+  if (static_cast<uint64_t>(end - begin) < std::numeric_limits<uint32_t>::max()) {
+    find_all_structurals(begin, end, _offsets);
+  }
+}
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+
+#include <spotify/json/detail/structural_index.hpp>
+
+#if defined(json_arch_x86_avx512)
+
+#include <immintrin.h>
+
+#include "structural_index_common.hpp"
+
+namespace spotify {
+namespace json {
+namespace detail {
+namespace {
+
+json_force_inline block_masks classify_avx512(const char *block) {
+  const auto chunk = _mm512_loadu_si512(block);
+  const auto spaces = _mm512_set4_epi32(
+      0x00000D00, 0x000A0900, 0, 0x00000020);  // ' ' at 0, '\t' at 9, '\n' at 10, '\r' at 13
+
+  // Setting bit 5 turns [ and ] into { and }, and leaves , and : unchanged.
+  const auto lower = _mm512_or_si512(chunk, _mm512_set1_epi8(0x20));
+
+  block_masks masks;
+  masks.backslash = _mm512_cmpeq_epi8_mask(chunk, _mm512_set1_epi8('\\'));
+  masks.quote = _mm512_cmpeq_epi8_mask(chunk, _mm512_set1_epi8('"'));
+  masks.whitespace = _mm512_cmpeq_epi8_mask(_mm512_shuffle_epi8(spaces, chunk), chunk);
+  masks.opening = _mm512_cmpeq_epi8_mask(lower, _mm512_set1_epi8('{'));
+  masks.closing = _mm512_cmpeq_epi8_mask(lower, _mm512_set1_epi8('}'));
+  masks.operators =
+      masks.opening |
+      masks.closing |
+      _mm512_cmpeq_epi8_mask(chunk, _mm512_set1_epi8(',')) |
+      _mm512_cmpeq_epi8_mask(chunk, _mm512_set1_epi8(':'));
+  return masks;
+}
+
+}  // namespace
+
+uint32_t *find_structurals_avx512(
+    structural_state &state,
+    const char *begin,
+    const char *end,
+    uint32_t *out,
+    uint32_t *out_end) {
+  return find_structurals<classify_avx512>(state, begin, end, out, out_end);
+}
+
+const char *skip_container_avx512(container_state &state, const char *begin, const char *end) {
+  return skip_container<classify_avx512>(state, begin, end);
+}
+
+void summarize_chunk_avx512(const char *begin, const char *end, const bool escape_next, chunk_summary &summary) {
+  summarize_chunk<classify_avx512>(begin, end, escape_next, summary);
+}
+
+uint32_t *find_separators_avx512(
+    separator_state &state,
+    const char *begin,
+    const char *end,
+    uint32_t *out,
+    uint32_t *out_end) {
+  return find_separators<classify_avx512>(state, begin, end, out, out_end);
+}
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
+
+#endif  // defined(json_arch_x86_avx512)
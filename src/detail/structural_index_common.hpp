@@ -0,0 +1,384 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <spotify/json/detail/macros.hpp>
+#include <spotify/json/detail/structural_index.hpp>
+
+#include "skip_chars_common.hpp"
+
+namespace spotify {
+namespace json {
+namespace detail {
+
+/**
+ * Bit i of each mask is set if byte i of a 64 byte block is of that class.
+ */
+struct block_masks final {
+  uint64_t backslash;
+  uint64_t quote;
+  uint64_t whitespace;
+  uint64_t operators;  // { } [ ] : ,
+  uint64_t opening;  // { [
+  uint64_t closing;  // } ]
+};
+
+/**
+ * Finds which bytes of each block are inside strings, carrying the state that
+ * crosses block boundaries (an escaping backslash at the end of a block and
+ * whether the block ends inside a string) from one block to the next.
+ */
+class string_scanner final {
+ public:
+  string_scanner() = default;
+
+  string_scanner(const bool in_string, const bool escape_next)
+      : _escape_next(escape_next),
+        _in_string(in_string ? ~uint64_t(0) : 0) {}
+
+  /**
+   * Bit i of the result is set if byte i is inside a string, counting the
+   * opening quote but not the closing one. The quotes that are not escaped
+   * are stored in quotes.
+   */
+  json_force_inline uint64_t scan(const block_masks &masks, uint64_t &quotes) {
+    quotes = masks.quote & ~find_escaped(masks.backslash);
+
+    // The prefix XOR of the quotes.
+    auto in_string = quotes;
+    in_string ^= in_string << 1;
+    in_string ^= in_string << 2;
+    in_string ^= in_string << 4;
+    in_string ^= in_string << 8;
+    in_string ^= in_string << 16;
+    in_string ^= in_string << 32;
+    in_string ^= _in_string;
+    _in_string = uint64_t(0) - (in_string >> 63);
+    return in_string;
+  }
+
+  bool in_string() const {
+    return _in_string != 0;
+  }
+
+  bool escape_next() const {
+    return _escape_next != 0;
+  }
+
+ private:
+  /**
+   * The bytes that are escaped by a backslash. Backslashes are rare outside of
+   * some strings, so they are dealt with one at a time.
+   */
+  json_force_inline uint64_t find_escaped(uint64_t backslashes) {
+    if (json_likely(!backslashes && !_escape_next)) {
+      return 0;
+    }
+
+    uint64_t escaped = _escape_next;
+    backslashes &= ~escaped;
+    _escape_next = 0;
+    while (backslashes) {
+      const auto bit = backslashes & (uint64_t(0) - backslashes);
+      if (bit == (uint64_t(1) << 63)) {
+        _escape_next = 1;
+        break;
+      }
+      escaped |= bit << 1;
+      backslashes &= ~(bit | (bit << 1));
+    }
+    return escaped;
+  }
+
+  uint64_t _escape_next = 0;
+  uint64_t _in_string = 0;
+};
+
+/**
+ * The part of stage 1 that does not depend on the instruction set. It turns
+ * the character classes of each block into the offsets of the structural
+ * characters, carrying the state that crosses block boundaries (see
+ * string_scanner, and whether the next block starts a new value) from one
+ * block to the next.
+ */
+class structural_scanner final {
+ public:
+  structural_scanner(const structural_state &state, uint32_t *out)
+      : _out(out),
+        _strings(state.in_string, state.escape_next),
+        _follows_separator(state.follows_separator ? 1 : 0) {}
+
+  json_force_inline void scan(const block_masks &masks, const uint32_t offset) {
+    uint64_t quotes;
+    const auto in_string = _strings.scan(masks, quotes);
+
+    // A value other than a string starts at a byte that is not whitespace, an
+    // operator or a quote, and that follows whitespace or an operator.
+    const auto separators = masks.whitespace | masks.operators;
+    const auto follows_separator = (separators << 1) | _follows_separator;
+    _follows_separator = separators >> 63;
+    const auto scalars = ~(separators | masks.quote) & follows_separator;
+
+    auto structurals =
+        ((masks.operators | scalars) & ~in_string) |
+        (quotes & in_string);
+    while (structurals) {
+      *_out++ = offset + count_trailing_zeros(structurals);
+      structurals &= structurals - 1;
+    }
+  }
+
+  uint32_t *out() const {
+    return _out;
+  }
+
+  void save(structural_state &state) const {
+    state.in_string = _strings.in_string();
+    state.escape_next = _strings.escape_next();
+    state.follows_separator = (_follows_separator != 0);
+  }
+
+ private:
+  uint32_t *_out;
+  string_scanner _strings;
+  uint64_t _follows_separator = 1;
+};
+
+/**
+ * Run stage 1 over the input with the given function for finding the character
+ * classes of a 64 byte block, starting at state.offset. The last block is
+ * padded with whitespace. A block has at most 64 structural characters, so the
+ * scan stops before a block when there are fewer than 64 slots left before
+ * out_end, and state is then where to continue. Returns the end of the offsets
+ * that were written. The input has been scanned when state.offset is its size.
+ */
+template <block_masks (*classify)(const char *block)>
+json_force_inline uint32_t *find_structurals(
+    structural_state &state,
+    const char *begin,
+    const char *end,
+    uint32_t *out,
+    uint32_t *out_end) {
+  const auto size = static_cast<size_t>(end - begin);
+  structural_scanner scanner(state, out);
+  auto offset = state.offset;
+  for (; size - offset >= 64 && out_end - scanner.out() >= 64; offset += 64) {
+    scanner.scan(classify(begin + offset), static_cast<uint32_t>(offset));
+  }
+
+  if (offset < size && size - offset < 64 && out_end - scanner.out() >= 64) {
+    char block[64];
+    std::memset(block, ' ', sizeof(block));
+    std::memcpy(block, begin + offset, size - offset);
+    scanner.scan(classify(block), static_cast<uint32_t>(offset));
+    offset = size;
+  }
+
+  state.offset = offset;
+  scanner.save(state);
+  return scanner.out();
+}
+
+/**
+ * Classify the 64 byte block at data, which is padded with whitespace if there
+ * are fewer than 64 bytes left before end.
+ */
+template <block_masks (*classify)(const char *block)>
+json_force_inline block_masks classify_padded(const char *data, const char *end) {
+  if (json_likely(end - data >= 64)) {
+    return classify(data);
+  }
+
+  char block[64];
+  std::memset(block, ' ', sizeof(block));
+  std::memcpy(block, data, end - data);
+  return classify(block);
+}
+
+/**
+ * Find what the chunk between begin and end does to the nesting depth, both
+ * for when it starts outside a string and for when it starts inside one. The
+ * brackets outside strings in the second case are the ones inside strings in
+ * the first, so one pass finds both.
+ */
+template <block_masks (*classify)(const char *block)>
+json_force_inline void summarize_chunk(
+    const char *begin,
+    const char *end,
+    const bool escape_next,
+    chunk_summary &summary) {
+  string_scanner strings(false, escape_next);
+  int64_t outside_change = 0;
+  int64_t inside_change = 0;
+
+  for (auto block = begin; block < end; block += 64) {
+    const auto masks = classify_padded<classify>(block, end);
+    uint64_t quotes;
+    const auto in_string = strings.scan(masks, quotes);
+    outside_change +=
+        int64_t(count_ones(masks.opening & ~in_string)) -
+        int64_t(count_ones(masks.closing & ~in_string));
+    inside_change +=
+        int64_t(count_ones(masks.opening & in_string)) -
+        int64_t(count_ones(masks.closing & in_string));
+  }
+
+  summary.depth_change[0] = outside_change;
+  summary.depth_change[1] = inside_change;
+  summary.flips_string = strings.in_string();
+}
+
+/**
+ * Find the commas between the elements of an array or object, that is the
+ * ones at depth one, in the chunk between begin and end, and the closing
+ * brackets that take the depth from one to zero. The offsets of these from
+ * begin are written to out. The scan starts at state.offset, in the state that
+ * summarize_chunk of the chunks before it gives. Like find_structurals, it
+ * stops before a block when there are fewer than 64 slots left before out_end,
+ * and returns the end of the offsets that were written.
+ */
+template <block_masks (*classify)(const char *block)>
+json_force_inline uint32_t *find_separators(
+    separator_state &state,
+    const char *begin,
+    const char *end,
+    uint32_t *out,
+    uint32_t *out_end) {
+  const auto size = static_cast<size_t>(end - begin);
+  string_scanner strings(state.in_string, state.escape_next);
+  auto depth = state.depth;
+
+  auto offset = state.offset;
+  for (; offset < size && out_end - out >= 64; offset += 64) {
+    const auto block = begin + offset;
+    const auto masks = classify_padded<classify>(block, end);
+    uint64_t quotes;
+    const auto outside_strings = ~strings.scan(masks, quotes);
+    const auto opening = masks.opening & outside_strings;
+    const auto closing = masks.closing & outside_strings;
+
+    // Blocks that do not get back to depth one are inside an element.
+    const auto closing_count = int64_t(count_ones(closing));
+    if (json_likely(closing_count + 1 < depth)) {
+      depth += int64_t(count_ones(opening)) - closing_count;
+      continue;
+    }
+
+    auto operators = masks.operators & outside_strings;
+    while (operators) {
+      const auto i = count_trailing_zeros(operators);
+      const auto bit = uint64_t(1) << i;
+      if (opening & bit) {
+        depth++;
+      } else if (closing & bit) {
+        if (depth-- == 1) {
+          *out++ = static_cast<uint32_t>(offset + i);
+        }
+      } else if (depth == 1 && block[i] == ',') {
+        *out++ = static_cast<uint32_t>(offset + i);
+      }
+      operators ^= bit;
+    }
+  }
+
+  state.offset = (offset < size ? offset : size);
+  state.depth = depth;
+  state.in_string = strings.in_string();
+  state.escape_next = strings.escape_next();
+  return out;
+}
+
+/**
+ * Find the end of the object or array that starts at begin, 64 bytes at a
+ * time, without validating its contents. Brackets inside strings are left out
+ * with string_scanner, and the nesting depth at the end of a block is the depth
+ * at its start plus the number of opening brackets minus the number of closing
+ * ones. The brackets of a block only need to be looked at one by one when the
+ * block has enough closing brackets to get back to depth zero. Returns the
+ * position after the closing bracket, or nullptr if the input ends before it.
+ *
+ * The bytes after the last whole block are looked at one by one, so that the
+ * scan stops exactly at end. If it returns nullptr, state is where it stopped,
+ * and passing it in with the input that follows end continues the scan.
+ */
+template <block_masks (*classify)(const char *block)>
+json_force_inline const char *skip_container(
+    container_state &state,
+    const char *begin,
+    const char *end) {
+  string_scanner strings(state.in_string, state.escape_next);
+  auto depth = state.depth;
+  auto block = begin;
+
+  for (; end - block >= 64; block += 64) {
+    const auto masks = classify(block);
+    uint64_t quotes;
+    const auto outside_strings = ~strings.scan(masks, quotes);
+    const auto opening = masks.opening & outside_strings;
+    const auto closing = masks.closing & outside_strings;
+
+    const auto closing_count = count_ones(closing);
+    if (json_likely(closing_count < depth)) {
+      depth = depth + count_ones(opening) - closing_count;
+      continue;
+    }
+
+    auto brackets = opening | closing;
+    while (brackets) {
+      const auto bit = brackets & (uint64_t(0) - brackets);
+      if (opening & bit) {
+        depth++;
+      } else if (--depth == 0) {
+        return block + count_trailing_zeros(bit) + 1;
+      }
+      brackets ^= bit;
+    }
+  }
+
+  auto in_string = strings.in_string();
+  auto escape_next = strings.escape_next();
+  for (; block != end; block++) {
+    const auto c = *block;
+    if (escape_next) {
+      escape_next = false;
+    } else if (c == '\\') {
+      escape_next = true;
+    } else if (c == '"') {
+      in_string = !in_string;
+    } else if (in_string) {
+      continue;
+    } else if (c == '{' || c == '[') {
+      depth++;
+    } else if ((c == '}' || c == ']') && --depth == 0) {
+      return block + 1;
+    }
+  }
+
+  state.depth = depth;
+  state.in_string = in_string;
+  state.escape_next = escape_next;
+  return nullptr;
+}
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
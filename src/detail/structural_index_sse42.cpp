@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+
+#include <spotify/json/detail/structural_index.hpp>
+
+#if defined(json_arch_x86_sse42)
+
+#include <nmmintrin.h>
+#include <tmmintrin.h>
+
+#include "structural_index_common.hpp"
+
+namespace spotify {
+namespace json {
+namespace detail {
+namespace {
+
+json_force_inline void classify_16_sse42(const char *data, const unsigned shift, block_masks &masks) {
+  const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data));
+  const auto spaces = _mm_setr_epi8(' ', 0, 0, 0, 0, 0, 0, 0, 0, '\t', '\n', 0, 0, '\r', 0, 0);
+
+  // Setting bit 5 turns [ and ] into { and }, and leaves , and : unchanged.
+  const auto lower = _mm_or_si128(chunk, _mm_set1_epi8(0x20));
+  const auto opening = _mm_cmpeq_epi8(lower, _mm_set1_epi8('{'));
+  const auto closing = _mm_cmpeq_epi8(lower, _mm_set1_epi8('}'));
+  const auto operators = _mm_or_si128(
+      _mm_or_si128(opening, closing),
+      _mm_or_si128(
+          _mm_cmpeq_epi8(chunk, _mm_set1_epi8(',')),
+          _mm_cmpeq_epi8(chunk, _mm_set1_epi8(':'))));
+
+  const auto mask = [&](const __m128i matches) {
+    return uint64_t(uint16_t(_mm_movemask_epi8(matches))) << shift;
+  };
+  masks.backslash |= mask(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\\')));
+  masks.quote |= mask(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('"')));
+  masks.whitespace |= mask(_mm_cmpeq_epi8(_mm_shuffle_epi8(spaces, chunk), chunk));
+  masks.operators |= mask(operators);
+  masks.opening |= mask(opening);
+  masks.closing |= mask(closing);
+}
+
+json_force_inline block_masks classify_sse42(const char *block) {
+  block_masks masks = { 0, 0, 0, 0, 0, 0 };
+  classify_16_sse42(block +  0,  0, masks);
+  classify_16_sse42(block + 16, 16, masks);
+  classify_16_sse42(block + 32, 32, masks);
+  classify_16_sse42(block + 48, 48, masks);
+  return masks;
+}
+
+}  // namespace
+
+uint32_t *find_structurals_sse42(
+    structural_state &state,
+    const char *begin,
+    const char *end,
+    uint32_t *out,
+    uint32_t *out_end) {
+  return find_structurals<classify_sse42>(state, begin, end, out, out_end);
+}
+
+const char *skip_container_sse42(container_state &state, const char *begin, const char *end) {
+  return skip_container<classify_sse42>(state, begin, end);
+}
+
+void summarize_chunk_sse42(const char *begin, const char *end, const bool escape_next, chunk_summary &summary) {
+  summarize_chunk<classify_sse42>(begin, end, escape_next, summary);
+}
+
+uint32_t *find_separators_sse42(
+    separator_state &state,
+    const char *begin,
+    const char *end,
+    uint32_t *out,
+    uint32_t *out_end) {
+  return find_separators<classify_sse42>(state, begin, end, out, out_end);
+}
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
+
+#endif  // defined(json_arch_x86_sse42)
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+
+#include <spotify/json/detail/utf8.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <spotify/json/detail/macros.hpp>
+
+namespace spotify {
+namespace json {
+namespace detail {
+
+const char *find_invalid_utf8(const char *begin, const char *end) {
+  auto pos = reinterpret_cast<const uint8_t *>(begin);
+  const auto last = reinterpret_cast<const uint8_t *>(end);
+
+  while (pos < last) {
+    // JSON is mostly ASCII, which is skipped eight bytes at a time.
+    for (; last - pos >= 8; pos += 8) {
+      uint64_t word;
+      std::memcpy(&word, pos, sizeof(word));
+      if (word & 0x8080808080808080ULL) {
+        break;
+      }
+    }
+
+    if (pos == last) {
+      break;
+    }
+
+    const auto lead = *pos;
+    if (lead < 0x80) {
+      pos++;
+      continue;
+    }
+
+    // The size of the sequence, and the range of its second byte; only some
+    // lead bytes restrict it to rule out overlong encodings, surrogates and
+    // code points above U+10FFFF.
+    ptrdiff_t size;
+    uint8_t low = 0x80;
+    uint8_t high = 0xBF;
+    if (lead >= 0xC2 && lead <= 0xDF) {
+      size = 2;
+    } else if (lead == 0xE0) {
+      size = 3;
+      low = 0xA0;
+    } else if (lead == 0xED) {
+      size = 3;
+      high = 0x9F;
+    } else if (lead >= 0xE1 && lead <= 0xEF) {
+      size = 3;
+    } else if (lead == 0xF0) {
+      size = 4;
+      low = 0x90;
+    } else if (lead == 0xF4) {
+      size = 4;
+      high = 0x8F;
+    } else if (lead >= 0xF1 && lead <= 0xF3) {
+      size = 4;
+    } else {
+      return reinterpret_cast<const char *>(pos);
+    }
+
+    if (json_unlikely(last - pos < size || pos[1] < low || pos[1] > high)) {
+      return reinterpret_cast<const char *>(pos);
+    }
+    for (ptrdiff_t i = 2; i < size; i++) {
+      if (json_unlikely((pos[i] & 0xC0) != 0x80)) {
+        return reinterpret_cast<const char *>(pos);
+      }
+    }
+    pos += size;
+  }
+
+  return end;
+}
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
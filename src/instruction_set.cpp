@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+
+#include <spotify/json/instruction_set.hpp>
+
+#include <spotify/json/detail/kernels.hpp>
+
+namespace spotify {
+namespace json {
+
+const char *instruction_set_name(const instruction_set isa) {
+  switch (isa) {
+    case instruction_set::scalar: return "scalar";
+    case instruction_set::sse42: return "sse42";
+    case instruction_set::avx2: return "avx2";
+    case instruction_set::avx512bw: return "avx512bw";
+  }
+  return "unknown";
+}
+
+bool is_instruction_set_supported(const instruction_set isa) {
+  return detail::find_kernels(isa) != nullptr;
+}
+
+instruction_set active_instruction_set() {
+  return detail::resolve_kernels().isa;
+}
+
+bool use_instruction_set(const instruction_set isa) {
+  const auto kernels = detail::find_kernels(isa);
+  if (!kernels) {
+    return false;
+  }
+  detail::active_kernels.store(kernels);
+  detail::active_whitespace_skipper.store(kernels->skip_any_whitespace);
+  return true;
+}
+
+}  // namespace json
+}  // namespace spotify
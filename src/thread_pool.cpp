@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <spotify/json/thread_pool.hpp>
+
+#include <algorithm>
+
+namespace spotify {
+namespace json {
+
+/**
+ * The indices that are left for one thread. The parts are padded so that they
+ * do not share cache lines, and a thread taking work from its own part does
+ * not slow down the others.
+ */
+struct thread_pool::part {
+  std::mutex mutex;
+  size_t begin = 0;
+  size_t end = 0;
+  char padding[64];
+};
+
+thread_pool::thread_pool(const size_t threads)
+    : _parts(new part[std::max<size_t>(threads, 1)]) {
+  for (size_t i = 1; i < threads; i++) {
+    _workers.emplace_back([this, i] { run_worker(i); });
+  }
+}
+
+thread_pool::~thread_pool() {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _is_stopping = true;
+  }
+  _work_changed.notify_all();
+  for (auto &worker : _workers) {
+    worker.join();
+  }
+}
+
+void thread_pool::parallel_for(
+    const size_t count,
+    const std::function<void (size_t begin, size_t end)> &fn) {
+  std::lock_guard<std::mutex> run_lock(_run_mutex);
+
+  const auto threads = size();
+  for (size_t i = 0; i < threads; i++) {
+    std::lock_guard<std::mutex> lock(_parts[i].mutex);
+    _parts[i].begin = count * i / threads;
+    _parts[i].end = count * (i + 1) / threads;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _fn = &fn;
+    // Small enough for stealing to even out the threads, large enough that
+    // the lock of a part is not taken for every item.
+    _grain = std::max<size_t>(1, count / (threads * 16));
+    _busy_workers = _workers.size();
+    _generation++;
+  }
+  _work_changed.notify_all();
+
+  work(0);
+
+  std::unique_lock<std::mutex> lock(_mutex);
+  _done_changed.wait(lock, [this] { return _busy_workers == 0; });
+  _fn = nullptr;
+}
+
+void thread_pool::work(const size_t self) {
+  while (run_one(self)) {}
+}
+
+/**
+ * Run a grain of work from the part of self, or steal some from another part
+ * if it is empty. Returns false when there is no work left anywhere.
+ */
+bool thread_pool::run_one(const size_t self) {
+  auto &own = _parts[self];
+  size_t begin;
+  size_t end;
+  {
+    std::lock_guard<std::mutex> lock(own.mutex);
+    begin = own.begin;
+    end = std::min(own.end, begin + _grain);
+    own.begin = end;
+  }
+
+  if (begin == end) {
+    const auto threads = size();
+    for (size_t i = 1; i < threads && begin == end; i++) {
+      auto &victim = _parts[(self + i) % threads];
+      std::lock_guard<std::mutex> lock(victim.mutex);
+      const auto left = victim.end - victim.begin;
+      if (left > 0) {
+        begin = victim.end - (left + 1) / 2;
+        end = victim.end;
+        victim.end = begin;
+      }
+    }
+    if (begin == end) {
+      return false;
+    }
+
+    // Keep what was stolen in the part of self, so that others can steal it.
+    std::lock_guard<std::mutex> lock(own.mutex);
+    own.begin = std::min(end, begin + _grain);
+    own.end = end;
+    end = own.begin;
+  }
+
+  (*_fn)(begin, end);
+  return true;
+}
+
+void thread_pool::run_worker(const size_t self) {
+  size_t generation = 0;
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _work_changed.wait(lock, [&] { return _is_stopping || _generation != generation; });
+      if (_is_stopping) {
+        return;
+      }
+      generation = _generation;
+    }
+
+    work(self);
+
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _busy_workers--;
+    }
+    _done_changed.notify_one();
+  }
+}
+
+}  // namespace json
+}  // namespace spotify
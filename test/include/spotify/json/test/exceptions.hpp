@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/detail/macros.hpp>
+
+// The test suite is also built with -fno-exceptions, against a copy of the
+// library that is built that way. The Boost.Test checks for exceptions need
+// try and catch, so there they are replaced: checks that expect an exception
+// compile the statement but never run it, since it would abort, and checks
+// that expect none just run the statement. Tests with a try block of their own are only built
+// if json_has_exceptions is set.
+#if !json_has_exceptions
+
+#undef BOOST_CHECK_THROW
+#undef BOOST_REQUIRE_THROW
+#undef BOOST_CHECK_NO_THROW
+#undef BOOST_REQUIRE_NO_THROW
+
+#define BOOST_CHECK_THROW(statement, exception) do { if (false) { statement; } } while (false)
+#define BOOST_REQUIRE_THROW(statement, exception) do { if (false) { statement; } } while (false)
+#define BOOST_CHECK_NO_THROW(statement) do { statement; } while (false)
+#define BOOST_REQUIRE_NO_THROW(statement) do { statement; } while (false)
+
+#endif  // !json_has_exceptions
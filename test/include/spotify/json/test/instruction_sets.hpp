@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+
+#pragma once
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/instruction_set.hpp>
+
+namespace spotify {
+namespace json {
+
+/**
+ * Run test once for each instruction set that is supported on this machine,
+ * with the kernels for that instruction set in use. The kernels that were in
+ * use before are restored afterwards.
+ */
+template <typename test_fn>
+void for_each_instruction_set(const test_fn &test) {
+  struct restore_t {
+    ~restore_t() { use_instruction_set(original); }
+    const instruction_set original;
+  } restore{ active_instruction_set() };
+
+  for (const auto isa : {
+      instruction_set::scalar,
+      instruction_set::sse42,
+      instruction_set::avx2,
+      instruction_set::avx512bw }) {
+    if (use_instruction_set(isa)) {
+      BOOST_TEST_CONTEXT("instruction set " << instruction_set_name(isa)) {
+        test();
+      }
+    }
+  }
+}
+
+}  // namespace json
+}  // namespace spotify
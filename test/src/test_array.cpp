@@ -14,7 +14,11 @@
  * the License.
  */
 
+#include <array>
+#include <list>
+#include <set>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 #include <boost/test/unit_test.hpp>
@@ -24,9 +28,12 @@
 #include <spotify/json/codec/boolean.hpp>
 #include <spotify/json/codec/number.hpp>
 #include <spotify/json/codec/omit.hpp>
+#include <spotify/json/codec/string.hpp>
 #include <spotify/json/decode.hpp>
 #include <spotify/json/encode.hpp>
 
+#include <spotify/json/test/exceptions.hpp>
+
 BOOST_AUTO_TEST_SUITE(spotify)
 BOOST_AUTO_TEST_SUITE(json)
 BOOST_AUTO_TEST_SUITE(codec)
@@ -231,6 +238,62 @@ BOOST_AUTO_TEST_CASE(json_codec_array_should_decode_empty_unordered_set) {
   BOOST_CHECK(array_parse<std::unordered_set<bool>>("[]").empty());
 }
 
+/*
+ * Decoding Into Existing Containers
+ */
+
+BOOST_AUTO_TEST_CASE(json_codec_array_should_decode_into_existing_vector) {
+  std::vector<std::string> values = { std::string(100, 'a'), std::string(100, 'b'), "c" };
+  const auto first_data = values[0].data();
+  const auto vector_data = values.data();
+
+  decode_into(R"(["x","y"])", values);
+  BOOST_REQUIRE_EQUAL(values.size(), 2);
+  BOOST_CHECK_EQUAL(values[0], "x");
+  BOOST_CHECK_EQUAL(values[1], "y");
+  BOOST_CHECK_EQUAL(values[0].data(), first_data);
+  BOOST_CHECK_EQUAL(values.data(), vector_data);
+
+  decode_into(R"(["1","2","3","4"])", values);
+  BOOST_REQUIRE_EQUAL(values.size(), 4);
+  BOOST_CHECK_EQUAL(values[3], "4");
+
+  decode_into(R"([])", values);
+  BOOST_CHECK(values.empty());
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_array_should_decode_into_existing_vector_of_bool) {
+  std::vector<bool> values = { false, false, false };
+  decode_into(R"([true,false])", values);
+  BOOST_CHECK(values == std::vector<bool>({ true, false }));
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_array_should_decode_into_existing_list) {
+  std::list<bool> values = { false, false, false };
+  decode_into(R"([true,false])", values);
+  BOOST_CHECK(values == std::list<bool>({ true, false }));
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_array_should_decode_into_existing_array) {
+  std::array<bool, 2> values = {{ false, true }};
+  decode_into(R"([true,false])", values);
+  BOOST_CHECK(values[0]);
+  BOOST_CHECK(!values[1]);
+
+  BOOST_CHECK_THROW(decode_into(R"([true])", values), decode_exception);
+  BOOST_CHECK_THROW(decode_into(R"([true,true,true])", values), decode_exception);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_array_should_decode_into_existing_set) {
+  std::set<bool> values = { false };
+  decode_into(R"([true])", values);
+  BOOST_CHECK(values == std::set<bool>({ true }));
+
+  std::unordered_set<bool> unordered_values = { false };
+  decode_into(R"([true,true])", unordered_values);
+  BOOST_CHECK(unordered_values == std::unordered_set<bool>({ true }));
+}
+
 BOOST_AUTO_TEST_SUITE_END()  // codec
 BOOST_AUTO_TEST_SUITE_END()  // json
 BOOST_AUTO_TEST_SUITE_END()  // spotify
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <string>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/detail/chunk_scanner.hpp>
+
+#include <spotify/json/test/instruction_sets.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+BOOST_AUTO_TEST_SUITE(detail)
+
+namespace {
+
+/**
+ * Scan json in two chunks, split at each possible position, and check that
+ * the value is found to end at expected_end (or not at all, if it is npos).
+ */
+void check_end(const std::string &json, const size_t expected_end) {
+  for (size_t split = 0; split <= json.size(); split++) {
+    BOOST_TEST_CONTEXT("split at " << split) {
+      chunk_scanner scanner;
+      const auto data = json.data();
+      auto end = scanner.scan(data, data + split);
+      if (!end) {
+        end = scanner.scan(data + split, data + json.size());
+      }
+      BOOST_CHECK_EQUAL(end ? size_t(end - data) : std::string::npos, expected_end);
+    }
+  }
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(json_chunk_scanner_should_find_end_of_containers) {
+  for_each_instruction_set([] {
+    check_end("[]", 2);
+    check_end("{} ", 2);
+    check_end(R"({"a":[1,{"b":"]"}],"c":"\"}"} [)", 29);
+    check_end(R"(["\\", "\\\"]"] )", 15);
+    check_end("[[1]", std::string::npos);
+  });
+}
+
+BOOST_AUTO_TEST_CASE(json_chunk_scanner_should_find_end_of_strings) {
+  check_end(R"("a" )", 3);
+  check_end(R"("a\"b\\" 1)", 8);
+  check_end(R"("a\")", std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(json_chunk_scanner_should_find_end_of_other_values) {
+  check_end("123 ", 3);
+  check_end("true,", 4);
+  check_end("1e5]", 3);
+  check_end("null", std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(json_chunk_scanner_should_carry_state_across_blocks) {
+  for_each_instruction_set([] {
+    for (auto n = 0; n < 140; n++) {
+      const auto json = "[\"" + std::string(n, 'a') + R"(\\", [")" + std::string(n, '\\') + "\"], {}]";
+      if (n % 2 == 0) {
+        check_end(json, json.size());
+      } else {
+        check_end(json, std::string::npos);
+      }
+    }
+  });
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // detail
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
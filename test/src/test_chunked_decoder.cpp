@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <array>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/chunked_decoder.hpp>
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/codec/map.hpp>
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/decode.hpp>
+#include <spotify/json/decode_exception.hpp>
+#include <spotify/json/string_view.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+
+namespace {
+
+using map_type = std::map<std::string, std::vector<std::string>>;
+
+const std::string map_json = R"( {"a": ["x", "y\"]"], "b\\": [], "c": ["{"]} )";
+
+map_type expected_map() {
+  return map_type{
+      { "a", { "x", "y\"]" } },
+      { "b\\", {} },
+      { "c", { "{" } } };
+}
+
+template <typename value_type>
+void check_decode_fails(
+    const std::vector<std::string> &chunks,
+    const std::string &error,
+    const size_t offset) {
+#if json_has_exceptions
+  auto decoder = make_chunked_decoder<value_type>();
+  try {
+    for (const auto &chunk : chunks) {
+      decoder.append(chunk);
+    }
+    decoder.finish();
+    BOOST_ERROR("decoding should have failed");
+  } catch (const decode_exception &exception) {
+    BOOST_CHECK_EQUAL(exception.what(), error);
+    BOOST_CHECK_EQUAL(exception.offset(), offset);
+  }
+#else
+  (void)chunks;
+  (void)error;
+  (void)offset;
+#endif  // json_has_exceptions
+}
+
+template <typename value_type>
+void check_decode_fails_like_decode_when_split_anywhere(const std::string &json) {
+#if json_has_exceptions
+  std::string error;
+  size_t offset = 0;
+  try {
+    decode<value_type>(json);
+    BOOST_ERROR("decoding should have failed: " << json);
+    return;
+  } catch (const decode_exception &exception) {
+    error = exception.what();
+    offset = exception.offset();
+  }
+
+  for (size_t first = 0; first <= json.size(); first++) {
+    for (size_t second = first; second <= json.size(); second++) {
+      check_decode_fails<value_type>(
+          { json.substr(0, first), json.substr(first, second - first), json.substr(second) },
+          error,
+          offset);
+    }
+  }
+#else
+  (void)json;
+#endif  // json_has_exceptions
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(json_chunked_decoder_should_decode_value_in_one_chunk) {
+  auto decoder = make_chunked_decoder<map_type>();
+  BOOST_CHECK(decoder.append(map_json));
+  BOOST_CHECK(decoder.is_done());
+  BOOST_CHECK(decoder.value() == expected_map());
+}
+
+BOOST_AUTO_TEST_CASE(json_chunked_decoder_should_decode_value_split_anywhere) {
+  for (size_t first = 0; first <= map_json.size(); first++) {
+    for (size_t second = first; second <= map_json.size(); second++) {
+      auto decoder = make_chunked_decoder<map_type>();
+      decoder.append(map_json.substr(0, first));
+      decoder.append(map_json.substr(first, second - first));
+      decoder.append(map_json.substr(second));
+      decoder.finish();
+      BOOST_CHECK(decoder.value() == expected_map());
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_chunked_decoder_should_decode_value_before_end_of_input) {
+  auto decoder = make_chunked_decoder<std::vector<int>>();
+  BOOST_CHECK(!decoder.append(std::string("[1, ")));
+  BOOST_CHECK(!decoder.append(std::string("2")));
+  BOOST_CHECK(decoder.append(std::string("] ")));
+  BOOST_CHECK(decoder.append(std::string("\n")));
+  BOOST_CHECK(decoder.value() == std::vector<int>({ 1, 2 }));
+}
+
+BOOST_AUTO_TEST_CASE(json_chunked_decoder_should_decode_array_split_anywhere) {
+  using array_type = std::vector<std::vector<std::string>>;
+  const std::string array_json = R"( [ ["x", "y\"]"] , [],["{", "\\"] ] )";
+  const auto expected = array_type{ { "x", "y\"]" }, {}, { "{", "\\" } };
+  for (size_t first = 0; first <= array_json.size(); first++) {
+    for (size_t second = first; second <= array_json.size(); second++) {
+      auto decoder = make_chunked_decoder<array_type>();
+      decoder.append(array_json.substr(0, first));
+      decoder.append(array_json.substr(first, second - first));
+      decoder.append(array_json.substr(second));
+      decoder.finish();
+      BOOST_CHECK(decoder.value() == expected);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_chunked_decoder_should_decode_numbers_split_anywhere) {
+  const std::string array_json = "[1, 22 ,333,-4444.0e0,5]";
+  for (size_t first = 0; first <= array_json.size(); first++) {
+    for (size_t second = first; second <= array_json.size(); second++) {
+      auto decoder = make_chunked_decoder<std::vector<double>>();
+      decoder.append(array_json.substr(0, first));
+      decoder.append(array_json.substr(first, second - first));
+      BOOST_CHECK(decoder.append(array_json.substr(second)));
+      BOOST_CHECK(decoder.value() == std::vector<double>({ 1, 22, 333, -4444, 5 }));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_chunked_decoder_should_decode_elements_as_their_chunks_arrive) {
+  auto decoder = make_chunked_decoder<std::vector<int>>();
+  BOOST_CHECK(!decoder.append(std::string("[1, 22, 3")));
+  BOOST_CHECK(decoder.value() == std::vector<int>({ 1, 22 }));
+  BOOST_CHECK(!decoder.append(std::string("3, 4")));
+  BOOST_CHECK(decoder.value() == std::vector<int>({ 1, 22, 33 }));
+  BOOST_CHECK(decoder.append(std::string("]")));
+  BOOST_CHECK(decoder.value() == std::vector<int>({ 1, 22, 33, 4 }));
+}
+
+BOOST_AUTO_TEST_CASE(json_chunked_decoder_should_decode_members_as_their_chunks_arrive) {
+  auto decoder = make_chunked_decoder<map_type>();
+  BOOST_CHECK(!decoder.append(std::string(R"({"a": ["x"], "b)")));
+  BOOST_CHECK(decoder.value() == map_type({ { "a", { "x" } } }));
+  BOOST_CHECK(!decoder.append(std::string(R"(": ["y", "z"], "c": [)")));
+  BOOST_CHECK(decoder.value() == map_type({ { "a", { "x" } }, { "b", { "y", "z" } } }));
+  BOOST_CHECK(decoder.append(std::string("]}")));
+  BOOST_CHECK(decoder.value() == map_type({ { "a", { "x" } }, { "b", { "y", "z" } }, { "c", {} } }));
+}
+
+BOOST_AUTO_TEST_CASE(json_chunked_decoder_should_decode_segments) {
+  const json::string_view segments[] = { "[\"a", "", "b\",", "\"c\"]" };
+  auto decoder = make_chunked_decoder(codec::array<std::vector<std::string>>(codec::string()));
+  BOOST_CHECK(decoder.append(segments, 4));
+  BOOST_CHECK(decoder.value() == std::vector<std::string>({ "ab", "c" }));
+}
+
+BOOST_AUTO_TEST_CASE(json_chunked_decoder_should_decode_number_at_end_of_input) {
+  auto decoder = make_chunked_decoder(codec::number<int>());
+  BOOST_CHECK(!decoder.append(std::string(" 12")));
+  BOOST_CHECK(!decoder.append(std::string("34")));
+  decoder.finish();
+  BOOST_CHECK(decoder.is_done());
+  BOOST_CHECK_EQUAL(decoder.value(), 1234);
+}
+
+BOOST_AUTO_TEST_CASE(json_chunked_decoder_should_count_offsets_from_first_chunk) {
+  check_decode_fails<std::vector<int>>({ "  [1,", " x]" }, "Invalid integer", 7);
+  check_decode_fails<std::vector<int>>({ "[1]", " ", " 2" }, "Unexpected trailing input", 5);
+  check_decode_fails<std::vector<int>>({ "[1", "," }, "Unexpected end of input", 3);
+  check_decode_fails<int>({ " ", " " }, "Unexpected end of input", 2);
+}
+
+BOOST_AUTO_TEST_CASE(json_chunked_decoder_should_fail_like_decode_when_split_anywhere) {
+  for (const auto &json : std::vector<std::string>{
+      "[", "[1", "[1,", "[1,]", "[1 2]", "[1}", "[12x, 3]", "[1, \"a\"]", "[1] x", "[,1]", "[ ]]"}) {
+    check_decode_fails_like_decode_when_split_anywhere<std::vector<int>>(json);
+  }
+  for (const auto &json : std::vector<std::string>{
+      "{", R"({"a")", R"({"a" ["x"]})", R"({"a": ["x"],})", R"({"a": ["x"])",
+      R"({"a": ["x"] "b": []})", R"({a: []})", R"({"a": [1]})", R"({"a": ["x\q"]})",
+      R"({"\u"00e9": []})"}) {
+    check_decode_fails_like_decode_when_split_anywhere<map_type>(json);
+  }
+  for (const auto &json : std::vector<std::string>{
+      R"(["\u"00e9"])", R"(["ab\u1"23"])", R"(["\u00"])", R"(["\u0)"}) {
+    check_decode_fails_like_decode_when_split_anywhere<std::vector<std::string>>(json);
+  }
+  check_decode_fails_like_decode_when_split_anywhere<std::array<int, 2>>("[1, 2, 3]");
+  check_decode_fails_like_decode_when_split_anywhere<std::array<int, 2>>("[1]");
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
@@ -14,15 +14,30 @@
  * the License.
  */
 
+#include <map>
 #include <string>
+#include <tuple>
+#include <vector>
 
 #include <boost/test/unit_test.hpp>
 
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/codec/boolean.hpp>
+#include <spotify/json/codec/empty_as.hpp>
+#include <spotify/json/codec/map.hpp>
+#include <spotify/json/codec/null.hpp>
 #include <spotify/json/codec/number.hpp>
 #include <spotify/json/codec/object.hpp>
+#include <spotify/json/codec/one_of.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/codec/tuple.hpp>
 #include <spotify/json/decode.hpp>
+#include <spotify/json/decode_exception.hpp>
 #include <spotify/json/encoded_value.hpp>
 
+#include <spotify/json/test/exceptions.hpp>
+#include <spotify/json/test/instruction_sets.hpp>
+
 BOOST_AUTO_TEST_SUITE(spotify)
 BOOST_AUTO_TEST_SUITE(json)
 
@@ -32,12 +47,46 @@ struct custom_obj {
   std::string val;
 };
 
+struct counted_obj {
+  std::string val;
+};
+
+struct warmed_up_obj {
+  std::string val;
+};
+
+int num_counted_codecs = 0;
+int num_warmed_up_codecs = 0;
+
 codec::object_t<custom_obj> custom_codec() {
   auto codec = codec::object<custom_obj>();
   codec.required("a", &custom_obj::val);
   return codec;
 }
 
+/**
+ * Decodes the input both with exceptions and into a non-throwing context, and
+ * checks that the two report the same error at the same offset.
+ */
+template <typename codec_type>
+void check_same_failure(const codec_type &codec, const std::string &json) {
+  BOOST_TEST_CONTEXT("json: " << json) {
+    decode_context context(json.data(), json.data() + json.size());
+    typename codec_type::object_type object;
+    BOOST_REQUIRE(!try_decode(object, codec, context));
+
+#if json_has_exceptions
+    try {
+      decode(codec, json);
+      BOOST_ERROR("decode should have thrown");
+    } catch (const decode_exception &exception) {
+      BOOST_CHECK_EQUAL(context.error(), std::string(exception.what()));
+      BOOST_CHECK_EQUAL(context.error_offset(), exception.offset());
+    }
+#endif  // json_has_exceptions
+  }
+}
+
 }
 
 template <>
@@ -49,6 +98,26 @@ struct default_codec_t<custom_obj> {
   }
 };
 
+template <>
+struct default_codec_t<counted_obj> {
+  static codec::object_t<counted_obj> codec() {
+    num_counted_codecs++;
+    auto codec = codec::object<counted_obj>();
+    codec.required("x", &counted_obj::val);
+    return codec;
+  }
+};
+
+template <>
+struct default_codec_t<warmed_up_obj> {
+  static codec::object_t<warmed_up_obj> codec() {
+    num_warmed_up_codecs++;
+    auto codec = codec::object<warmed_up_obj>();
+    codec.required("x", &warmed_up_obj::val);
+    return codec;
+  }
+};
+
 BOOST_AUTO_TEST_CASE(json_decode_should_decode_from_bytes_with_custom_codec) {
   static const char * const kData = R"({"a":"e"})";
   const auto obj = decode(custom_codec(), kData, strlen(kData));
@@ -123,6 +192,57 @@ BOOST_AUTO_TEST_CASE(json_decode_should_throw_on_unexpected_trailing_input) {
   BOOST_CHECK_THROW(decode<custom_obj>(R"({"x":"h"} invalid)"), decode_exception);
 }
 
+BOOST_AUTO_TEST_CASE(json_decode_into_should_decode_into_existing_object) {
+  custom_obj obj;
+  decode_into(custom_codec(), R"( {"a":"e"} )", obj);
+  BOOST_CHECK_EQUAL(obj.val, "e");
+  decode_into(R"({"x":"f"})", obj);
+  BOOST_CHECK_EQUAL(obj.val, "f");
+  decode_into(std::string(R"({"x":"g"})"), obj);
+  BOOST_CHECK_EQUAL(obj.val, "g");
+  decode_into(R"({"x":"h"})", 9, obj);
+  BOOST_CHECK_EQUAL(obj.val, "h");
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_into_should_throw_on_unexpected_trailing_input) {
+  custom_obj obj;
+  BOOST_CHECK_THROW(decode_into(R"({"x":"f"} x)", obj), decode_exception);
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_padded_should_not_decode_padding) {
+  using value_type = std::map<std::string, std::vector<std::string>>;
+  const std::string json = R"( { "a" : [ "x", "y\"" ], "b": [] } )";
+  const auto expected = decode<value_type>(json);
+  for_each_instruction_set([&]{
+    for (const auto padding : { '"', ' ', 'a', ']', '\0' }) {
+      const auto padded = json + std::string(decode_padding, padding);
+      BOOST_CHECK(decode_padded<value_type>(padded.data(), json.size()) == expected);
+      BOOST_CHECK(decode_padded(default_codec<value_type>(), padded.data(), json.size()) == expected);
+      BOOST_CHECK_THROW(decode_padded<value_type>(padded.data(), json.size() - 2), decode_exception);
+    }
+  });
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_should_create_default_codec_once) {
+  BOOST_CHECK_EQUAL(decode<counted_obj>(R"({"x":"a"})").val, "a");
+  BOOST_CHECK_EQUAL(decode<counted_obj>(R"({"x":"b"})").val, "b");
+  counted_obj obj;
+  BOOST_CHECK(try_decode(obj, R"({"x":"c"})"));
+  BOOST_CHECK_EQUAL(obj.val, "c");
+  BOOST_CHECK_EQUAL(num_counted_codecs, 1);
+  BOOST_CHECK_EQUAL(&cached_default_codec<counted_obj>(), &cached_default_codec<counted_obj>());
+}
+
+BOOST_AUTO_TEST_CASE(json_warm_up_should_create_default_codecs) {
+  BOOST_CHECK_EQUAL(num_warmed_up_codecs, 0);
+  warm_up<warmed_up_obj, int>();
+  BOOST_CHECK_EQUAL(num_warmed_up_codecs, 1);
+  warm_up<warmed_up_obj>();
+  warm_up<>();
+  BOOST_CHECK_EQUAL(decode<warmed_up_obj>(R"({"x":"a"})").val, "a");
+  BOOST_CHECK_EQUAL(num_warmed_up_codecs, 1);
+}
+
 BOOST_AUTO_TEST_CASE(json_try_decode_should_decode_from_bytes_with_custom_codec) {
   static const char * const kData = R"({"a":"e"})";
   custom_obj obj;
@@ -137,6 +257,14 @@ BOOST_AUTO_TEST_CASE(json_try_decode_should_decode_from_bytes) {
   BOOST_CHECK_EQUAL(val, 78);
 }
 
+BOOST_AUTO_TEST_CASE(json_try_decode_should_restore_throw_on_failure) {
+  const std::string json = "d78";
+  decode_context context(json.data(), json.data() + json.size());
+  int val = 12;
+  BOOST_CHECK(!try_decode(val, codec::number<int>(), context));
+  BOOST_CHECK(context.throw_on_failure);
+}
+
 BOOST_AUTO_TEST_CASE(json_try_decode_should_not_decode_from_invalid_bytes) {
   static const char * const kData = "d78";
   int val = 12;
@@ -202,6 +330,43 @@ BOOST_AUTO_TEST_CASE(json_try_decode_should_report_failure) {
   BOOST_CHECK(!try_decode(obj, "{}"));  // Missing field
 }
 
+BOOST_AUTO_TEST_CASE(json_try_decode_should_report_error_in_context) {
+  custom_obj obj;
+  const std::string json = R"({"b":"c"})";
+  decode_context context(json.data(), json.data() + json.size());
+  BOOST_CHECK(!try_decode(obj, custom_codec(), context));
+  BOOST_CHECK(context.has_failed());
+  BOOST_CHECK_EQUAL(context.error(), std::string("Missing required field(s)"));
+  BOOST_CHECK_EQUAL(context.error_offset(), json.size());
+}
+
+BOOST_AUTO_TEST_CASE(json_try_decode_should_report_same_errors_as_decode) {
+  const auto array = default_codec<std::vector<int>>();
+  const auto map = default_codec<std::map<std::string, bool>>();
+  const auto tuple = default_codec<std::tuple<std::string, double>>();
+  const auto either = codec::one_of(codec::string(), codec::null<std::string>());
+  const auto empty = codec::empty_as_null(codec::string());
+
+  for (const auto json : { "", "[", "[1", "[1,", "[1,]", "[1 2]", "[a]", "{}", "[-]" }) {
+    check_same_failure(array, json);
+  }
+  for (const auto json : { "{", "{\"a\"", "{\"a\":", "{\"a\":tru", "{\"a\":true,}", "{1:true}" }) {
+    check_same_failure(map, json);
+  }
+  for (const auto json : { "[\"a\"]", "[\"a\",1,2]", "[\"\\q\",1]", "[\"\\u12\",1]", "[\"a\",-]" }) {
+    check_same_failure(tuple, json);
+  }
+  for (const auto json : { "nul", "1", "\"a" }) {
+    check_same_failure(either, json);
+  }
+  for (const auto json : { "nul", "1", "\"a" }) {
+    check_same_failure(empty, json);
+  }
+  for (const auto json : { "{\"a\":1}", "{\"a\":\"b\",\"a\"", "{\"a\":\"b\"} x" }) {
+    check_same_failure(custom_codec(), json);
+  }
+}
+
 BOOST_AUTO_TEST_CASE(json_try_decode_should_fail_on_unexpected_trailing_input) {
   custom_obj obj;
   BOOST_CHECK(!try_decode(obj, R"({"x":"h"} invalid)"));
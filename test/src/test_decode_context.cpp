@@ -45,6 +45,62 @@ BOOST_AUTO_TEST_CASE(json_decode_context_should_construct_with_data_size) {
   BOOST_CHECK(ctx.end == end);
 }
 
+BOOST_AUTO_TEST_CASE(json_decode_context_should_not_have_mutable_input_by_default) {
+  static const char string[] = "abc";
+  const decode_context ctx(string, sizeof(string));
+  BOOST_CHECK(!ctx.has_mutable_input);
+  BOOST_CHECK(!ctx.has_padded_input);
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_context_should_construct_with_mutable_input) {
+  char string[] = "abc";
+  char * const end = string + sizeof(string);
+  const decode_context ctx(string, end, decode_context::mutable_input_t());
+
+  BOOST_CHECK(ctx.has_mutable_input);
+  BOOST_CHECK(ctx.begin == string);
+  BOOST_CHECK(ctx.mutable_position() == string);
+  BOOST_CHECK(ctx.end == end);
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_context_should_construct_with_padded_input) {
+  static const char string[] = "abc";
+  const decode_context ctx(string, string + 1, decode_context::padded_input_t());
+
+  BOOST_CHECK(ctx.has_padded_input);
+  BOOST_CHECK(!ctx.has_mutable_input);
+  BOOST_CHECK(ctx.begin == string);
+  BOOST_CHECK(ctx.end == string + 1);
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_context_should_throw_on_failure_by_default) {
+  static const char string[] = "abc";
+  const decode_context ctx(string, sizeof(string));
+  BOOST_CHECK(ctx.throw_on_failure);
+  BOOST_CHECK(!ctx.has_failed());
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_context_should_keep_first_error) {
+  static const char string[] = "abc";
+  decode_context ctx(string, sizeof(string));
+  ctx.position++;
+  ctx.set_error("first", 1);
+  ctx.set_error(std::string("second"));
+  BOOST_CHECK(ctx.has_failed());
+  BOOST_CHECK_EQUAL(ctx.error(), std::string("first"));
+  BOOST_CHECK_EQUAL(ctx.error_offset(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_context_should_clear_error) {
+  static const char string[] = "abc";
+  decode_context ctx(string, sizeof(string));
+  ctx.set_error(std::string("first"));
+  ctx.clear_error();
+  BOOST_CHECK(!ctx.has_failed());
+  ctx.set_error(std::string("second"));
+  BOOST_CHECK_EQUAL(ctx.error(), std::string("second"));
+}
+
 BOOST_AUTO_TEST_SUITE_END()  // detail
 BOOST_AUTO_TEST_SUITE_END()  // json
 BOOST_AUTO_TEST_SUITE_END()  // spotify
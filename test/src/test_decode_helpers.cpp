@@ -23,6 +23,8 @@
 #include <spotify/json/codec/string.hpp>
 #include <spotify/json/detail/decode_helpers.hpp>
 
+#include <spotify/json/test/exceptions.hpp>
+
 BOOST_AUTO_TEST_SUITE(spotify)
 BOOST_AUTO_TEST_SUITE(json)
 BOOST_AUTO_TEST_SUITE(detail)
@@ -101,6 +103,15 @@ BOOST_AUTO_TEST_CASE(json_decode_helpers_next_with_empty_input_should_fail) {
   BOOST_CHECK_THROW(next(ctx), decode_exception);
 }
 
+BOOST_AUTO_TEST_CASE(json_decode_helpers_next_with_empty_input_should_record_failure) {
+  auto ctx = make_context("");
+  ctx.throw_on_failure = false;
+  BOOST_CHECK_EQUAL(next(ctx), 0);
+  BOOST_CHECK(ctx.has_failed());
+  BOOST_CHECK_EQUAL(ctx.error(), std::string("Unexpected end of input"));
+  BOOST_CHECK_EQUAL(ctx.error_offset(), 0);
+}
+
 BOOST_AUTO_TEST_CASE(json_decode_helpers_next_at_last_character) {
   auto ctx = make_context("a");
   BOOST_CHECK_EQUAL(next(ctx), 'a');
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/any_codec.hpp>
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/codec/map.hpp>
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/codec/object.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/decode.hpp>
+#include <spotify/json/decode_many.hpp>
+#include <spotify/json/string_view.hpp>
+#include <spotify/json/thread_pool.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+
+namespace {
+
+struct track {
+  std::string uri;
+  std::vector<int> positions;
+  std::map<std::string, std::string> tags;
+};
+
+bool operator==(const track &a, const track &b) {
+  return a.uri == b.uri && a.positions == b.positions && a.tags == b.tags;
+}
+
+codec::object_t<track> track_codec() {
+  auto codec = codec::object<track>();
+  codec.required("uri", &track::uri);
+  codec.optional("positions", &track::positions);
+  codec.optional("tags", &track::tags);
+  return codec;
+}
+
+std::vector<std::string> generate_tracks(const size_t count) {
+  std::vector<std::string> inputs;
+  for (size_t i = 0; i < count; i++) {
+    inputs.push_back(
+        "{\"uri\":\"spotify:track:" + std::to_string(i) + "\"," +
+        "\"positions\":[" + std::to_string(i % 10) + "," + std::to_string(i) + "]," +
+        "\"tags\":{\"n\":\"" + std::string(i % 50, 'x') + "\"}}");
+  }
+  return inputs;
+}
+
+template <typename codec_type>
+void check_same_as_decode(const codec_type &codec, const std::vector<std::string> &inputs) {
+  thread_pool pool(8);
+  const auto results = decode_many(codec, inputs, pool);
+  BOOST_REQUIRE_EQUAL(results.size(), inputs.size());
+  for (size_t i = 0; i < inputs.size(); i++) {
+    BOOST_CHECK(!results[i].has_failed);
+    BOOST_CHECK(results[i].value == decode(codec, inputs[i]));
+  }
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(json_decode_many_should_return_results_in_input_order) {
+  thread_pool pool(4);
+  std::vector<std::string> inputs;
+  for (auto i = 0; i < 1000; i++) {
+    inputs.push_back(std::to_string(i));
+  }
+  const auto results = decode_many<int>(inputs, pool);
+  BOOST_REQUIRE_EQUAL(results.size(), inputs.size());
+  for (auto i = 0; i < 1000; i++) {
+    BOOST_CHECK_EQUAL(results[i].value, i);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_many_should_report_errors_per_input) {
+  thread_pool pool(2);
+  const json::string_view inputs[] = { "[1]", "[1,", "[2] x", " [3] " };
+  const auto results = decode_many(default_codec<std::vector<int>>(), inputs, 4, pool);
+  BOOST_REQUIRE_EQUAL(results.size(), 4);
+  BOOST_CHECK(!results[0].has_failed);
+  BOOST_CHECK(results[1].has_failed);
+  BOOST_CHECK_EQUAL(results[1].error, "Unexpected end of input");
+  BOOST_CHECK_EQUAL(results[1].error_offset, 3);
+  BOOST_CHECK(results[2].has_failed);
+  BOOST_CHECK_EQUAL(results[2].error, "Unexpected trailing input");
+  BOOST_CHECK_EQUAL(results[2].error_offset, 4);
+  BOOST_CHECK(!results[3].has_failed);
+  BOOST_CHECK(results[3].value == std::vector<int>({ 3 }));
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_many_should_share_object_codec_between_threads) {
+  check_same_as_decode(track_codec(), generate_tracks(5000));
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_many_should_share_any_codec_between_threads) {
+  check_same_as_decode(codec::any_codec(track_codec()), generate_tracks(5000));
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
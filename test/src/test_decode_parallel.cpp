@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <array>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/codec/boolean.hpp>
+#include <spotify/json/codec/map.hpp>
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/codec/transform.hpp>
+#include <spotify/json/decode.hpp>
+#include <spotify/json/decode_exception.hpp>
+#include <spotify/json/decode_parallel.hpp>
+#include <spotify/json/thread_pool.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+
+namespace {
+
+const size_t chunk_size = 64;
+
+struct not_default_constructible {
+  explicit not_default_constructible(const int value) : value(value) {}
+  int value;
+};
+
+/**
+ * An array of n strings with escaped quotes, backslashes, brackets and commas
+ * in them, so that many of the chunks start inside strings.
+ */
+std::string generate_strings(const size_t n) {
+  std::string json = "[ ";
+  for (size_t i = 0; i < n; i++) {
+    json += (i ? ",\n  \"" : "\"") + std::string(i % 7, '\\') + std::string(i % 7, '\\');
+    json += "],[{\\\"" + std::string(i % 13, ',') + std::to_string(i) + "\"";
+  }
+  return json + " ]";
+}
+
+std::string generate_map(const size_t n) {
+  std::string json = "{";
+  for (size_t i = 0; i < n; i++) {
+    json += (i ? ", \"" : "\"") + std::to_string(i) + "\" : [{\"a\":[" + std::to_string(i) + "]},{\"b\":[" + std::to_string(i % 3) + "]}]";
+  }
+  return json + "}";
+}
+
+template <typename value_type>
+void check_same_as_decode(const std::string &json) {
+  thread_pool pool(4);
+  const auto &codec = default_codec<value_type>();
+  BOOST_CHECK(decode_parallel(codec, json, pool, chunk_size) == decode(codec, json));
+}
+
+template <typename value_type>
+void check_same_error_as_decode(const std::string &json) {
+#if json_has_exceptions
+  thread_pool pool(4);
+  const auto &codec = default_codec<value_type>();
+  std::string expected_error;
+  size_t expected_offset = 0;
+  try {
+    decode(codec, json);
+    BOOST_FAIL("Expected decode to fail");
+  } catch (const decode_exception &exception) {
+    expected_error = exception.what();
+    expected_offset = exception.offset();
+  }
+
+  try {
+    decode_parallel(codec, json, pool, chunk_size);
+    BOOST_FAIL("Expected decode_parallel to fail");
+  } catch (const decode_exception &exception) {
+    BOOST_CHECK_EQUAL(exception.what(), expected_error);
+    BOOST_CHECK_EQUAL(exception.offset(), expected_offset);
+  }
+#else
+  (void)json;
+#endif  // json_has_exceptions
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(json_decode_parallel_should_decode_array) {
+  check_same_as_decode<std::vector<std::string>>(generate_strings(1000));
+  check_same_as_decode<std::vector<std::vector<int>>>("[" + std::string(200, ' ') + "[1], [2,3]\n, []]");
+  check_same_as_decode<std::vector<bool>>("[true" + std::string(200, ' ') + ",false,  true]");
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_parallel_should_decode_empty_array) {
+  check_same_as_decode<std::vector<int>>("[" + std::string(200, ' ') + "]");
+  check_same_as_decode<std::vector<int>>(std::string(200, '\n') + "[ ]");
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_parallel_should_decode_map) {
+  check_same_as_decode<std::map<std::string, std::vector<std::map<std::string, std::vector<int>>>>>(generate_map(1000));
+  check_same_as_decode<std::unordered_map<std::string, std::vector<std::map<std::string, std::vector<int>>>>>(generate_map(1000));
+  check_same_as_decode<std::map<std::string, int>>(R"({"a":1,"a":2,"b":3,)" + std::string(200, ' ') + R"("c":4})");
+}
+
+#if json_has_exceptions
+
+BOOST_AUTO_TEST_CASE(json_decode_parallel_should_decode_elements_that_are_not_default_constructible) {
+  thread_pool pool(4);
+  const auto codec = codec::array<std::vector<not_default_constructible>>(codec::transform(
+      codec::number<int>(),
+      [](const not_default_constructible &element) { return element.value; },
+      [](const int value) { return not_default_constructible(value); }));
+  const auto values = decode_parallel(codec, "[1," + std::string(200, ' ') + "2,3]", pool, chunk_size);
+  BOOST_REQUIRE_EQUAL(values.size(), 3);
+  BOOST_CHECK_EQUAL(values[0].value, 1);
+  BOOST_CHECK_EQUAL(values[2].value, 3);
+}
+
+#endif  // json_has_exceptions
+
+BOOST_AUTO_TEST_CASE(json_decode_parallel_should_decode_small_input) {
+  thread_pool pool(4);
+  BOOST_CHECK(decode_parallel<std::vector<int>>("[1,2,3]", pool) == std::vector<int>({ 1, 2, 3 }));
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_parallel_should_decode_with_single_thread) {
+  thread_pool pool(1);
+  const auto json = generate_strings(100);
+  BOOST_CHECK(decode_parallel<std::vector<std::string>>(json, pool) == decode<std::vector<std::string>>(json));
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_parallel_should_fail_like_decode) {
+  const auto padding = std::string(200, ' ');
+  check_same_error_as_decode<std::vector<int>>("[1," + padding + "2,]");
+  check_same_error_as_decode<std::vector<int>>("[1," + padding + "\"2\"]");
+  check_same_error_as_decode<std::vector<int>>("[1," + padding + "2 3]");
+  check_same_error_as_decode<std::vector<int>>("[1," + padding + "2");
+  check_same_error_as_decode<std::vector<int>>("[1," + padding + "2] 3");
+  check_same_error_as_decode<std::vector<int>>("[1," + padding + "2]]");
+  check_same_error_as_decode<std::vector<int>>("[," + padding + "]");
+  check_same_error_as_decode<std::vector<int>>("{" + padding + "}");
+  check_same_error_as_decode<std::map<std::string, int>>("{\"a\" 1," + padding + "}");
+  check_same_error_as_decode<std::map<std::string, int>>("{\"a\":1," + padding + "2:3}");
+  check_same_error_as_decode<std::array<int, 2>>("[1," + padding + "2,3]");
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
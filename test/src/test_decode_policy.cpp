@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/codec/map.hpp>
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/codec/object.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/codec/tuple.hpp>
+#include <spotify/json/decode.hpp>
+#include <spotify/json/decode_exception.hpp>
+#include <spotify/json/decode_policy.hpp>
+#include <spotify/json/detail/kernels.hpp>
+#include <spotify/json/detail/nesting.hpp>
+
+#include <spotify/json/test/exceptions.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+
+namespace {
+
+struct trusted_policy : default_decode_policy {
+  static constexpr bool trusted = true;
+};
+
+struct utf8_policy : default_decode_policy {
+  static constexpr bool validate_utf8 = true;
+};
+
+struct trailing_input_policy : default_decode_policy {
+  static constexpr bool allow_trailing_input = true;
+};
+
+struct shallow_policy : default_decode_policy {
+  static constexpr size_t max_depth = 2;
+};
+
+struct shallow_trailing_input_policy : shallow_policy {
+  static constexpr bool allow_trailing_input = true;
+};
+
+struct point {
+  int x = 0;
+  int y = 0;
+};
+
+codec::object_t<point> point_codec() {
+  auto codec = codec::object<point>();
+  codec.required("x", &point::x);
+  codec.required("y", &point::y);
+  return codec;
+}
+
+template <typename policy_type, typename value_type>
+void check_decode_fails(const std::string &json, const std::string &error) {
+#if json_has_exceptions
+  try {
+    decode_with_policy<policy_type, value_type>(json);
+    BOOST_ERROR("decoding should have failed: " << json);
+  } catch (const decode_exception &exception) {
+    BOOST_CHECK_EQUAL(exception.what(), error);
+  }
+#else
+  (void)json;
+  (void)error;
+#endif  // json_has_exceptions
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(json_decode_with_default_policy_should_decode_like_decode) {
+  using value_type = std::map<std::string, std::vector<int>>;
+  const std::string json = R"( { "a" : [1, 2], "b": [] } )";
+  const auto expected = decode<value_type>(json);
+  const auto from_string = decode_with_policy<default_decode_policy, value_type>(json);
+  const auto from_data = decode_with_policy<default_decode_policy, value_type>(json.data(), json.size());
+  BOOST_CHECK(from_string == expected);
+  BOOST_CHECK(from_data == expected);
+  check_decode_fails<default_decode_policy, value_type>(json + "x", "Unexpected trailing input");
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_with_trusted_policy_should_not_validate_skipped_values) {
+  const std::string json = R"({"x":1,"extra":[1,,{]},"y":2})";
+  const auto value = decode_with_policy<trusted_policy>(point_codec(), json);
+  BOOST_CHECK_EQUAL(value.x, 1);
+  BOOST_CHECK_EQUAL(value.y, 2);
+  BOOST_CHECK_THROW(decode(point_codec(), json), decode_exception);
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_with_utf8_policy_should_reject_invalid_utf8) {
+  const auto valid = decode_with_policy<utf8_policy, std::string>(u8"\"å\U0001F600\"");
+  BOOST_CHECK_EQUAL(valid, u8"å\U0001F600");
+  BOOST_CHECK_EQUAL(decode<std::string>("\"\xC0\x80\""), "\xC0\x80");
+  check_decode_fails<utf8_policy, std::string>("\"\xC0\x80\"", "Invalid UTF-8");
+  check_decode_fails<utf8_policy, std::vector<int>>("[1, \"\xED\xA0\x80\"]", "Invalid UTF-8");
+
+#if json_has_exceptions
+  try {
+    decode_with_policy<utf8_policy, std::string>("\"abc\xFF\"");
+    BOOST_ERROR("decoding should have failed");
+  } catch (const decode_exception &exception) {
+    BOOST_CHECK_EQUAL(exception.offset(), 4);
+  }
+#endif  // json_has_exceptions
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_with_trailing_input_policy_should_ignore_trailing_input) {
+  const auto number = decode_with_policy<trailing_input_policy, int>("1 x");
+  const auto array = decode_with_policy<trailing_input_policy, std::vector<int>>("[1]]");
+  BOOST_CHECK_EQUAL(number, 1);
+  BOOST_CHECK(array == std::vector<int>{ 1 });
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_with_max_depth_should_reject_deep_nesting) {
+  using shallow_type = std::vector<std::vector<int>>;
+  using deep_type = std::vector<std::vector<std::vector<int>>>;
+  using deep_map_type = std::map<std::string, shallow_type>;
+  using deep_tuple_type = std::tuple<std::tuple<std::tuple<int>>>;
+  const auto shallow = decode_with_policy<shallow_policy, shallow_type>("[[1],[]]");
+  BOOST_CHECK(shallow == (shallow_type{ { 1 }, {} }));
+  check_decode_fails<shallow_policy, deep_type>("[[[1]]]", "Too deeply nested");
+  check_decode_fails<shallow_policy, deep_map_type>(R"({"a":[[]]})", "Too deeply nested");
+  check_decode_fails<shallow_policy, deep_tuple_type>("[[[1]]]", "Too deeply nested");
+  BOOST_CHECK_THROW(
+      decode_with_policy<shallow_policy>(point_codec(), R"({"x":1,"y":2,"z":[[]]})"),
+      decode_exception);
+  BOOST_CHECK_NO_THROW(decode_with_policy<shallow_policy>(point_codec(), R"({"x":1,"y":2,"z":[1]})"));
+}
+
+#if json_has_exceptions
+
+BOOST_AUTO_TEST_CASE(json_decode_with_max_depth_should_report_offset_of_bracket) {
+  try {
+    decode_with_policy<shallow_policy, std::vector<std::vector<std::vector<int>>>>("[ [ [1]]]");
+    BOOST_ERROR("decoding should have failed");
+  } catch (const decode_exception &exception) {
+    BOOST_CHECK_EQUAL(exception.offset(), 4);
+  }
+}
+
+#endif  // json_has_exceptions
+
+BOOST_AUTO_TEST_CASE(json_decode_with_max_depth_should_only_count_brackets_of_the_value) {
+  using value_type = std::vector<std::string>;
+  const auto strings = decode_with_policy<shallow_policy, value_type>(R"(["[[[", "\"{{{", "\\"])");
+  BOOST_CHECK(strings == (value_type{ "[[[", "\"{{{", "\\" }));
+  check_decode_fails<shallow_policy, std::vector<value_type>>(R"([["\"]", ["[[["]]])", "Too deeply nested");
+  const auto trailing = decode_with_policy<shallow_trailing_input_policy, std::vector<int>>("[1] [[[[");
+  BOOST_CHECK(trailing == std::vector<int>{ 1 });
+}
+
+BOOST_AUTO_TEST_CASE(json_find_too_deep_nesting_should_scan_past_many_blocks) {
+  // More structural characters than find_too_deep_nesting looks at per call,
+  // with brackets in strings that cross block boundaries.
+  std::string json = "[";
+  for (auto i = 0; i < 2000; i++) {
+    json += R"(["[[\"[[", 1],)";
+  }
+  const auto deep = json.size() + 1;
+  json += "[[1]]]";
+  const auto begin = json.data();
+  const auto end = json.data() + json.size();
+  BOOST_CHECK(detail::find_too_deep_nesting(begin, end, 2) == begin + deep);
+  BOOST_CHECK(detail::find_too_deep_nesting(begin, end, 3) == end);
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_context_should_see_the_whitespace_kernel_in_use) {
+  BOOST_CHECK(detail::default_whitespace_skipper() == detail::get_kernels().skip_any_whitespace);
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
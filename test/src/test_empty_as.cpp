@@ -30,6 +30,8 @@
 #include <spotify/json/decode.hpp>
 #include <spotify/json/encode.hpp>
 
+#include <spotify/json/test/exceptions.hpp>
+
 BOOST_AUTO_TEST_SUITE(spotify)
 BOOST_AUTO_TEST_SUITE(json)
 BOOST_AUTO_TEST_SUITE(codec)
@@ -103,6 +105,17 @@ BOOST_AUTO_TEST_CASE(json_codec_empty_as_should_fail_on_invalid_input) {
   test_decode_fail(codec, "[{},true]");
 }
 
+BOOST_AUTO_TEST_CASE(json_codec_empty_as_should_report_inner_error_when_not_throwing) {
+  const auto codec = empty_as_null(string());
+  const std::string json = "\"abc";
+  decode_context c(json.data(), json.size());
+  c.throw_on_failure = false;
+  codec.decode(c);
+  BOOST_CHECK(c.has_failed());
+  BOOST_CHECK_EQUAL(c.error(), std::string("Unterminated string"));
+  BOOST_CHECK(!c.throw_on_failure);
+}
+
 BOOST_AUTO_TEST_CASE(json_codec_empty_as_with_eq) {
   const auto codec = empty_as(eq(123), number<int>());
   BOOST_CHECK_EQUAL(encode(codec, 0), "123");
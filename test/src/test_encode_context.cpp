@@ -21,6 +21,8 @@
 
 #include <spotify/json/encode_context.hpp>
 
+#include <spotify/json/test/exceptions.hpp>
+
 BOOST_AUTO_TEST_SUITE(spotify)
 BOOST_AUTO_TEST_SUITE(json)
 
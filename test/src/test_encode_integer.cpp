@@ -16,6 +16,7 @@
 
 #include <cstdlib>
 #include <limits>
+#include <string>
 
 #include <boost/mpl/list.hpp>
 #include <boost/test/unit_test.hpp>
@@ -71,8 +72,47 @@ void verify_encode_all_positive(const T stride = 1) {
   verify_encode_one_positive(context, T(max));
 }
 
+template <typename T>
+void verify_encode_signed_exactly(const T value) {
+  encode_context context;
+  encode_signed_integer(context, value);
+  BOOST_CHECK_EQUAL(std::string(context.data(), context.size()), std::to_string(value));
+}
+
+template <typename T>
+void verify_encode_positive_exactly(const T value) {
+  encode_context context;
+  encode_positive_integer(context, value);
+  BOOST_CHECK_EQUAL(std::string(context.data(), context.size()), std::to_string(value));
+}
+
 }  // namespace
 
+BOOST_AUTO_TEST_CASE(json_encode_integer_should_write_every_number_of_digits) {
+  uint64_t power_of_10 = 1;
+  for (int i = 0; i < 20; i++, power_of_10 *= 10) {
+    for (const auto value : { power_of_10 - 1, power_of_10, power_of_10 + 1 }) {
+      verify_encode_positive_exactly(value);
+      verify_encode_positive_exactly(static_cast<uint32_t>(value));
+      verify_encode_signed_exactly(static_cast<int64_t>(value));
+      verify_encode_signed_exactly(-static_cast<int64_t>(value));
+      verify_encode_signed_exactly(static_cast<int32_t>(value));
+      verify_encode_signed_exactly(-static_cast<int32_t>(value));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_encode_integer_should_write_sign_of_signed_integers) {
+  verify_encode_signed_exactly<int8_t>(std::numeric_limits<int8_t>::min());
+  verify_encode_signed_exactly<int8_t>(std::numeric_limits<int8_t>::max());
+  verify_encode_signed_exactly<int32_t>(std::numeric_limits<int32_t>::min());
+  verify_encode_signed_exactly<int32_t>(std::numeric_limits<int32_t>::max());
+  verify_encode_signed_exactly<int64_t>(std::numeric_limits<int64_t>::min());
+  verify_encode_signed_exactly<int64_t>(std::numeric_limits<int64_t>::max());
+  verify_encode_signed_exactly<int64_t>(-1);
+  verify_encode_signed_exactly<int64_t>(0);
+}
+
 BOOST_AUTO_TEST_CASE(json_encode_integer_int8_t) {
   verify_encode_all_negative<int8_t>();
   verify_encode_all_positive<int8_t>();
@@ -24,6 +24,8 @@
 #include <spotify/json/decode_exception.hpp>
 #include <spotify/json/encoded_value.hpp>
 
+#include <spotify/json/test/exceptions.hpp>
+
 BOOST_AUTO_TEST_SUITE(spotify)
 BOOST_AUTO_TEST_SUITE(json)
 
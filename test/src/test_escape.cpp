@@ -23,6 +23,8 @@
 
 #include <spotify/json/detail/escape.hpp>
 
+#include <spotify/json/test/instruction_sets.hpp>
+
 BOOST_AUTO_TEST_SUITE(spotify)
 BOOST_AUTO_TEST_SUITE(json)
 BOOST_AUTO_TEST_SUITE(detail)
@@ -31,9 +33,11 @@ using namespace std;
 using namespace boost;
 
 void check_escaped(const std::string &expected, const std::string &input) {
-  encode_context context;
-  write_escaped(context, input.data(), input.data() + input.size());
-  BOOST_CHECK_EQUAL(expected, std::string(context.data(), context.size()));
+  for_each_instruction_set([&] {
+    encode_context context;
+    write_escaped(context, input.data(), input.data() + input.size());
+    BOOST_CHECK_EQUAL(expected, std::string(context.data(), context.size()));
+  });
 }
 
 BOOST_AUTO_TEST_CASE(json_write_escaped_should_escape_special_characters) {
@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2018 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/detail/field_registry.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+BOOST_AUTO_TEST_SUITE(detail)
+
+namespace {
+
+void save(field_registry &registry, const std::string &name, bool required, int value) {
+  registry.save(name, required, std::make_shared<const int>(value), sizeof(int), nullptr, nullptr, nullptr, nullptr);
+}
+
+int field_value(const field_registry::entry *field) {
+  return *static_cast<const int *>(field->field);
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(json_field_registry_should_find_saved_fields) {
+  field_registry registry;
+  save(registry, "a", false, 1);
+  save(registry, "bb", false, 2);
+  save(registry, "cc", true, 3);
+  save(registry, "", false, 4);
+
+  BOOST_REQUIRE(registry.find("a"));
+  BOOST_REQUIRE(registry.find("bb"));
+  BOOST_REQUIRE(registry.find("cc"));
+  BOOST_REQUIRE(registry.find(""));
+  BOOST_CHECK_EQUAL(field_value(registry.find("a")), 1);
+  BOOST_CHECK_EQUAL(field_value(registry.find("bb")), 2);
+  BOOST_CHECK_EQUAL(field_value(registry.find("cc")), 3);
+  BOOST_CHECK_EQUAL(field_value(registry.find("")), 4);
+  BOOST_CHECK_EQUAL(registry.num_required_fields(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(json_field_registry_should_not_find_unknown_fields) {
+  field_registry registry;
+  BOOST_CHECK(!registry.find("a"));
+
+  save(registry, "ab", false, 1);
+  BOOST_CHECK(!registry.find("a"));
+  BOOST_CHECK(!registry.find("aa"));
+  BOOST_CHECK(!registry.find("ac"));
+  BOOST_CHECK(!registry.find("abc"));
+  BOOST_CHECK(!registry.find("a much longer name than any field"));
+}
+
+BOOST_AUTO_TEST_CASE(json_field_registry_should_find_non_terminated_names) {
+  field_registry registry;
+  save(registry, "abc", false, 1);
+  save(registry, "ab", false, 2);
+
+  const char input[] = "abcdef";
+  BOOST_CHECK_EQUAL(field_value(registry.find(input, 3)), 1);
+  BOOST_CHECK_EQUAL(field_value(registry.find(input, 2)), 2);
+  BOOST_CHECK(!registry.find(input, 1));
+  BOOST_CHECK(!registry.find(input, 4));
+}
+
+BOOST_AUTO_TEST_CASE(json_field_registry_should_ignore_duplicate_fields) {
+  field_registry registry;
+  save(registry, "a", true, 1);
+  save(registry, "a", true, 2);
+
+  BOOST_CHECK_EQUAL(field_value(registry.find("a")), 1);
+  BOOST_CHECK_EQUAL(registry.num_required_fields(), 1);
+  BOOST_CHECK_EQUAL(std::distance(registry.begin(), registry.end()), 1);
+}
+
+BOOST_AUTO_TEST_CASE(json_field_registry_should_find_many_fields_of_same_length) {
+  field_registry registry;
+  for (int i = 999; i >= 0; i--) {
+    save(registry, std::to_string(1000 + i), false, i);
+  }
+
+  for (int i = 0; i < 1000; i++) {
+    const auto *field = registry.find(std::to_string(1000 + i));
+    BOOST_REQUIRE(field);
+    BOOST_CHECK_EQUAL(field_value(field), i);
+  }
+
+  BOOST_CHECK(!registry.find("0999"));
+  BOOST_CHECK(!registry.find("2000"));
+}
+
+BOOST_AUTO_TEST_CASE(json_field_registry_should_iterate_in_insertion_order) {
+  field_registry registry;
+  save(registry, "b", false, 1);
+  save(registry, "a", false, 2);
+  save(registry, "c\"", false, 3);
+
+  std::vector<std::string> escaped_keys;
+  for (const auto &field : registry) {
+    escaped_keys.push_back(field.escaped_key);
+  }
+
+  BOOST_REQUIRE_EQUAL(escaped_keys.size(), 3);
+  BOOST_CHECK_EQUAL(escaped_keys[0], "\"b\":");
+  BOOST_CHECK_EQUAL(escaped_keys[1], "\"a\":");
+  BOOST_CHECK_EQUAL(escaped_keys[2], "\"c\\\"\":");
+}
+
+BOOST_AUTO_TEST_CASE(json_field_registry_should_assign_required_field_indices) {
+  field_registry registry;
+  save(registry, "a", true, 1);
+  save(registry, "b", false, 2);
+  save(registry, "a", true, 3);
+  save(registry, "c", true, 4);
+
+  BOOST_CHECK_EQUAL(registry.find("a")->required_field_idx, 0);
+  BOOST_CHECK(!registry.find("b")->is_required());
+  BOOST_CHECK_EQUAL(registry.find("c")->required_field_idx, 1);
+}
+
+BOOST_AUTO_TEST_CASE(json_field_registry_should_copy_table_on_write) {
+  field_registry registry;
+  save(registry, "a", true, 1);
+
+  auto copy = registry;
+  BOOST_CHECK_EQUAL(copy.begin(), registry.begin());
+
+  save(copy, "b", true, 2);
+  BOOST_CHECK_EQUAL(copy.size(), 2);
+  BOOST_CHECK_EQUAL(copy.num_required_fields(), 2);
+  BOOST_CHECK_EQUAL(field_value(copy.find("a")), 1);
+  BOOST_CHECK_EQUAL(field_value(copy.find("b")), 2);
+  BOOST_CHECK_EQUAL(registry.size(), 1);
+  BOOST_CHECK_EQUAL(registry.num_required_fields(), 1);
+  BOOST_CHECK(!registry.find("b"));
+}
+
+BOOST_AUTO_TEST_CASE(json_field_registry_should_report_memory_footprint) {
+  field_registry registry;
+  const auto empty_footprint = registry.memory_footprint();
+  BOOST_CHECK_EQUAL(empty_footprint, sizeof(field_registry));
+
+  save(registry, "a", false, 1);
+  const auto footprint = registry.memory_footprint();
+  BOOST_CHECK_GT(footprint, empty_footprint + sizeof(field_registry::entry));
+
+  save(registry, std::string(100, 'b'), false, 2);
+  BOOST_CHECK_GT(registry.memory_footprint(), footprint + 2 * 100);
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // detail
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/fixed_precision.hpp>
+#include <spotify/json/codec/object.hpp>
+#include <spotify/json/decode.hpp>
+#include <spotify/json/decode_exception.hpp>
+#include <spotify/json/encode.hpp>
+#include <spotify/json/encode_exception.hpp>
+
+#include <spotify/json/test/exceptions.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+BOOST_AUTO_TEST_SUITE(codec)
+
+namespace {
+
+struct position {
+  double latitude;
+  double longitude;
+};
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(json_codec_fixed_precision_should_construct) {
+  fixed_precision_t<double>(0);
+  fixed_precision_t<float>(fixed_precision_t<float>::max_decimals);
+  fixed_precision<double>(3);
+  fixed_precision<float>(6);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_fixed_precision_should_not_construct_with_too_many_decimals) {
+  BOOST_CHECK_THROW(fixed_precision<double>(18), std::invalid_argument);
+}
+
+/*
+ * Decoding
+ */
+
+BOOST_AUTO_TEST_CASE(json_codec_fixed_precision_should_decode_like_number) {
+  BOOST_CHECK_EQUAL(decode(fixed_precision<double>(3), "1.23456"), 1.23456);
+  BOOST_CHECK_EQUAL(decode(fixed_precision<float>(3), "-1.1e3"), -1.1e3f);
+  BOOST_CHECK_THROW(decode(fixed_precision<double>(3), "a"), decode_exception);
+}
+
+/*
+ * Encoding
+ */
+
+BOOST_AUTO_TEST_CASE(json_codec_fixed_precision_should_encode_rounded_value) {
+  const auto codec = fixed_precision<double>(3);
+  BOOST_CHECK_EQUAL(encode(codec, 1.23456), "1.235");
+  BOOST_CHECK_EQUAL(encode(codec, -1.23449), "-1.234");
+  BOOST_CHECK_EQUAL(encode(codec, 0.001), "0.001");
+  BOOST_CHECK_EQUAL(encode(codec, 0.0123), "0.012");
+  BOOST_CHECK_EQUAL(encode(codec, 1234567.8916), "1234567.892");
+  BOOST_CHECK_EQUAL(encode(codec, 0.9999), "1");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_fixed_precision_should_not_encode_trailing_zeros) {
+  const auto codec = fixed_precision<double>(6);
+  BOOST_CHECK_EQUAL(encode(codec, 1.5), "1.5");
+  BOOST_CHECK_EQUAL(encode(codec, 100.0), "100");
+  BOOST_CHECK_EQUAL(encode(codec, 0.25), "0.25");
+  BOOST_CHECK_EQUAL(encode(codec, 18.0685808), "18.068581");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_fixed_precision_should_encode_zero_without_sign) {
+  const auto codec = fixed_precision<double>(3);
+  BOOST_CHECK_EQUAL(encode(codec, 0.0), "0");
+  BOOST_CHECK_EQUAL(encode(codec, -0.0), "0");
+  BOOST_CHECK_EQUAL(encode(codec, -0.0004), "0");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_fixed_precision_should_encode_without_decimals) {
+  const auto codec = fixed_precision<double>(0);
+  BOOST_CHECK_EQUAL(encode(codec, 2.5), "3");
+  BOOST_CHECK_EQUAL(encode(codec, -1234.4), "-1234");
+  BOOST_CHECK_EQUAL(encode(codec, 1e18), "1000000000000000000");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_fixed_precision_should_encode_float) {
+  const auto codec = fixed_precision<float>(2);
+  BOOST_CHECK_EQUAL(encode(codec, 0.1f), "0.1");
+  BOOST_CHECK_EQUAL(encode(codec, 3.14159f), "3.14");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_fixed_precision_should_encode_large_values_as_number) {
+  const auto codec = fixed_precision<double>(3);
+  BOOST_CHECK_EQUAL(encode(codec, 1e16), "10000000000000000");
+  BOOST_CHECK_EQUAL(encode(codec, -1.5e300), "-1.5e+300");
+  BOOST_CHECK_EQUAL(encode(fixed_precision<float>(3), 3.25e30f), "3.25e+30");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_fixed_precision_should_encode_within_precision) {
+  const auto codec = fixed_precision<double>(4);
+  for (auto value = -100.0; value < 100.0; value += 0.123456789) {
+    BOOST_CHECK_LE(std::fabs(decode(codec, encode(codec, value)) - value), 0.00005);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_fixed_precision_should_encode_object_fields) {
+  object_t<position> codec;
+  codec.required("lat", &position::latitude, fixed_precision<double>(6));
+  codec.required("lng", &position::longitude, fixed_precision<double>(6));
+  BOOST_CHECK_EQUAL(encode(codec, position{ 59.32932349, 18.0685808 }), R"({"lat":59.329323,"lng":18.068581})");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_fixed_precision_should_not_encode_special_values) {
+  BOOST_CHECK_THROW(encode(fixed_precision<double>(3), NAN), encode_exception);
+  BOOST_CHECK_THROW(encode(fixed_precision<float>(3), INFINITY), encode_exception);
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // codec
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
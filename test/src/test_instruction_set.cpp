@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+
+#include <string>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/decode.hpp>
+#include <spotify/json/decode_context.hpp>
+#include <spotify/json/encode.hpp>
+#include <spotify/json/encode_context.hpp>
+#include <spotify/json/instruction_set.hpp>
+
+#include <spotify/json/test/instruction_sets.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+
+BOOST_AUTO_TEST_CASE(json_instruction_set_should_have_name) {
+  BOOST_CHECK_EQUAL(instruction_set_name(instruction_set::scalar), "scalar");
+  BOOST_CHECK_EQUAL(instruction_set_name(instruction_set::sse42), "sse42");
+  BOOST_CHECK_EQUAL(instruction_set_name(instruction_set::avx2), "avx2");
+  BOOST_CHECK_EQUAL(instruction_set_name(instruction_set::avx512bw), "avx512bw");
+}
+
+BOOST_AUTO_TEST_CASE(json_instruction_set_should_always_support_scalar) {
+  BOOST_CHECK(is_instruction_set_supported(instruction_set::scalar));
+}
+
+BOOST_AUTO_TEST_CASE(json_instruction_set_should_be_supported_when_active) {
+  BOOST_CHECK(is_instruction_set_supported(active_instruction_set()));
+}
+
+BOOST_AUTO_TEST_CASE(json_instruction_set_should_be_forced_and_restored) {
+  const auto original = active_instruction_set();
+  BOOST_REQUIRE(use_instruction_set(instruction_set::scalar));
+  BOOST_CHECK(active_instruction_set() == instruction_set::scalar);
+  BOOST_REQUIRE(use_instruction_set(original));
+  BOOST_CHECK(active_instruction_set() == original);
+}
+
+BOOST_AUTO_TEST_CASE(json_instruction_set_should_not_use_unsupported) {
+  const auto original = active_instruction_set();
+  for (const auto isa : { instruction_set::sse42, instruction_set::avx2, instruction_set::avx512bw }) {
+    if (!is_instruction_set_supported(isa)) {
+      BOOST_CHECK(!use_instruction_set(isa));
+      BOOST_CHECK(active_instruction_set() == original);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_instruction_set_should_decode_and_encode_with_any) {
+  const std::string text(100, 'x');
+  const auto json = "  \"" + text + "\\n\"  ";
+  for_each_instruction_set([&] {
+    BOOST_CHECK_EQUAL(decode<std::string>(json), text + "\n");
+    BOOST_CHECK_EQUAL(encode(text + "\n"), "\"" + text + "\\n\"");
+  });
+}
+
+json_begin_deprecated_definitions
+BOOST_AUTO_TEST_CASE(json_instruction_set_should_be_reported_by_deprecated_context_members) {
+  for_each_instruction_set([&] {
+    const auto has_sse42 = (active_instruction_set() != instruction_set::scalar);
+    BOOST_CHECK_EQUAL(decode_context(nullptr, nullptr).has_sse42, has_sse42);
+    BOOST_CHECK_EQUAL(encode_context().has_sse42, has_sse42);
+  });
+}
+json_end_deprecated_definitions
+
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
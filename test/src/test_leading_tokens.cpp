@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec.hpp>
+#include <spotify/json/detail/leading_tokens.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+BOOST_AUTO_TEST_SUITE(detail)
+
+namespace {
+
+struct custom_codec_t {
+  using object_type = int;
+  object_type decode(decode_context &) const { return 0; }
+  void encode(encode_context &, const object_type) const {}
+};
+
+struct custom_obj {
+  int value;
+};
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(json_token_of_should_classify_first_character) {
+  BOOST_CHECK_EQUAL(token_of('{'), token_object);
+  BOOST_CHECK_EQUAL(token_of('['), token_array);
+  BOOST_CHECK_EQUAL(token_of('"'), token_string);
+  BOOST_CHECK_EQUAL(token_of('t'), token_true);
+  BOOST_CHECK_EQUAL(token_of('f'), token_false);
+  BOOST_CHECK_EQUAL(token_of('n'), token_null);
+  for (const auto c : std::string("-+.0123456789")) {
+    BOOST_CHECK_EQUAL(token_of(c), token_number);
+  }
+  for (const auto c : std::string(" }]:,xN\0", 8)) {
+    BOOST_CHECK_EQUAL(token_of(c), token_other);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_peek_token_should_not_consume_input) {
+  const std::string json = "[1]";
+  const decode_context context(json.data(), json.data() + json.size());
+  BOOST_CHECK_EQUAL(peek_token(context), token_array);
+  BOOST_CHECK(context.position == json.data());
+}
+
+BOOST_AUTO_TEST_CASE(json_peek_token_should_report_end_of_input_as_other) {
+  const decode_context context(nullptr, nullptr);
+  BOOST_CHECK_EQUAL(peek_token(context), token_other);
+}
+
+BOOST_AUTO_TEST_CASE(json_leading_tokens_of_builtin_codecs) {
+  BOOST_CHECK_EQUAL(leading_tokens(default_codec<std::string>()), token_string);
+  BOOST_CHECK_EQUAL(leading_tokens(default_codec<int>()), token_number);
+  BOOST_CHECK_EQUAL(leading_tokens(default_codec<unsigned>()), token_number);
+  BOOST_CHECK_EQUAL(leading_tokens(default_codec<double>()), token_number);
+  BOOST_CHECK_EQUAL(leading_tokens(default_codec<bool>()), token_boolean);
+  BOOST_CHECK_EQUAL(leading_tokens(default_codec<std::vector<int>>()), token_array);
+  BOOST_CHECK_EQUAL(leading_tokens(default_codec<std::tuple<int>>()), token_array);
+  BOOST_CHECK_EQUAL(leading_tokens(default_codec<std::map<std::string, int>>()), token_object);
+  BOOST_CHECK_EQUAL(leading_tokens(codec::object<custom_obj>()), token_object);
+  BOOST_CHECK_EQUAL(leading_tokens(codec::null<int>()), token_null);
+  BOOST_CHECK_EQUAL(leading_tokens(codec::omit<int>()), 0);
+}
+
+BOOST_AUTO_TEST_CASE(json_leading_tokens_of_wrapping_codecs) {
+  BOOST_CHECK_EQUAL(leading_tokens(default_codec<std::shared_ptr<int>>()), token_number);
+  BOOST_CHECK_EQUAL(leading_tokens(codec::eq(1)), token_number);
+  BOOST_CHECK_EQUAL(leading_tokens(codec::empty_as_null(codec::string())), token_null | token_string);
+  BOOST_CHECK_EQUAL(
+      leading_tokens(codec::one_of(codec::string(), codec::eq<std::string>("a"), codec::null<std::string>())),
+      token_null | token_string);
+}
+
+BOOST_AUTO_TEST_CASE(json_leading_tokens_should_default_to_any) {
+  BOOST_CHECK_EQUAL(leading_tokens(custom_codec_t()), token_any);
+  BOOST_CHECK_EQUAL(leading_tokens(codec::ignore<int>()), token_any);
+  BOOST_CHECK_EQUAL(leading_tokens(codec::one_of(codec::number<int>(), custom_codec_t())), token_any);
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // detail
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
@@ -14,7 +14,9 @@
  * the License.
  */
 
+#include <map>
 #include <string>
+#include <unordered_map>
 
 #include <boost/test/unit_test.hpp>
 
@@ -24,6 +26,7 @@
 #include <spotify/json/decode.hpp>
 #include <spotify/json/encode.hpp>
 
+#include <spotify/json/test/exceptions.hpp>
 #include <spotify/json/test/only_true.hpp>
 
 BOOST_AUTO_TEST_SUITE(spotify)
@@ -138,6 +141,20 @@ BOOST_AUTO_TEST_CASE(json_codec_map_should_respect_should_encode) {
   BOOST_CHECK_EQUAL(encode(codec, map), R"({"a":true})");
 }
 
+/*
+ * Decoding Into Existing Maps
+ */
+
+BOOST_AUTO_TEST_CASE(json_codec_map_should_decode_into_existing_map) {
+  std::map<std::string, bool> values = { { "a", false }, { "b", true } };
+  decode_into(R"({"b":false,"c":true})", values);
+  BOOST_CHECK(values == (std::map<std::string, bool>{ { "b", false }, { "c", true } }));
+
+  std::unordered_map<std::string, bool> unordered_values = { { "a", false } };
+  decode_into(R"({"b":true})", unordered_values);
+  BOOST_CHECK(unordered_values == (std::unordered_map<std::string, bool>{ { "b", true } }));
+}
+
 BOOST_AUTO_TEST_SUITE_END()  // codec
 BOOST_AUTO_TEST_SUITE_END()  // json
 BOOST_AUTO_TEST_SUITE_END()  // spotify
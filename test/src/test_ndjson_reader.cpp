@@ -0,0 +1,257 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <unistd.h>
+#endif
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/codec/object.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/decode_exception.hpp>
+#include <spotify/json/ndjson_reader.hpp>
+
+#include <spotify/json/test/exceptions.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+
+namespace {
+
+struct event {
+  std::string name;
+  int count = 0;
+};
+
+codec::object_t<event> event_codec() {
+  auto codec = codec::object<event>();
+  codec.required("name", &event::name);
+  codec.optional("count", &event::count);
+  return codec;
+}
+
+/**
+ * A temporary file with the given contents, for reading with a file descriptor.
+ */
+class temporary_file final {
+ public:
+  explicit temporary_file(const std::string &contents)
+      : _file(std::tmpfile()) {
+    std::fwrite(contents.data(), 1, contents.size(), _file);
+    std::fflush(_file);
+    std::rewind(_file);
+  }
+
+  ~temporary_file() {
+    std::fclose(_file);
+  }
+
+  int fd() const {
+#if defined(_WIN32)
+    return _fileno(_file);
+#else
+    return fileno(_file);
+#endif
+  }
+
+ private:
+  std::FILE *_file;
+};
+
+std::vector<std::string> read_names(const std::string &ndjson, const size_t block_size) {
+  const temporary_file file(ndjson);
+  ndjson_reader<codec::object_t<event>> reader(event_codec(), file.fd(), block_size, 2);
+  std::vector<std::string> names;
+  event value;
+  while (reader.next(value)) {
+    names.push_back(value.name);
+  }
+  BOOST_CHECK(!reader.next(value));
+  return names;
+}
+
+void check_read_fails(const std::string &ndjson, const std::string &error, const size_t offset) {
+#if json_has_exceptions
+  for (size_t block_size = 1; block_size <= ndjson.size(); block_size++) {
+    const temporary_file file(ndjson);
+    ndjson_reader<codec::object_t<event>> reader(event_codec(), file.fd(), block_size, 2);
+    event value;
+    try {
+      while (reader.next(value)) {}
+      BOOST_ERROR("reading should have failed");
+    } catch (const decode_exception &exception) {
+      BOOST_CHECK_EQUAL(exception.what(), error);
+      BOOST_CHECK_EQUAL(exception.offset(), offset);
+    }
+  }
+#else
+  (void)ndjson;
+  (void)error;
+  (void)offset;
+#endif  // json_has_exceptions
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(json_ndjson_reader_should_read_records_across_blocks) {
+  const std::string ndjson =
+      "{\"name\":\"a\"}\n"
+      "{\"name\":\"b\\n\",\"count\":2}\r\n"
+      "\n"
+      "  {\"name\":\"c\"}  \n"
+      "{\"name\":\"d\"}";
+  const std::vector<std::string> expected = { "a", "b\n", "c", "d" };
+  for (size_t block_size = 1; block_size <= ndjson.size() + 1; block_size++) {
+    BOOST_TEST_CONTEXT("block size " << block_size) {
+      const auto names = read_names(ndjson, block_size);
+      BOOST_CHECK_EQUAL_COLLECTIONS(names.begin(), names.end(), expected.begin(), expected.end());
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_ndjson_reader_should_read_empty_files) {
+  BOOST_CHECK(read_names("", 16).empty());
+  BOOST_CHECK(read_names("\n \n\r\n", 16).empty());
+}
+
+BOOST_AUTO_TEST_CASE(json_ndjson_reader_should_read_file_at_path) {
+  const auto path = "json_ndjson_reader_test.ndjson";
+  {
+    const auto file = std::fopen(path, "wb");
+    std::fputs("[1,2]\n[3]\n", file);
+    std::fclose(file);
+  }
+  {
+    ndjson_reader<codec::array_t<std::vector<int>, codec::number_t<int>>> reader(
+        codec::array<std::vector<int>>(codec::number<int>()), path);
+    std::vector<int> value;
+    BOOST_REQUIRE(reader.next(value));
+    BOOST_CHECK_EQUAL(value.size(), 2);
+    BOOST_REQUIRE(reader.next(value));
+    BOOST_CHECK_EQUAL(value.size(), 1);
+    BOOST_CHECK(!reader.next(value));
+  }
+  std::remove(path);
+}
+
+BOOST_AUTO_TEST_CASE(json_ndjson_reader_should_fail_to_open_missing_file) {
+  BOOST_CHECK_THROW(
+      ndjson_reader<codec::object_t<event>>(event_codec(), "json_ndjson_reader_missing.ndjson"),
+      std::system_error);
+}
+
+#if !defined(_WIN32)
+
+BOOST_AUTO_TEST_CASE(json_ndjson_reader_should_read_from_pipe) {
+  int fds[2];
+  BOOST_REQUIRE_EQUAL(::pipe(fds), 0);
+  std::thread writer([&] {
+    const std::string ndjson = "{\"name\":\"a\"}\n{\"name\":\"b\"}\n";
+    for (const auto c : ndjson) {
+      if (::write(fds[1], &c, 1) != 1) {
+        break;
+      }
+    }
+    ::close(fds[1]);
+  });
+
+  std::vector<std::string> names;
+  {
+    ndjson_reader<codec::object_t<event>> reader(event_codec(), fds[0], 16, 2);
+    event value;
+    while (reader.next(value)) {
+      names.push_back(value.name);
+    }
+  }
+  writer.join();
+  ::close(fds[0]);
+  BOOST_CHECK(names == std::vector<std::string>({ "a", "b" }));
+}
+
+BOOST_AUTO_TEST_CASE(json_ndjson_reader_should_not_wait_for_full_block_from_pipe) {
+  int fds[2];
+  BOOST_REQUIRE_EQUAL(::pipe(fds), 0);
+  {
+    ndjson_reader<codec::object_t<event>> reader(event_codec(), fds[0], 1 << 20, 2);
+    BOOST_CHECK_EQUAL(::write(fds[1], "{\"name\":\"a\"}\n", 13), 13);
+    event value;
+    BOOST_REQUIRE(reader.next(value));  // The pipe stays open, far from a full block
+    BOOST_CHECK_EQUAL(value.name, "a");
+  }
+  ::close(fds[0]);
+  ::close(fds[1]);
+}
+
+BOOST_AUTO_TEST_CASE(json_ndjson_reader_should_not_wait_for_pipe_when_destroyed) {
+  int fds[2];
+  BOOST_REQUIRE_EQUAL(::pipe(fds), 0);
+  {
+    ndjson_reader<codec::object_t<event>> reader(event_codec(), fds[0], 16, 2);
+    BOOST_CHECK_EQUAL(::write(fds[1], "{\"name\":\"a\"}\n  \n", 16), 16);  // One block
+    event value;
+    BOOST_REQUIRE(reader.next(value));
+    BOOST_CHECK_EQUAL(value.name, "a");
+    // Give the read-ahead thread time to wait for the next block
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  }  // Nothing more is written, and the pipe is still open
+  ::close(fds[0]);
+  ::close(fds[1]);
+}
+
+#endif  // !defined(_WIN32)
+
+BOOST_AUTO_TEST_CASE(json_ndjson_reader_should_count_offsets_from_start_of_file) {
+  check_read_fails("{\"name\":\"a\"}\n{\"name\":1}\n", "Unexpected input", 21);
+  check_read_fails("{\"name\":\"a\"}\n{\"name\":\"b\"} x\n", "Unexpected trailing input", 26);
+  check_read_fails("{\"name\":\"a\"}\n{\"name\"", "Unexpected end of input", 20);
+  check_read_fails("{\"name\":\"a\n\"}\n", "Unterminated string", 10);
+}
+
+#if json_has_exceptions
+
+BOOST_AUTO_TEST_CASE(json_ndjson_reader_should_read_records_after_failed_record) {
+  const std::string ndjson = "{\"name\":\"a\"}\n{\"count\":2,\"name\":1}\n{\"name\":\"c\"}\n";
+  for (size_t block_size = 1; block_size <= ndjson.size(); block_size++) {
+    BOOST_TEST_CONTEXT("block size " << block_size) {
+      const temporary_file file(ndjson);
+      ndjson_reader<codec::object_t<event>> reader(event_codec(), file.fd(), block_size, 2);
+      event value;
+      BOOST_REQUIRE(reader.next(value));
+      BOOST_CHECK_EQUAL(value.name, "a");
+      BOOST_CHECK_THROW(reader.next(value), decode_exception);
+      BOOST_CHECK_EQUAL(value.name, "a");  // Not overwritten by the failed record
+      BOOST_CHECK_EQUAL(value.count, 0);
+      BOOST_REQUIRE(reader.next(value));
+      BOOST_CHECK_EQUAL(value.name, "c");
+      BOOST_CHECK(!reader.next(value));
+    }
+  }
+}
+
+#endif  // json_has_exceptions
+
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <string>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/detail/nesting.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+BOOST_AUTO_TEST_SUITE(detail)
+
+namespace {
+
+size_t too_deep_offset(const std::string &string, const size_t max_depth) {
+  return find_too_deep_nesting(string.data(), string.data() + string.size(), max_depth) - string.data();
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(json_find_too_deep_nesting_should_accept_shallow_values) {
+  for (const std::string string : { "", "1", " \"[[[\" ", "[]", "[[1],{}]", " {\"a\":[1]} ", "[\"[[\"]" }) {
+    BOOST_CHECK_EQUAL(too_deep_offset(string, 2), string.size());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_find_too_deep_nesting_should_find_first_bracket_that_is_too_deep) {
+  BOOST_CHECK_EQUAL(too_deep_offset("[[[1]]]", 2), 2);
+  BOOST_CHECK_EQUAL(too_deep_offset(" [ [ [1]]]", 2), 5);
+  BOOST_CHECK_EQUAL(too_deep_offset(R"({"a":[{"b":1}]})", 2), 6);
+  BOOST_CHECK_EQUAL(too_deep_offset("[[1],[[2]]]", 2), 6);
+  BOOST_CHECK_EQUAL(too_deep_offset("[]", 0), 0);
+}
+
+BOOST_AUTO_TEST_CASE(json_find_too_deep_nesting_should_not_count_brackets_in_strings) {
+  BOOST_CHECK_EQUAL(too_deep_offset(R"(["[[", "\"[[", "\\", ["]"]])", 2), 27);
+  BOOST_CHECK_EQUAL(too_deep_offset(R"(["\"]", [[1]]])", 2), 9);
+}
+
+BOOST_AUTO_TEST_CASE(json_find_too_deep_nesting_should_stop_at_end_of_value) {
+  const std::string object = "{} [[[]]]";
+  const std::string number = "1 [[[]]]";
+  BOOST_CHECK_EQUAL(too_deep_offset(object, 2), object.size());
+  BOOST_CHECK_EQUAL(too_deep_offset(number, 2), number.size());
+}
+
+BOOST_AUTO_TEST_CASE(json_find_too_deep_nesting_should_stop_at_end_of_input) {
+  const std::string unterminated_string = "[\"[[[";
+  const std::string unterminated_escape = "[\"\\";
+  const std::string unterminated_array = "[[";
+  BOOST_CHECK_EQUAL(too_deep_offset(unterminated_string, 1), unterminated_string.size());
+  BOOST_CHECK_EQUAL(too_deep_offset(unterminated_escape, 1), unterminated_escape.size());
+  BOOST_CHECK_EQUAL(too_deep_offset(unterminated_array, 2), unterminated_array.size());
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // detail
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+// This test is only built with -fno-exceptions, together with the rest of the
+// suite, and checks that decoding reports failures through the decode_context
+// when exceptions are not available.
+
+#include <cstdlib>
+#include <exception>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json.hpp>
+
+#if json_has_exceptions
+#error "This test must be compiled with exceptions disabled"
+#endif
+
+// Boost defines BOOST_NO_EXCEPTIONS under -fno-exceptions and then expects the
+// program to provide boost::throw_exception. Nothing in the suite should get
+// there, so these just abort.
+namespace boost {
+
+struct source_location;
+
+void throw_exception(const std::exception &) {
+  std::abort();
+}
+
+void throw_exception(const std::exception &, const boost::source_location &) {
+  std::abort();
+}
+
+}  // namespace boost
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+
+namespace {
+
+struct example_t {
+  std::string name;
+  std::vector<int> values;
+  bool flag = false;
+};
+
+codec::object_t<example_t> example_codec() {
+  auto codec = codec::object<example_t>();
+  codec.required("name", &example_t::name);
+  codec.optional("values", &example_t::values);
+  codec.optional("flag", &example_t::flag);
+  return codec;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(json_no_exceptions_try_decode_should_decode) {
+  example_t example;
+  BOOST_REQUIRE(try_decode(example, example_codec(), R"({"name":"a","values":[1,2],"flag":true})"));
+  BOOST_CHECK_EQUAL(example.name, "a");
+  BOOST_REQUIRE_EQUAL(example.values.size(), 2);
+  BOOST_CHECK_EQUAL(example.values[1], 2);
+  BOOST_CHECK(example.flag);
+}
+
+BOOST_AUTO_TEST_CASE(json_no_exceptions_try_decode_should_report_errors) {
+  const std::string json = R"({"name":"a","values":[1,x]})";
+  decode_context context(json.data(), json.data() + json.size());
+  example_t example;
+  BOOST_CHECK(!try_decode(example, example_codec(), context));
+  BOOST_CHECK_EQUAL(context.error(), std::string("Invalid integer"));
+  BOOST_CHECK_EQUAL(context.error_offset(), 25);
+}
+
+BOOST_AUTO_TEST_CASE(json_no_exceptions_try_decode_should_report_missing_fields) {
+  example_t example;
+  BOOST_CHECK(!try_decode(example, example_codec(), R"({"values":[]})"));
+}
+
+BOOST_AUTO_TEST_CASE(json_no_exceptions_try_decode_should_fail_on_invalid_input) {
+  std::map<std::string, double> map;
+  BOOST_CHECK(!try_decode(map, ""));
+  BOOST_CHECK(!try_decode(map, "{"));
+  BOOST_CHECK(!try_decode(map, R"({"a":})"));
+  BOOST_CHECK(!try_decode(map, R"({"a":1,})"));
+  BOOST_CHECK(!try_decode(map, R"({"a":"\q"})"));
+  BOOST_CHECK(!try_decode(map, R"({"a":1} x)"));
+  BOOST_CHECK(try_decode(map, R"({"a":1.5})"));
+  BOOST_CHECK_EQUAL(map["a"], 1.5);
+}
+
+BOOST_AUTO_TEST_CASE(json_no_exceptions_one_of_should_fall_back) {
+  const auto codec = codec::one_of(codec::string(), codec::null<std::string>());
+  std::string value = "x";
+  BOOST_CHECK(try_decode(value, codec, "null"));
+  BOOST_CHECK_EQUAL(value, "");
+  BOOST_CHECK(!try_decode(value, codec, "1"));
+}
+
+BOOST_AUTO_TEST_CASE(json_no_exceptions_empty_as_should_fall_back) {
+  const auto codec = codec::empty_as_null(codec::number<int>());
+  int value = 1;
+  BOOST_CHECK(try_decode(value, codec, "null"));
+  BOOST_CHECK_EQUAL(value, 0);
+  BOOST_CHECK(!try_decode(value, codec, "\"a\""));
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
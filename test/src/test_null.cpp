@@ -23,6 +23,8 @@
 #include <spotify/json/decode.hpp>
 #include <spotify/json/encode.hpp>
 
+#include <spotify/json/test/exceptions.hpp>
+
 BOOST_AUTO_TEST_SUITE(spotify)
 BOOST_AUTO_TEST_SUITE(json)
 BOOST_AUTO_TEST_SUITE(codec)
@@ -14,7 +14,11 @@
  * the License.
  */
 
+#include <cmath>
 #include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
 #include <string>
 #include <vector>
 
@@ -26,6 +30,8 @@
 #include <spotify/json/encode.hpp>
 #include <spotify/json/encode_exception.hpp>
 
+#include <spotify/json/test/exceptions.hpp>
+
 BOOST_AUTO_TEST_SUITE(spotify)
 BOOST_AUTO_TEST_SUITE(json)
 BOOST_AUTO_TEST_SUITE(codec)
@@ -57,6 +63,106 @@ void test_decode_fail(const Codec &codec, const std::string &json) {
   BOOST_CHECK_THROW(codec.decode(c), decode_exception);
 }
 
+template <typename T>
+T decode_with_double_conversion(const std::string &json, int &bytes_read) {
+  using atod_converter = double_conversion::StringToDoubleConverter;
+  const atod_converter converter(
+      atod_converter::ALLOW_TRAILING_JUNK,
+      std::numeric_limits<T>::quiet_NaN(),
+      std::numeric_limits<T>::quiet_NaN(),
+      nullptr,
+      nullptr);
+  return detail::decode_floating_point<T>(converter, json.data(), static_cast<int>(json.size()), &bytes_read);
+}
+
+/**
+ * The floating point codecs decode most numbers without double-conversion, but
+ * must get the exact same results as if they had used it.
+ */
+template <typename T>
+void test_decode_like_double_conversion(const std::string &json) {
+  int bytes_read = 0;
+  const auto expected = decode_with_double_conversion<T>(json, bytes_read);
+  const auto actual = test_decode_dont_gobble(number<T>(), json, bytes_read);
+  BOOST_CHECK_MESSAGE(std::memcmp(&actual, &expected, sizeof(T)) == 0, json);
+}
+
+template <typename T>
+std::string encode_with_double_conversion(const T value);
+
+template <>
+std::string encode_with_double_conversion(const float value) {
+  using dtoa_converter = double_conversion::DoubleToStringConverter;
+  const dtoa_converter converter(
+      dtoa_converter::UNIQUE_ZERO | dtoa_converter::EMIT_POSITIVE_EXPONENT_SIGN,
+      nullptr, nullptr, 'e', -6, 21, 6, 0);
+  char buffer[32];
+  double_conversion::StringBuilder builder(buffer, sizeof(buffer));
+  converter.ToShortestSingle(value, &builder);
+  return std::string(buffer, builder.position());
+}
+
+template <>
+std::string encode_with_double_conversion(const double value) {
+  using dtoa_converter = double_conversion::DoubleToStringConverter;
+  const dtoa_converter converter(
+      dtoa_converter::UNIQUE_ZERO | dtoa_converter::EMIT_POSITIVE_EXPONENT_SIGN,
+      nullptr, nullptr, 'e', -6, 21, 6, 0);
+  char buffer[32];
+  double_conversion::StringBuilder builder(buffer, sizeof(buffer));
+  converter.ToShortest(value, &builder);
+  return std::string(buffer, builder.position());
+}
+
+/**
+ * The floating point codecs used to encode with double-conversion, and must
+ * still write exactly what it would have written.
+ */
+template <typename T>
+void test_encode_like_double_conversion(const T value) {
+  BOOST_CHECK_EQUAL(encode(number<T>(), value), encode_with_double_conversion(value));
+}
+
+template <typename T>
+void test_encode_like_double_conversion_randomly() {
+  std::mt19937_64 random(1);
+  for (auto i = 0; i < 100000; i++) {
+    const auto bits = random();
+    T value;
+    std::memcpy(&value, &bits, sizeof(T));
+    if (std::isfinite(value)) {
+      test_encode_like_double_conversion(value);
+    }
+    test_encode_like_double_conversion(static_cast<T>(static_cast<int>(random() % 100000)) / 100);
+  }
+}
+
+template <typename T>
+void test_decode_like_double_conversion_randomly() {
+  std::mt19937_64 random(1);
+  char buffer[32];
+  for (auto i = 0; i < 100000; i++) {
+    // Shortest, almost shortest and longer representations of random numbers
+    const auto bits = random();
+    T value;
+    std::memcpy(&value, &bits, sizeof(T));
+    if (std::isfinite(value)) {
+      const auto precision = static_cast<int>(random() % 20 + 1);
+      std::snprintf(buffer, sizeof(buffer), "%.*g", precision, static_cast<double>(value));
+      test_decode_like_double_conversion<T>(buffer);
+    }
+
+    // Numbers with few digits and a wide range of exponents
+    std::snprintf(
+        buffer, sizeof(buffer), "%s%u.%ue%d",
+        (random() % 2 ? "-" : ""),
+        static_cast<unsigned>(random() % 1000),
+        static_cast<unsigned>(random() % 1000),
+        static_cast<int>(random() % 700) - 350);
+    test_decode_like_double_conversion<T>(buffer);
+  }
+}
+
 }  // namespace
 
 BOOST_AUTO_TEST_CASE(json_codec_number_should_construct) {
@@ -116,6 +222,26 @@ BOOST_AUTO_TEST_CASE(json_codec_number_should_decode_with_rounding_errors) {
   BOOST_CHECK_EQUAL(test_decode(number<float>(), "1.1"), 1.1f);
 }
 
+BOOST_AUTO_TEST_CASE(json_codec_number_should_decode_like_double_conversion) {
+  const char *numbers[] = {
+      "0", "-0", "-0.0e10", "0e999999", "0.1", "-1.5E+3", "1e-7", "123456.789e-3",
+      "1234567890123456789", "12345678901234567890", "0.0000000000000000000001234567",
+      "9007199254740993", "9007199254740992.5", "16777217", "16777216.5", "7.038531e-26",
+      "1.7976931348623157e308", "1.7976931348623158e308", "1e308", "1e309", "1e400",
+      "2.2250738585072014e-308", "2.2250738585072011e-308", "4.9e-324", "1e-400",
+      "3.4028235e38", "3.4028236e38", "1.17549435e-38", "1e-45",
+      "01", "00.5", "1.", "1.e5", "1e", "1e+", "1.5e-", "1.5,", "2]", "-3e2}" };
+  for (const auto number : numbers) {
+    test_decode_like_double_conversion<float>(number);
+    test_decode_like_double_conversion<double>(number);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_number_should_decode_random_numbers_like_double_conversion) {
+  test_decode_like_double_conversion_randomly<float>();
+  test_decode_like_double_conversion_randomly<double>();
+}
+
 BOOST_AUTO_TEST_CASE(json_codec_number_should_not_decode_invalid_float_numbers) {
   test_decode_fail(number<double>(), "");
   test_decode_fail(number<double>(), " 1");
@@ -133,6 +259,43 @@ BOOST_AUTO_TEST_CASE(json_codec_number_should_encode_exactly) {
   BOOST_CHECK_EQUAL(encode(0.5f), "0.5");
 }
 
+BOOST_AUTO_TEST_CASE(json_codec_number_should_encode_shortest_representation) {
+  BOOST_CHECK_EQUAL(encode(0.1), "0.1");
+  BOOST_CHECK_EQUAL(encode(0.1f), "0.1");
+  BOOST_CHECK_EQUAL(encode(1.0 / 3), "0.3333333333333333");
+  BOOST_CHECK_EQUAL(encode(1.0f / 3), "0.33333334");
+  BOOST_CHECK_EQUAL(encode(5e-324), "5e-324");
+  BOOST_CHECK_EQUAL(encode(1.7976931348623157e308), "1.7976931348623157e+308");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_number_should_encode_with_exponent_only_when_very_small_or_large) {
+  BOOST_CHECK_EQUAL(encode(0.0), "0");
+  BOOST_CHECK_EQUAL(encode(-0.0), "0");
+  BOOST_CHECK_EQUAL(encode(-1.5), "-1.5");
+  BOOST_CHECK_EQUAL(encode(1e-6), "0.000001");
+  BOOST_CHECK_EQUAL(encode(1.5e-7), "1.5e-7");
+  BOOST_CHECK_EQUAL(encode(123e18), "123000000000000000000");
+  BOOST_CHECK_EQUAL(encode(1e21), "1e+21");
+  BOOST_CHECK_EQUAL(encode(-1.25e22f), "-1.25e+22");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_number_should_encode_like_double_conversion) {
+  for (auto e = -325; e <= 308; e++) {
+    const auto value = std::pow(10.0, e);
+    test_encode_like_double_conversion(value);
+    test_encode_like_double_conversion(std::nextafter(value, 0.0));
+    test_encode_like_double_conversion(std::nextafter(value, HUGE_VAL));
+    if (std::isfinite(static_cast<float>(value))) {
+      test_encode_like_double_conversion(static_cast<float>(value));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_number_should_encode_random_numbers_like_double_conversion) {
+  test_encode_like_double_conversion_randomly<float>();
+  test_encode_like_double_conversion_randomly<double>();
+}
+
 BOOST_AUTO_TEST_CASE(json_codec_number_should_not_encode_not_a_number) {
   BOOST_CHECK_THROW(encode(number<float>(), NAN), encode_exception);
   BOOST_CHECK_THROW(encode(number<double>(), NAN), encode_exception);
@@ -163,6 +326,26 @@ BOOST_AUTO_TEST_CASE(json_codec_number_should_decode_signed_negative_integer) {
   BOOST_CHECK_EQUAL(test_decode(number<int64_t>(), "-9223372036854775808"), INT64_MIN);
 }
 
+BOOST_AUTO_TEST_CASE(json_codec_number_should_decode_signed_integer_of_any_length) {
+  int64_t value = 0;
+  for (auto digit = 1; digit <= 18; digit++) {
+    value = value * 10 + (digit % 10);
+    const auto json = std::to_string(value);
+    BOOST_CHECK_EQUAL(test_decode(number<int64_t>(), json), value);
+    BOOST_CHECK_EQUAL(test_decode(number<int64_t>(), "-" + json), -value);
+    if (digit <= 11) {
+      BOOST_CHECK_EQUAL(
+          test_decode_dont_gobble(number<int64_t>(), json + "1234567,", json.size() + 7),
+          value * 10000000 + 1234567);
+    }
+    BOOST_CHECK_EQUAL(test_decode_dont_gobble(number<int64_t>(), json + "] 12345678", json.size()), value);
+    BOOST_CHECK_EQUAL(test_decode_dont_gobble(number<int64_t>(), json + "e0, 123456", json.size() + 2), value);
+  }
+  BOOST_CHECK_EQUAL(test_decode(number<int64_t>(), "1700000000000"), INT64_C(1700000000000));
+  BOOST_CHECK_EQUAL(test_decode(number<int64_t>(), "00000000000000000000000001"), 1);
+  BOOST_CHECK_EQUAL(test_decode(number<int64_t>(), "12345678901234567890e-5"), INT64_C(123456789012345));
+}
+
 BOOST_AUTO_TEST_CASE(json_codec_number_should_decode_signed_zero_integer_with_exponent) {
   BOOST_CHECK_EQUAL(test_decode(number<int8_t>(), "0e-1"), 0);
   BOOST_CHECK_EQUAL(test_decode(number<int16_t>(), "0E-1"), 0);
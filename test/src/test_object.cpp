@@ -14,18 +14,22 @@
  * the License.
  */
 
+#include <memory>
 #include <string>
 #include <vector>
 
 #include <boost/test/unit_test.hpp>
 
+#include <spotify/json/codec/array.hpp>
 #include <spotify/json/codec/boolean.hpp>
 #include <spotify/json/codec/object.hpp>
+#include <spotify/json/codec/smart_ptr.hpp>
 #include <spotify/json/codec/string.hpp>
 #include <spotify/json/decode.hpp>
 #include <spotify/json/default_codec.hpp>
 #include <spotify/json/encode.hpp>
 
+#include <spotify/json/test/exceptions.hpp>
 #include <spotify/json/test/only_true.hpp>
 
 BOOST_AUTO_TEST_SUITE(spotify)
@@ -144,6 +148,76 @@ BOOST_AUTO_TEST_CASE(json_codec_object_should_overwrite_duplicate_fields) {
   BOOST_CHECK_EQUAL(example.value, "hey2");
 }
 
+BOOST_AUTO_TEST_CASE(json_codec_object_should_decode_escaped_keys) {
+  const auto simple = test_decode(default_codec<simple_t>(), R"({"v\u0061lue":"hey","\u0073ize":1})");
+  BOOST_CHECK_EQUAL(simple.value, "hey");
+  BOOST_CHECK_EQUAL(simple.size, 1);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_object_should_decode_keys_with_escaped_characters) {
+  object_t<simple_t> codec;
+  codec.optional("a\"b", &simple_t::value);
+  codec.optional("a\nb", &simple_t::size);
+  const auto simple = test_decode(codec, R"({"a\"b":"hey","a\nb":5})");
+  BOOST_CHECK_EQUAL(simple.value, "hey");
+  BOOST_CHECK_EQUAL(simple.size, 5);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_object_should_skip_unknown_keys) {
+  const auto simple = test_decode(
+      default_codec<simple_t>(),
+      R"({"valuf":[1],"valu":{},"values":"x","\u0000":1,"size" : 7})");
+  BOOST_CHECK_EQUAL(simple.value, "");
+  BOOST_CHECK_EQUAL(simple.size, 7);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_object_should_not_decode_unterminated_keys) {
+  test_decode_fail(default_codec<simple_t>(), R"({"value)");
+  test_decode_fail(default_codec<simple_t>(), R"({"val\u00)");
+  test_decode_fail(default_codec<simple_t>(), R"({value:"x"})");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_object_should_decode_fields_in_any_order) {
+  object_t<simple_t> codec;
+  codec.optional("a", &simple_t::value);
+  codec.optional("ab", &simple_t::value);
+  codec.required("abc", &simple_t::size);
+
+  BOOST_CHECK_EQUAL(test_decode(codec, R"({"a":"x","ab":"y","abc":1})").value, "y");
+  BOOST_CHECK_EQUAL(test_decode(codec, R"({"abc":2,"ab":"y","a":"x"})").value, "x");
+  BOOST_CHECK_EQUAL(test_decode(codec, R"({"ab":"y","abc":3})").size, 3);
+  BOOST_CHECK_EQUAL(test_decode(codec, R"({"abc":4,"abc":5})").size, 5);
+  BOOST_CHECK_EQUAL(test_decode(codec, R"({ "a" : "x" , "a\u0062" : "y" , "abc" : 6 })").value, "y");
+  BOOST_CHECK_EQUAL(test_decode(codec, R"({"abcd":"x","abc":7,"b":"z","ab":"y"})").size, 7);
+  test_decode_fail(codec, R"({"a":"x","ab":"y"})");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_object_should_decode_after_first_key) {
+  const std::string json = R"({"value":"y" , "simple":{"value":"x"}})";
+  decode_context c(json.data() + 9, json.data() + json.size());
+  const auto example = example_codec().decode_after_first_key(c, "value", 5);
+  BOOST_CHECK_EQUAL(c.position, c.end);
+  BOOST_CHECK_EQUAL(example.value, "y");
+  BOOST_CHECK_EQUAL(example.simple.value, "x");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_object_should_skip_unknown_first_key_after_first_key) {
+  const std::string json = R"({"other":[1],"value":"y"})";
+  decode_context c(json.data() + 9, json.data() + json.size());
+  const auto example = example_codec().decode_after_first_key(c, "other", 5);
+  BOOST_CHECK_EQUAL(c.position, c.end);
+  BOOST_CHECK_EQUAL(example.value, "y");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_object_should_not_match_expected_key_past_end_of_input) {
+  object_t<simple_t> codec;
+  codec.optional("abc", &simple_t::value);
+
+  const std::string json = R"({"abc":"x"})";
+  test_decode_fail(codec, json.substr(0, 5));
+  test_decode_fail(codec, json.substr(0, 6));
+}
+
 BOOST_AUTO_TEST_CASE(json_codec_object_should_use_custom_creator_when_decoding) {
   object_t<example_t> codec([]{
     example_t value;
@@ -268,6 +342,167 @@ BOOST_AUTO_TEST_CASE(json_codec_object_should_encode_lambda_getter_field) {
   BOOST_CHECK_EQUAL(encode(codec, getset), R"({"value":"foobar"})");
 }
 
+/*
+ * Decoding Into Existing Objects
+ */
+
+BOOST_AUTO_TEST_CASE(json_codec_object_should_decode_into_existing_object) {
+  example_t example;
+  example.simple.size = 5;
+  example.simple.value = std::string(100, 'a');
+  example.value = "b";
+  const auto data = example.simple.value.data();
+
+  decode_into(example_codec(), R"({"simple":{"value":"x"},"value":"y"})", example);
+  BOOST_CHECK_EQUAL(example.simple.size, 0);  // not in the input, so reset
+  BOOST_CHECK_EQUAL(example.simple.value, "x");
+  BOOST_CHECK_EQUAL(example.simple.value.data(), data);
+  BOOST_CHECK_EQUAL(example.value, "y");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_object_should_decode_into_like_decode) {
+  struct message_t {
+    std::string a;
+    std::string b = "default";
+    std::vector<int> v;
+  };
+
+  codec::object_t<message_t> codec;
+  codec.required("a", &message_t::a);
+  codec.optional("b", &message_t::b);
+  codec.optional("v", &message_t::v);
+
+  message_t message;
+  decode_into(codec, R"({"a":"x","b":"y","v":[1,2]})", message);
+  const auto capacity = message.v.capacity();
+
+  decode_into(codec, R"({"a":"z"})", message);
+  const auto decoded = decode(codec, R"({"a":"z"})");
+  BOOST_CHECK_EQUAL(message.a, decoded.a);
+  BOOST_CHECK_EQUAL(message.b, decoded.b);
+  BOOST_CHECK_EQUAL(message.v.size(), decoded.v.size());
+  BOOST_CHECK_EQUAL(message.v.capacity(), capacity);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_object_should_reset_absent_fields_from_custom_creator) {
+  auto codec = object([]{ simple_t simple; simple.size = 7; return simple; });
+  codec.optional("size", &simple_t::size);
+  codec.optional("value", &simple_t::value);
+
+  simple_t simple;
+  decode_into(codec, R"({"size":1})", simple);
+  decode_into(codec, R"({"value":"x"})", simple);
+  BOOST_CHECK_EQUAL(simple.size, 7);
+  BOOST_CHECK_EQUAL(simple.value, "x");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_object_should_reset_absent_setter_fields) {
+  codec::object_t<getset_t> codec;
+  codec.optional("value", &getset_t::get_value, &getset_t::set_value);
+  codec::object_t<getset_t> lambda_codec;
+  lambda_codec.optional("value",
+                        [](const getset_t &x) { return x.get_value(); },
+                        [](getset_t &x, const std::string &value) { x.set_value(value); });
+
+  getset_t getset;
+  decode_into(codec, R"({"value":"x"})", getset);
+  decode_into(codec, R"({})", getset);
+  BOOST_CHECK_EQUAL(getset.get_value(), "");
+  decode_into(lambda_codec, R"({"value":"x"})", getset);
+  decode_into(lambda_codec, R"({})", getset);
+  BOOST_CHECK_EQUAL(getset.get_value(), "");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_object_should_decode_and_decode_into_move_only_fields) {
+  struct move_only_t {
+    std::unique_ptr<std::string> p;
+    std::unique_ptr<std::string> q;
+    std::vector<std::unique_ptr<int>> v;
+  };
+
+  codec::object_t<move_only_t> codec;
+  codec.optional("p", &move_only_t::p);
+  codec.optional("v", &move_only_t::v);
+  codec.optional("q",
+                 [](const move_only_t &x) -> const std::unique_ptr<std::string> & { return x.q; },
+                 [](move_only_t &x, std::unique_ptr<std::string> q) { x.q = std::move(q); });
+
+  auto decoded = test_decode(codec, R"({"p":"x","q":"y","v":[1]})");
+  BOOST_REQUIRE(decoded.p && decoded.q);
+  BOOST_REQUIRE_EQUAL(decoded.v.size(), 1);
+  BOOST_CHECK_EQUAL(*decoded.p, "x");
+  BOOST_CHECK_EQUAL(*decoded.q, "y");
+
+  decode_into(codec, R"({})", decoded);
+  BOOST_CHECK(!decoded.p);
+  BOOST_CHECK(!decoded.q);
+  BOOST_CHECK(decoded.v.empty());
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_object_should_decode_into_setter_field) {
+  getset_t getset;
+  decode_into(getset_codec(), R"({"value":"x"})", getset);
+  BOOST_CHECK_EQUAL(getset.get_value(), "x");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_object_should_require_required_fields_when_decoding_into) {
+  example_t example;
+  BOOST_CHECK_THROW(decode_into(example_codec(), R"({"simple":{}})", example), decode_exception);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_object_should_use_custom_creator_for_nested_objects) {
+  auto simple_codec = object([]{ simple_t simple; simple.size = 7; return simple; });
+  simple_codec.optional("value", &simple_t::value);
+  codec::object_t<example_t> codec;
+  codec.optional("simple", &example_t::simple, simple_codec);
+
+  BOOST_CHECK_EQUAL(test_decode(codec, R"({"simple":{}})").simple.size, 7);
+}
+
+/*
+ * Copying
+ */
+
+BOOST_AUTO_TEST_CASE(json_codec_object_should_not_share_fields_added_after_copy) {
+  codec::object_t<simple_t> codec;
+  codec.required("value", &simple_t::value);
+
+  auto copy = codec;
+  copy.required("size", &simple_t::size);
+
+  simple_t simple;
+  simple.size = 5;
+  simple.value = "x";
+  BOOST_CHECK_EQUAL(encode(codec, simple), R"({"value":"x"})");
+  BOOST_CHECK_EQUAL(encode(copy, simple), R"({"value":"x","size":5})");
+  BOOST_CHECK_EQUAL(test_decode(codec, R"({"value":"x"})").value, "x");
+  test_decode_fail(copy, R"({"value":"x"})");
+}
+
+/*
+ * Memory footprint
+ */
+
+BOOST_AUTO_TEST_CASE(json_codec_object_should_report_memory_footprint) {
+  codec::object_t<simple_t> codec;
+  const auto empty_footprint = codec.memory_footprint();
+  BOOST_CHECK_GE(empty_footprint, sizeof(codec));
+
+  codec.optional("value", &simple_t::value);
+  BOOST_CHECK_GT(codec.memory_footprint(), empty_footprint);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_object_should_include_nested_codecs_in_memory_footprint) {
+  const auto simple_codec = default_codec<simple_t>();
+
+  codec::object_t<example_t> with_object_codec;
+  with_object_codec.optional("simple", &example_t::simple, simple_codec);
+
+  BOOST_CHECK_GT(
+      with_object_codec.memory_footprint(),
+      simple_codec.memory_footprint() - sizeof(simple_codec));
+}
+
 BOOST_AUTO_TEST_SUITE_END()  // codec
 BOOST_AUTO_TEST_SUITE_END()  // json
 BOOST_AUTO_TEST_SUITE_END()  // spotify
@@ -19,6 +19,7 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <spotify/json/codec/eq.hpp>
 #include <spotify/json/codec/ignore.hpp>
 #include <spotify/json/codec/null.hpp>
 #include <spotify/json/codec/one_of.hpp>
@@ -27,6 +28,8 @@
 #include <spotify/json/decode.hpp>
 #include <spotify/json/encode.hpp>
 
+#include <spotify/json/test/exceptions.hpp>
+
 BOOST_AUTO_TEST_SUITE(spotify)
 BOOST_AUTO_TEST_SUITE(json)
 BOOST_AUTO_TEST_SUITE(codec)
@@ -51,6 +54,44 @@ struct example_t {
   std::string value;
 };
 
+struct throw_on_failure_recorder_t {
+  using object_type = std::string;
+
+  object_type decode(decode_context &context) const {
+    *observed = context.throw_on_failure;
+    return inner.decode(context);
+  }
+
+  void encode(encode_context &context, const object_type &value) const {
+    inner.encode(context, value);
+  }
+
+  string_t inner;
+  bool *observed;
+};
+
+struct token_recorder_t {
+  using object_type = std::string;
+
+  object_type decode(decode_context &context) const {
+    (*decode_count)++;
+    *observed = context.throw_on_failure;
+    return string_t().decode(context);
+  }
+
+  void encode(encode_context &context, const object_type &value) const {
+    string_t().encode(context, value);
+  }
+
+  detail::token_set leading_tokens() const {
+    return tokens;
+  }
+
+  detail::token_set tokens;
+  int *decode_count;
+  bool *observed;
+};
+
 }  // namespace
 
 /*
@@ -103,6 +144,78 @@ BOOST_AUTO_TEST_CASE(json_codec_one_of_should_fail_decode_if_all_fail) {
   test_decode_fail(codec, "{}");
 }
 
+BOOST_AUTO_TEST_CASE(json_codec_one_of_should_not_throw_when_trying_codecs) {
+  bool observed = true;
+  const auto codec = one_of(throw_on_failure_recorder_t{ string(), &observed }, null<std::string>());
+  BOOST_CHECK_EQUAL(test_decode(codec, "null"), "");
+  BOOST_CHECK(!observed);
+  test_decode_fail(codec, "1");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_one_of_should_report_last_error_when_not_throwing) {
+  const auto codec = one_of(string(), null<std::string>());
+  const std::string json = "nope";
+  decode_context c(json.c_str(), json.c_str() + json.size());
+  c.throw_on_failure = false;
+  codec.decode(c);
+  BOOST_CHECK(c.has_failed());
+  BOOST_CHECK_EQUAL(c.error(), std::string("Unexpected input"));
+  BOOST_CHECK_EQUAL(c.error_offset(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_one_of_should_skip_codecs_that_can_not_decode_token) {
+  int decode_count = 0;
+  bool observed = false;
+  const auto codec = one_of(
+      token_recorder_t{ detail::token_object, &decode_count, &observed },
+      string());
+  BOOST_CHECK_EQUAL(test_decode(codec, "\"a\""), "a");
+  BOOST_CHECK_EQUAL(decode_count, 0);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_one_of_should_not_try_only_candidate) {
+  int decode_count = 0;
+  bool observed = false;
+  const auto codec = one_of(
+      token_recorder_t{ detail::token_string, &decode_count, &observed },
+      null<std::string>());
+  BOOST_CHECK_EQUAL(test_decode(codec, "\"a\""), "a");
+  BOOST_CHECK_EQUAL(decode_count, 1);
+  BOOST_CHECK(observed);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_one_of_should_try_codecs_that_share_token) {
+  int decode_count = 0;
+  bool observed = true;
+  const auto codec = one_of(
+      token_recorder_t{ detail::token_string, &decode_count, &observed },
+      eq<std::string>("b"));
+  BOOST_CHECK_EQUAL(test_decode(codec, "\"a\""), "a");
+  BOOST_CHECK_EQUAL(decode_count, 1);
+  BOOST_CHECK(!observed);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_one_of_should_report_error_of_only_candidate) {
+  auto first = object<example_t>();
+  first.required("a", &example_t::value);
+
+  const auto codec = one_of(first, null<example_t>());
+  const std::string json = "{}";
+  decode_context c(json.c_str(), json.c_str() + json.size());
+  c.throw_on_failure = false;
+  codec.decode(c);
+  BOOST_CHECK_EQUAL(c.error(), std::string("Missing required field(s)"));
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_one_of_should_report_error_of_last_codec_if_none_match) {
+  const auto codec = one_of(string(), null<std::string>());
+  const std::string json = "[1,2]";
+  decode_context c(json.c_str(), json.c_str() + json.size());
+  c.throw_on_failure = false;
+  codec.decode(c);
+  BOOST_CHECK_EQUAL(c.error(), std::string("Unexpected input"));
+}
+
 BOOST_AUTO_TEST_CASE(json_codec_one_of_null) {
   const auto codec = one_of(string(), null<std::string>());
   BOOST_CHECK_EQUAL(test_decode(codec, "\"abc\""), "abc");
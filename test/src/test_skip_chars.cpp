@@ -16,11 +16,12 @@
 
 #include <cstdlib>
 
-#include <boost/mpl/list.hpp>
 #include <boost/test/unit_test.hpp>
 
 #include <spotify/json/detail/skip_chars.hpp>
 
+#include <spotify/json/test/instruction_sets.hpp>
+
 BOOST_AUTO_TEST_SUITE(spotify)
 BOOST_AUTO_TEST_SUITE(json)
 BOOST_AUTO_TEST_SUITE(detail)
@@ -38,12 +39,10 @@ std::string generate(const std::string &tpl, const std::size_t count) {
 
 template <void (*function)(decode_context &)>
 void verify_skip_any(
-    const bool use_sse,
     const std::string &json,
     const std::size_t prefix = 0,
     const std::size_t suffix = 0) {
   auto context = decode_context(json.data() + prefix, json.data() + json.size());
-  *const_cast<bool *>(&context.has_sse42) &= use_sse;
   const auto original_context = context;
   function(context);
   BOOST_CHECK_EQUAL(
@@ -54,111 +53,181 @@ void verify_skip_any(
       reinterpret_cast<intptr_t>(original_context.end));
 }
 
+/**
+ * Skip in the first size bytes of json, which must be followed by at least
+ * decode_padding bytes, and check that the skipping stopped at stop.
+ */
+template <void (*function)(decode_context &)>
+void verify_skip_padded(const std::string &json, const std::size_t size, const std::size_t stop) {
+  BOOST_REQUIRE_GE(json.size(), size + decode_padding);
+  auto context = decode_context(json.data(), json.data() + size, decode_context::padded_input_t());
+  function(context);
+  BOOST_CHECK_EQUAL(context.position - json.data(), stop);
+}
+
 template <void (*function)(decode_context &)>
-void verify_skip_empty_nullptr(const bool use_sse) {
+void verify_skip_empty_nullptr() {
   auto context = decode_context(nullptr, nullptr);
-  *const_cast<bool *>(&context.has_sse42) &= use_sse;
   function(context);
   BOOST_CHECK(context.position == nullptr);
   BOOST_CHECK(context.end == nullptr);
 }
 
-using true_false = boost::mpl::list<boost::true_type, boost::false_type>;
-
 }  // namespace
 
 /*
  * skip_any_simple_characters
  */
 
-BOOST_AUTO_TEST_CASE_TEMPLATE(json_skip_any_simple_characters, use_sse, true_false) {
-  for (auto n = 0; n < 1024; n++) {
-    const auto ws = generate("abcdefghIJKLMNOP:-,;'^¨´`xyz", n);
-    const auto with_prefix = "\\" + ws;
-    const auto with_suffix = ws + "\"abcde";
-    verify_skip_any<skip_any_simple_characters>(use_sse::value, ws);
-    verify_skip_any<skip_any_simple_characters>(use_sse::value, with_prefix, 1);
-    verify_skip_any<skip_any_simple_characters>(use_sse::value, with_suffix, 0, 6);
-  }
+BOOST_AUTO_TEST_CASE(json_skip_any_simple_characters) {
+  for_each_instruction_set([] {
+    for (auto n = 0; n < 1024; n++) {
+      const auto ws = generate("abcdefghIJKLMNOP:-,;'^¨´`xyz", n);
+      const auto with_prefix = "\\" + ws;
+      const auto with_suffix = ws + "\"abcde";
+      verify_skip_any<skip_any_simple_characters>(ws);
+      verify_skip_any<skip_any_simple_characters>(with_prefix, 1);
+      verify_skip_any<skip_any_simple_characters>(with_suffix, 0, 6);
+    }
+  });
 }
 
-BOOST_AUTO_TEST_CASE_TEMPLATE(json_skip_any_simple_characters_null_byte_in_string,
-                              use_sse,
-                              true_false) {
-  alignas(16) char input_data[17] = "a\0\"\"\"\"\"\"\"\"\"\"\"\"\"\"";
-  auto context = decode_context(input_data, input_data + 16);
-  *const_cast<bool *>(&context.has_sse42) &= use_sse::value;
-  skip_any_simple_characters(context);
-  BOOST_CHECK_EQUAL(context.position - input_data, 2);
+BOOST_AUTO_TEST_CASE(json_skip_any_simple_characters_null_byte_in_string) {
+  for_each_instruction_set([] {
+    alignas(16) char input_data[17] = "a\0\"\"\"\"\"\"\"\"\"\"\"\"\"\"";
+    auto context = decode_context(input_data, input_data + 16);
+    skip_any_simple_characters(context);
+    BOOST_CHECK_EQUAL(context.position - input_data, 2);
+  });
 }
 
-BOOST_AUTO_TEST_CASE_TEMPLATE(json_skip_any_simple_characters_with_empty_string,
-                              use_sse,
-                              true_false) {
-  verify_skip_empty_nullptr<skip_any_simple_characters>(use_sse::value);
+BOOST_AUTO_TEST_CASE(json_skip_any_simple_characters_should_stop_at_quote_or_backslash) {
+  for_each_instruction_set([] {
+    for (auto n = 0; n < 130; n++) {
+      for (const auto c : std::string("\"\\")) {
+        // Bytes with the high bit set must not be mistaken for either character.
+        const auto json = generate("a\xA2\xDC\xFF", n) + c + generate("\x80", 70);
+        verify_skip_any<skip_any_simple_characters>(json, 0, 71);
+      }
+    }
+  });
+}
+
+BOOST_AUTO_TEST_CASE(json_skip_any_simple_characters_with_padded_input) {
+  for_each_instruction_set([] {
+    for (auto n = 0; n < 130; n++) {
+      const auto simple = generate("abcdefghIJKLMNOP", n);
+      verify_skip_padded<skip_any_simple_characters>(simple + generate("a", 64), n, n);
+      verify_skip_padded<skip_any_simple_characters>(simple + generate("\"", 64), n, n);
+      verify_skip_padded<skip_any_simple_characters>(simple + "\\" + generate("a", 64), n + 1, n);
+    }
+  });
+}
+
+BOOST_AUTO_TEST_CASE(json_skip_any_simple_characters_with_empty_string) {
+  for_each_instruction_set([] {
+    verify_skip_empty_nullptr<skip_any_simple_characters>();
+  });
 }
 
 /*
  * skip_any_whitespace
  */
 
-BOOST_AUTO_TEST_CASE_TEMPLATE(json_skip_any_space, use_sse, true_false) {
-  for (auto n = 0; n < 1024; n++) {
-    const auto ws = generate(" ", n);
-    const auto with_prefix = "}" + ws;
-    const auto with_suffix = ws + "{ ";
-    verify_skip_any<skip_any_whitespace>(use_sse::value, ws);
-    verify_skip_any<skip_any_whitespace>(use_sse::value, with_prefix, 1);
-    verify_skip_any<skip_any_whitespace>(use_sse::value, with_suffix, 0, 2);
-  }
+BOOST_AUTO_TEST_CASE(json_skip_any_space) {
+  for_each_instruction_set([] {
+    for (auto n = 0; n < 1024; n++) {
+      const auto ws = generate(" ", n);
+      const auto with_prefix = "}" + ws;
+      const auto with_suffix = ws + "{ ";
+      verify_skip_any<skip_any_whitespace>(ws);
+      verify_skip_any<skip_any_whitespace>(with_prefix, 1);
+      verify_skip_any<skip_any_whitespace>(with_suffix, 0, 2);
+    }
+  });
 }
 
-BOOST_AUTO_TEST_CASE_TEMPLATE(json_skip_any_tabs, use_sse, true_false) {
-  for (auto n = 0; n < 1024; n++) {
-    const auto ws = generate("\t", n);
-    const auto with_prefix = "}" + ws;
-    const auto with_suffix = ws + "{ ";
-    verify_skip_any<skip_any_whitespace>(use_sse::value, ws);
-    verify_skip_any<skip_any_whitespace>(use_sse::value, with_prefix, 1);
-    verify_skip_any<skip_any_whitespace>(use_sse::value, with_suffix, 0, 2);
-  }
+BOOST_AUTO_TEST_CASE(json_skip_any_tabs) {
+  for_each_instruction_set([] {
+    for (auto n = 0; n < 1024; n++) {
+      const auto ws = generate("\t", n);
+      const auto with_prefix = "}" + ws;
+      const auto with_suffix = ws + "{ ";
+      verify_skip_any<skip_any_whitespace>(ws);
+      verify_skip_any<skip_any_whitespace>(with_prefix, 1);
+      verify_skip_any<skip_any_whitespace>(with_suffix, 0, 2);
+    }
+  });
 }
 
-BOOST_AUTO_TEST_CASE_TEMPLATE(json_skip_any_carriage_return, use_sse, true_false) {
-  for (auto n = 0; n < 1024; n++) {
-    const auto ws = generate("\r", n);
-    const auto with_prefix = "}" + ws;
-    const auto with_suffix = ws + "{ ";
-    verify_skip_any<skip_any_whitespace>(use_sse::value, ws);
-    verify_skip_any<skip_any_whitespace>(use_sse::value, with_prefix, 1);
-    verify_skip_any<skip_any_whitespace>(use_sse::value, with_suffix, 0, 2);
-  }
+BOOST_AUTO_TEST_CASE(json_skip_any_carriage_return) {
+  for_each_instruction_set([] {
+    for (auto n = 0; n < 1024; n++) {
+      const auto ws = generate("\r", n);
+      const auto with_prefix = "}" + ws;
+      const auto with_suffix = ws + "{ ";
+      verify_skip_any<skip_any_whitespace>(ws);
+      verify_skip_any<skip_any_whitespace>(with_prefix, 1);
+      verify_skip_any<skip_any_whitespace>(with_suffix, 0, 2);
+    }
+  });
 }
 
-BOOST_AUTO_TEST_CASE_TEMPLATE(json_skip_any_line_feed, use_sse, true_false) {
-  for (auto n = 0; n < 1024; n++) {
-    const auto ws = generate("\n", n);
-    const auto with_prefix = "}" + ws;
-    const auto with_suffix = ws + "{ ";
-    verify_skip_any<skip_any_whitespace>(use_sse::value, ws);
-    verify_skip_any<skip_any_whitespace>(use_sse::value, with_prefix, 1);
-    verify_skip_any<skip_any_whitespace>(use_sse::value, with_suffix, 0, 2);
-  }
+BOOST_AUTO_TEST_CASE(json_skip_any_line_feed) {
+  for_each_instruction_set([] {
+    for (auto n = 0; n < 1024; n++) {
+      const auto ws = generate("\n", n);
+      const auto with_prefix = "}" + ws;
+      const auto with_suffix = ws + "{ ";
+      verify_skip_any<skip_any_whitespace>(ws);
+      verify_skip_any<skip_any_whitespace>(with_prefix, 1);
+      verify_skip_any<skip_any_whitespace>(with_suffix, 0, 2);
+    }
+  });
 }
 
-BOOST_AUTO_TEST_CASE_TEMPLATE(json_skip_any_whitespace, use_sse, true_false) {
-  for (auto n = 0; n < 1024; n++) {
-    const auto ws = generate("\n\t\r\n", n);
-    const auto with_prefix = "}" + ws;
-    const auto with_suffix = ws + "{ ";
-    verify_skip_any<skip_any_whitespace>(use_sse::value, ws);
-    verify_skip_any<skip_any_whitespace>(use_sse::value, with_prefix, 1);
-    verify_skip_any<skip_any_whitespace>(use_sse::value, with_suffix, 0, 2);
-  }
+BOOST_AUTO_TEST_CASE(json_skip_any_whitespace) {
+  for_each_instruction_set([] {
+    for (auto n = 0; n < 1024; n++) {
+      const auto ws = generate("\n\t\r\n", n);
+      const auto with_prefix = "}" + ws;
+      const auto with_suffix = ws + "{ ";
+      verify_skip_any<skip_any_whitespace>(ws);
+      verify_skip_any<skip_any_whitespace>(with_prefix, 1);
+      verify_skip_any<skip_any_whitespace>(with_suffix, 0, 2);
+    }
+  });
+}
+
+BOOST_AUTO_TEST_CASE(json_skip_any_whitespace_should_stop_at_any_other_byte) {
+  for_each_instruction_set([] {
+    for (auto b = 0; b < 256; b++) {
+      const auto c = static_cast<char>(b);
+      if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+        continue;
+      }
+      for (const auto n : { 1, 31, 33, 63, 65, 100 }) {
+        verify_skip_any<skip_any_whitespace>(generate(" \t\r\n", n) + c + "  ", 0, 3);
+      }
+    }
+  });
+}
+
+BOOST_AUTO_TEST_CASE(json_skip_any_whitespace_with_padded_input) {
+  for_each_instruction_set([] {
+    for (auto n = 0; n < 130; n++) {
+      const auto ws = generate(" \t\r\n", n);
+      verify_skip_padded<skip_any_whitespace>(ws + generate(" ", 64), n, n);
+      verify_skip_padded<skip_any_whitespace>(ws + generate("x", 64), n, n);
+      verify_skip_padded<skip_any_whitespace>(ws + "{" + generate(" ", 64), n + 1, n);
+    }
+  });
 }
 
-BOOST_AUTO_TEST_CASE_TEMPLATE(json_skip_any_whitespace_with_empty_string, use_sse, true_false) {
-  verify_skip_empty_nullptr<skip_any_whitespace>(use_sse::value);
+BOOST_AUTO_TEST_CASE(json_skip_any_whitespace_with_empty_string) {
+  for_each_instruction_set([] {
+    verify_skip_empty_nullptr<skip_any_whitespace>();
+  });
 }
 
 BOOST_AUTO_TEST_SUITE_END()  // detail
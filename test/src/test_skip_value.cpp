@@ -18,6 +18,9 @@
 
 #include <spotify/json/detail/skip_value.hpp>
 
+#include <spotify/json/test/exceptions.hpp>
+#include <spotify/json/test/instruction_sets.hpp>
+
 BOOST_AUTO_TEST_SUITE(spotify)
 BOOST_AUTO_TEST_SUITE(json)
 BOOST_AUTO_TEST_SUITE(detail)
@@ -37,6 +40,27 @@ void verify_skip_value(const std::string &json, const size_t extra = 0) {
   BOOST_CHECK_EQUAL(context.end, original_context.end);
 }
 
+void verify_skip_trusted(const std::string &json, const size_t extra = 0) {
+  for_each_instruction_set([&]{
+    auto context = decode_context(json.data(), json.data() + json.size());
+    context.trusted_input = true;
+    skip_value(context);
+    BOOST_CHECK_EQUAL(context.position, context.end - extra);
+  });
+}
+
+void verify_skip_trusted_fail(const std::string &json, const std::string &error, const size_t offset) {
+  for_each_instruction_set([&]{
+    auto context = decode_context(json.data(), json.data() + json.size());
+    context.trusted_input = true;
+    context.throw_on_failure = false;
+    skip_value(context);
+    BOOST_CHECK(context.has_failed());
+    BOOST_CHECK_EQUAL(context.error(), error);
+    BOOST_CHECK_EQUAL(context.error_offset(), offset);
+  });
+}
+
 }  // namespace
 
 BOOST_AUTO_TEST_CASE(json_skip_value_string) {
@@ -98,6 +122,58 @@ BOOST_AUTO_TEST_CASE(json_skip_value_nested_object) {
   verify_skip_value(R"({"a":[{},[]]})");
 }
 
+BOOST_AUTO_TEST_CASE(json_skip_value_trusted_containers) {
+  verify_skip_trusted("[]");
+  verify_skip_trusted("{}");
+  verify_skip_trusted("[{},[1],[[1]]]");
+  verify_skip_trusted(R"({"a":[{},[]]})");
+  verify_skip_trusted(R"({ "a" : 3 , "b" : 4 } , 5)", 4);
+  verify_skip_trusted(R"([1], [2])", 5);
+}
+
+BOOST_AUTO_TEST_CASE(json_skip_value_trusted_should_ignore_brackets_in_strings) {
+  verify_skip_trusted(R"(["]"])");
+  verify_skip_trusted(R"({"}":"{[["})");
+  verify_skip_trusted(R"(["\"]"])");
+  verify_skip_trusted(R"(["\\"])");
+  verify_skip_trusted(R"(["\\\"]\\"])");
+}
+
+BOOST_AUTO_TEST_CASE(json_skip_value_trusted_across_blocks) {
+  // Move the brackets, quotes and backslashes across the 64 byte blocks that
+  // the input is processed in, and compare with the validating skip_value.
+  for (size_t n = 0; n < 200; n++) {
+    const auto padding = std::string(n, ' ');
+    const auto json =
+        "[" + padding + R"({"a\\":"]\"}\\"},[[)" + padding + R"("\"",[]]],1)" +
+        std::string(n % 70, '1') + "]" + padding + "]";
+    BOOST_TEST_CONTEXT("n = " << n) {
+      verify_skip_value(json, padding.size() + 1);
+      verify_skip_trusted(json, padding.size() + 1);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_skip_value_trusted_should_not_validate_containers) {
+  verify_skip_trusted("[,]");
+  verify_skip_trusted(R"({true:false})");
+  verify_skip_trusted("[}");
+}
+
+BOOST_AUTO_TEST_CASE(json_skip_value_trusted_should_validate_other_values) {
+  verify_skip_trusted("true");
+  verify_skip_trusted(R"("\"[")");
+  verify_skip_trusted_fail("tru", "Unexpected end of input", 0);
+  verify_skip_trusted_fail("x", "Encountered token 'x'", 0);
+}
+
+BOOST_AUTO_TEST_CASE(json_skip_value_trusted_should_not_skip_unterminated_containers) {
+  verify_skip_trusted_fail("[12", "Expected ']'", 3);
+  verify_skip_trusted_fail(R"({"a":"}")", "Expected '}'", 8);
+  verify_skip_trusted_fail(R"({"a":[})", "Expected '}'", 7);
+  verify_skip_trusted_fail("[" + std::string(100, '[') + std::string(100, ']'), "Expected ']'", 201);
+}
+
 /*
  * Invalid JSON
  */
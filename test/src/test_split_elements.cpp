@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/detail/split_elements.hpp>
+#include <spotify/json/thread_pool.hpp>
+
+#include <spotify/json/test/instruction_sets.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+BOOST_AUTO_TEST_SUITE(detail)
+
+namespace {
+
+/**
+ * Find the separators of the container whose contents are json one byte at a
+ * time, or return false if the container does not end. Like the kernels, this
+ * only lets backslashes escape quotes, which makes a difference for invalid
+ * JSON only.
+ */
+bool reference_separators(const std::string &json, std::vector<size_t> &separators) {
+  size_t depth = 1;
+  auto in_string = false;
+  auto escape_next = false;
+  for (size_t i = 0; i < json.size(); i++) {
+    const auto c = json[i];
+    const auto escaped = escape_next;
+    escape_next = (c == '\\' && !escaped);
+    if (c == '"' && !escaped) {
+      in_string = !in_string;
+    } else if (in_string) {
+      continue;
+    } else if (c == '[' || c == '{') {
+      depth++;
+    } else if (c == ']' || c == '}') {
+      if (--depth == 0) {
+        separators.push_back(i);
+        return true;
+      }
+    } else if (c == ',' && depth == 1) {
+      separators.push_back(i);
+    }
+  }
+  return false;
+}
+
+void check_separators(thread_pool &pool, const std::string &json, const size_t chunk_size) {
+  std::vector<size_t> expected;
+  const auto expected_found = reference_separators(json, expected);
+
+  std::vector<const char *> separators;
+  const auto found = split_elements(json.data(), json.data() + json.size(), chunk_size, pool, separators);
+  BOOST_REQUIRE_EQUAL(found, expected_found);
+  if (found) {
+    std::vector<size_t> actual;
+    for (const auto separator : separators) {
+      actual.push_back(separator - json.data());
+    }
+    BOOST_CHECK_EQUAL_COLLECTIONS(actual.begin(), actual.end(), expected.begin(), expected.end());
+  }
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(json_split_elements_should_find_separators) {
+  thread_pool pool(4);
+  for_each_instruction_set([&] {
+    check_separators(pool, "]", 64);
+    check_separators(pool, " 1 , [2,3] ,{\"a\":4,\"b\":[5]} ] ,6", 64);
+    check_separators(pool, R"("],\"," , "\\" ] )", 64);
+    check_separators(pool, "[1,2]", 64);
+  });
+}
+
+BOOST_AUTO_TEST_CASE(json_split_elements_should_find_separators_across_chunks) {
+  thread_pool pool(4);
+  for_each_instruction_set([&] {
+    for (auto n = 0; n < 140; n++) {
+      const auto json =
+          "\"" + std::string(n, 'a') + "\\\\\" , [\"" + std::string(n, '\\') + "\"]" +
+          ", {\"" + std::string(n, ',') + "\":[" + std::string(n, '[') + "]}";
+      check_separators(pool, json, 64);
+      check_separators(pool, json, 128);
+    }
+  });
+}
+
+BOOST_AUTO_TEST_CASE(json_split_elements_should_find_more_separators_than_first_guess) {
+  thread_pool pool(4);
+  std::string json;
+  for (auto i = 0; i < 5000; i++) {
+    json += "1,";
+  }
+  json += "1]";
+  for_each_instruction_set([&] {
+    check_separators(pool, json, 64);
+    check_separators(pool, json, 4096);
+  });
+}
+
+BOOST_AUTO_TEST_CASE(json_split_elements_should_match_reference_on_random_input) {
+  thread_pool pool(4);
+  std::mt19937 random;
+  const std::string alphabet = "\"\\ \n{}[]:,,a1\xFF";
+  std::uniform_int_distribution<size_t> character(0, alphabet.size() - 1);
+  std::uniform_int_distribution<size_t> length(0, 600);
+  for (auto i = 0; i < 500; i++) {
+    std::string json(length(random), ' ');
+    for (auto &c : json) {
+      c = alphabet[character(random)];
+    }
+    for_each_instruction_set([&] { check_separators(pool, json, 64); });
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // detail
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
@@ -0,0 +1,276 @@
+/*
+ * Copyright (c) 2018 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/codec/static_object.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/decode.hpp>
+#include <spotify/json/default_codec.hpp>
+#include <spotify/json/encode.hpp>
+
+#include <spotify/json/test/exceptions.hpp>
+#include <spotify/json/test/only_true.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+
+namespace {
+
+template <typename Codec>
+typename Codec::object_type test_decode(const Codec &codec, const std::string &json) {
+  decode_context c(json.c_str(), json.c_str() + json.size());
+  auto obj = codec.decode(c);
+  BOOST_CHECK_EQUAL(c.position, c.end);
+  return obj;
+}
+
+template <typename Codec>
+void test_decode_fail(const Codec &codec, const std::string &json) {
+  decode_context c(json.c_str(), json.c_str() + json.size());
+  BOOST_CHECK_THROW(codec.decode(c), decode_exception);
+}
+
+struct simple_t {
+  size_t size = 0;
+  std::string value;
+};
+
+struct example_t {
+  simple_t simple;
+  std::string value;
+};
+
+class getset_t {
+ public:
+  const std::string &get_value() const { return value; }
+  void set_value(const std::string &v) { value = v; }
+
+ private:
+  std::string value;
+};
+
+struct subclass_t : simple_t {};
+
+auto simple_codec() -> decltype(codec::static_object<simple_t>(
+    codec::optional_field(json_static_key("size"), &simple_t::size),
+    codec::required_field(json_static_key("value"), &simple_t::value))) {
+  return codec::static_object<simple_t>(
+      codec::optional_field(json_static_key("size"), &simple_t::size),
+      codec::required_field(json_static_key("value"), &simple_t::value));
+}
+
+}  // namespace
+
+template <>
+struct default_codec_t<simple_t> {
+  static decltype(simple_codec()) codec() {
+    return simple_codec();
+  }
+};
+
+BOOST_AUTO_TEST_SUITE(codec)
+
+/*
+ * Decoding
+ */
+
+BOOST_AUTO_TEST_CASE(json_codec_static_object_should_decode_fields) {
+  const auto simple = test_decode(simple_codec(), R"({"size":5,"value":"x"})");
+  BOOST_CHECK_EQUAL(simple.size, 5);
+  BOOST_CHECK_EQUAL(simple.value, "x");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_static_object_should_decode_fields_in_any_order) {
+  const auto simple = test_decode(simple_codec(), R"({ "value" : "x" , "size" : 5 })");
+  BOOST_CHECK_EQUAL(simple.size, 5);
+  BOOST_CHECK_EQUAL(simple.value, "x");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_static_object_should_require_required_fields) {
+  test_decode_fail(simple_codec(), R"({})");
+  test_decode_fail(simple_codec(), R"({"size":5})");
+  test_decode_fail(simple_codec(), R"({"size":5,"size":5})");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_static_object_should_overwrite_duplicate_fields) {
+  const auto simple = test_decode(simple_codec(), R"({"value":"x","value":"y"})");
+  BOOST_CHECK_EQUAL(simple.value, "y");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_static_object_should_decode_escaped_keys) {
+  const auto simple = test_decode(simple_codec(), R"({"valu\u0065":"x","\u0073ize":5})");
+  BOOST_CHECK_EQUAL(simple.size, 5);
+  BOOST_CHECK_EQUAL(simple.value, "x");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_static_object_should_decode_after_first_key) {
+  const std::string json = R"({"value":"y","size":5})";
+  decode_context c(json.data() + 9, json.data() + json.size());
+  const auto simple = simple_codec().decode_after_first_key(c, "value", 5);
+  BOOST_CHECK_EQUAL(c.position, c.end);
+  BOOST_CHECK_EQUAL(simple.value, "y");
+  BOOST_CHECK_EQUAL(simple.size, 5);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_static_object_should_skip_unknown_keys) {
+  const auto simple = test_decode(
+      simple_codec(), R"({"valu":1,"values":[1],"value":"x","s":{},"sizes":null})");
+  BOOST_CHECK_EQUAL(simple.size, 0);
+  BOOST_CHECK_EQUAL(simple.value, "x");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_static_object_should_not_decode_invalid_objects) {
+  test_decode_fail(simple_codec(), R"({"value":"x")");
+  test_decode_fail(simple_codec(), R"({"value:"x"})");
+  test_decode_fail(simple_codec(), R"({"value""x"})");
+  test_decode_fail(simple_codec(), R"({"value":"x",})");
+  test_decode_fail(simple_codec(), R"({value:"x"})");
+  test_decode_fail(simple_codec(), R"(["x"])");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_static_object_should_use_provided_codec) {
+  const auto other_simple_codec = codec::static_object<simple_t>(
+      codec::optional_field(json_static_key("other"), &simple_t::value));
+  const auto codec = codec::static_object<example_t>(
+      codec::required_field(json_static_key("s"), &example_t::simple, other_simple_codec));
+  const auto example = test_decode(codec, R"({"s":{"other":"Hello!"}})");
+  BOOST_CHECK_EQUAL(example.simple.value, "Hello!");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_static_object_should_decode_nested_objects) {
+  const auto codec = codec::static_object<example_t>(
+      codec::optional_field(json_static_key("simple"), &example_t::simple),
+      codec::required_field(json_static_key("value"), &example_t::value));
+  const auto example = test_decode(codec, R"({"simple":{"value":"x"},"value":"y"})");
+  BOOST_CHECK_EQUAL(example.simple.value, "x");
+  BOOST_CHECK_EQUAL(example.value, "y");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_static_object_should_decode_setter_field) {
+  const auto codec = codec::static_object<getset_t>(
+      codec::required_field(json_static_key("value"), &getset_t::get_value, &getset_t::set_value));
+  BOOST_CHECK_EQUAL(test_decode(codec, R"({"value":"x"})").get_value(), "x");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_static_object_should_work_with_base_class_member_ptr) {
+  const auto codec = codec::static_object<subclass_t>(
+      codec::optional_field(json_static_key("value"), &subclass_t::value));
+  BOOST_CHECK_EQUAL(test_decode(codec, R"({"value":"x"})").value, "x");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_static_object_should_decode_empty_field_list) {
+  const auto codec = codec::static_object<simple_t>();
+  const auto simple = test_decode(codec, R"({"value":"x"})");
+  BOOST_CHECK_EQUAL(simple.value, "");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_static_object_should_decode_into_existing_object) {
+  simple_t simple;
+  simple.size = 5;
+  simple.value = std::string(100, 'a');
+  const auto data = simple.value.data();
+
+  decode_into(simple_codec(), R"({"value":"x"})", simple);
+  BOOST_CHECK_EQUAL(simple.size, 0);  // not in the input, so reset
+  BOOST_CHECK_EQUAL(simple.value, "x");
+  BOOST_CHECK_EQUAL(simple.value.data(), data);
+}
+
+/*
+ * Encoding
+ */
+
+BOOST_AUTO_TEST_CASE(json_codec_static_object_should_encode_fields_in_provided_order) {
+  simple_t simple;
+  simple.size = 5;
+  simple.value = "x";
+  BOOST_CHECK_EQUAL(encode(simple_codec(), simple), R"({"size":5,"value":"x"})");
+  BOOST_CHECK_EQUAL(encode(simple), R"({"size":5,"value":"x"})");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_static_object_should_respect_should_encode) {
+  using data_t = std::pair<bool, bool>;
+  const auto data = data_t(true, false);
+
+  const auto codec = codec::static_object<data_t>(
+      codec::optional_field(json_static_key("first"), &data_t::first, only_true_t()),
+      codec::required_field(json_static_key("second"), &data_t::second, only_true_t()));
+  BOOST_CHECK_EQUAL(encode(codec, data), R"({"first":true})");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_static_object_should_encode_getter_field) {
+  const auto codec = codec::static_object<getset_t>(
+      codec::required_field(json_static_key("value"), &getset_t::get_value, &getset_t::set_value));
+  getset_t getset;
+  getset.set_value("x");
+  BOOST_CHECK_EQUAL(encode(codec, getset), R"({"value":"x"})");
+}
+
+/*
+ * Keys
+ */
+
+namespace {
+
+template <typename key_type>
+bool needs_escaping(key_type) {
+  return detail::static_key_needs_escaping<key_type>::value;
+}
+
+template <typename... key_types>
+bool have_duplicates(key_types...) {
+  return detail::static_keys_have_duplicates<key_types...>::value;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(json_codec_static_object_should_give_equal_keys_the_same_type) {
+  BOOST_CHECK((std::is_same<decltype(json_static_key("a")), decltype(json_static_key("a"))>::value));
+  BOOST_CHECK((!std::is_same<decltype(json_static_key("a")), decltype(json_static_key("ab"))>::value));
+  BOOST_CHECK((std::is_same<decltype(json_static_key("")), detail::static_key<>>::value));
+  BOOST_CHECK((std::is_same<decltype(json_static_key("ab")), detail::static_key<'a', 'b'>>::value));
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_static_object_should_accept_keys_of_64_characters) {
+  const auto key = json_static_key("0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef");
+  BOOST_CHECK(decltype(key)::size == 64);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_static_object_should_find_keys_that_need_escaping) {
+  BOOST_CHECK(!needs_escaping(json_static_key("a b")));
+  BOOST_CHECK(!needs_escaping(json_static_key("\xC3\xA5")));
+  BOOST_CHECK(needs_escaping(json_static_key("a\"b")));
+  BOOST_CHECK(needs_escaping(json_static_key("a\\b")));
+  BOOST_CHECK(needs_escaping(json_static_key("a\nb")));
+  BOOST_CHECK(needs_escaping(json_static_key("a\0b")));
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_static_object_should_find_duplicate_keys) {
+  BOOST_CHECK(!have_duplicates());
+  BOOST_CHECK(!have_duplicates(json_static_key("a"), json_static_key("b"), json_static_key("ab")));
+  BOOST_CHECK(have_duplicates(json_static_key("a"), json_static_key("b"), json_static_key("a")));
+  BOOST_CHECK(have_duplicates(json_static_key("b"), json_static_key("b")));
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // codec
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
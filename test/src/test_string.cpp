@@ -24,6 +24,8 @@
 #include <spotify/json/decode_exception.hpp>
 #include <spotify/json/encode.hpp>
 
+#include <spotify/json/test/exceptions.hpp>
+
 BOOST_AUTO_TEST_SUITE(spotify)
 BOOST_AUTO_TEST_SUITE(json)
 BOOST_AUTO_TEST_SUITE(codec)
@@ -349,6 +351,24 @@ BOOST_AUTO_TEST_CASE(json_codec_string_should_encode_long_string_with_special_ch
   BOOST_CHECK(encode(input_str) == expected_result);
 }
 
+/*
+ * Decoding Into Existing Strings
+ */
+
+BOOST_AUTO_TEST_CASE(json_codec_string_should_decode_into_existing_string) {
+  std::string value(100, 'x');
+  const auto capacity = value.capacity();
+  const auto data = value.data();
+
+  const auto codec = string();
+  decode_into(codec, R"("abc")", value);
+  BOOST_CHECK_EQUAL(value, "abc");
+  decode_into(codec, R"("a\nb\u00e5")", value);
+  BOOST_CHECK_EQUAL(value, "a\nb\xC3\xA5");
+  BOOST_CHECK_EQUAL(value.capacity(), capacity);
+  BOOST_CHECK_EQUAL(value.data(), data);
+}
+
 BOOST_AUTO_TEST_SUITE_END()  // codec
 BOOST_AUTO_TEST_SUITE_END()  // json
 BOOST_AUTO_TEST_SUITE_END()  // spotify
@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/codec/object.hpp>
+#include <spotify/json/codec/one_of.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/codec/string_view.hpp>
+#include <spotify/json/decode.hpp>
+#include <spotify/json/decode_exception.hpp>
+#include <spotify/json/encode.hpp>
+
+#include <spotify/json/test/exceptions.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+BOOST_AUTO_TEST_SUITE(codec)
+
+namespace {
+
+struct message_t {
+  json::string_view view;
+  std::string string;
+  int n = 0;
+};
+
+object_t<message_t> view_codec(const bool require_n) {
+  auto codec = object<message_t>();
+  codec.required("s", &message_t::view);
+  if (require_n) {
+    codec.required("n", &message_t::n);
+  }
+  return codec;
+}
+
+object_t<message_t> string_codec(const bool require_n) {
+  auto codec = object<message_t>();
+  codec.required("s", &message_t::string);
+  if (require_n) {
+    codec.required("n", &message_t::n);
+  }
+  return codec;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(json_codec_string_view_should_point_into_input) {
+  const std::string json = "\"hello\"";
+  const auto view = decode<json::string_view>(json);
+  BOOST_CHECK_EQUAL(view, json::string_view("hello"));
+  BOOST_CHECK(view.data() == json.data() + 1);
+  BOOST_CHECK_EQUAL(view.size(), 5);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_string_view_should_decode_empty_string) {
+  const auto view = decode<json::string_view>("\"\"");
+  BOOST_CHECK(view.empty());
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_string_view_should_decode_long_strings) {
+  const auto contents = std::string(1000, 'a');
+  const auto json = "\"" + contents + "\"";
+  const auto view = decode<json::string_view>(json);
+  BOOST_CHECK_EQUAL(std::string(view), contents);
+  BOOST_CHECK(view.data() == json.data() + 1);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_string_view_should_decode_array_of_views) {
+  const std::string json = "[\"a\",\"bc\",\"def\"]";
+  const auto views = decode<std::vector<json::string_view>>(json);
+  BOOST_REQUIRE_EQUAL(views.size(), 3);
+  BOOST_CHECK_EQUAL(views[0], json::string_view("a"));
+  BOOST_CHECK_EQUAL(views[1], json::string_view("bc"));
+  BOOST_CHECK_EQUAL(views[2], json::string_view("def"));
+  BOOST_CHECK(views[2].data() == json.data() + 11);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_string_view_should_not_decode_escapes_in_immutable_input) {
+  BOOST_CHECK_THROW(decode<json::string_view>("\"a\\nb\""), decode_exception);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_string_view_should_unescape_mutable_input_in_place) {
+  std::string json = "\"a\\nb\\\"c\\\\d\\/e\\tf\"";
+  const auto view = decode_in_situ<json::string_view>(json);
+  BOOST_CHECK_EQUAL(view, json::string_view("a\nb\"c\\d/e\tf"));
+  BOOST_CHECK(view.data() == json.data() + 1);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_string_view_should_unescape_unicode_in_place) {
+  std::string json = "\"\\u00e5\\u20AC\\uD83D\\uDE00x\"";
+  const auto view = decode_in_situ<json::string_view>(json);
+  BOOST_CHECK_EQUAL(view, json::string_view("\xC3\xA5\xE2\x82\xAC\xF0\x9F\x98\x80x"));
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_string_view_should_unescape_lone_high_surrogate_in_place) {
+  std::string json = "\"\\uD83D\\u0041\"";
+  const auto view = decode_in_situ<json::string_view>(json);
+  BOOST_CHECK_EQUAL(view, json::string_view("\xED\xA0\xBD" "A"));
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_string_view_should_unescape_array_elements_in_place) {
+  std::string json = "[\"a\\tb\",\"\\\"\",\"c\"]";
+  const auto views = decode_in_situ<std::vector<json::string_view>>(json);
+  BOOST_REQUIRE_EQUAL(views.size(), 3);
+  BOOST_CHECK_EQUAL(views[0], json::string_view("a\tb"));
+  BOOST_CHECK_EQUAL(views[1], json::string_view("\""));
+  BOOST_CHECK_EQUAL(views[2], json::string_view("c"));
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_string_view_should_not_unescape_in_alternatives_that_are_retried) {
+  std::string json = R"({"s":"ab\ncd\u0041xyz"})";
+  const auto message = decode_in_situ(one_of(view_codec(true), string_codec(false)), json);
+  BOOST_CHECK_EQUAL(message.string, "ab\ncdAxyz");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_string_view_should_unescape_in_last_alternative) {
+  std::string json = R"({"s":"ab\ncd\u0041xyz"})";
+  const auto message = decode_in_situ(one_of(string_codec(true), view_codec(false)), json);
+  BOOST_CHECK_EQUAL(message.view, json::string_view("ab\ncdAxyz"));
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_string_view_should_not_decode_invalid_strings) {
+  std::string unterminated = "\"a\\nb";
+  std::string invalid_escape = "\"a\\qb\"";
+  BOOST_CHECK_THROW(decode<json::string_view>("\"abc"), decode_exception);
+  BOOST_CHECK_THROW(decode<json::string_view>("abc"), decode_exception);
+  BOOST_CHECK_THROW(decode_in_situ<json::string_view>(unterminated), decode_exception);
+  BOOST_CHECK_THROW(decode_in_situ<json::string_view>(invalid_escape), decode_exception);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_string_view_should_encode_with_escapes) {
+  BOOST_CHECK_EQUAL(encode(json::string_view("a\"b\n")), "\"a\\\"b\\n\"");
+  BOOST_CHECK_EQUAL(encode(json::string_view()), "\"\"");
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // codec
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
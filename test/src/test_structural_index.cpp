@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/detail/structural_index.hpp>
+
+#include <spotify/json/test/instruction_sets.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+BOOST_AUTO_TEST_SUITE(detail)
+
+namespace {
+
+/**
+ * Byte at a time version of stage 1, to compare the block based one with.
+ */
+std::vector<uint32_t> reference_offsets(const std::string &json) {
+  std::vector<uint32_t> offsets;
+  auto escape_next = false;
+  auto in_string = false;
+  auto follows_separator = true;
+  for (uint32_t i = 0; i < json.size(); i++) {
+    const auto c = json[i];
+    const auto escaped = escape_next;
+    escape_next = (c == '\\' && !escaped);
+    const auto is_quote = (c == '"' && !escaped);
+    const auto is_space = (c == ' ' || c == '\t' || c == '\n' || c == '\r');
+    const auto is_operator = (c == '{' || c == '}' || c == '[' || c == ']' || c == ':' || c == ',');
+    if (is_quote) {
+      in_string = !in_string;
+    }
+    if ((is_quote && in_string) ||
+        (!in_string && is_operator) ||
+        (!in_string && !is_space && !is_operator && c != '"' && follows_separator)) {
+      offsets.push_back(i);
+    }
+    follows_separator = is_space || is_operator;
+  }
+  return offsets;
+}
+
+void check_offsets(const std::string &json) {
+  const structural_index index(json.data(), json.data() + json.size());
+  const auto expected = reference_offsets(json);
+  BOOST_CHECK_EQUAL_COLLECTIONS(
+      index.offsets().begin(), index.offsets().end(),
+      expected.begin(), expected.end());
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(json_structural_index_should_find_structurals) {
+  const std::string json = R"({"a": [1, true], "b\"": "x, y" , "c":null})";
+  for_each_instruction_set([&] {
+    const structural_index index(json.data(), json.data() + json.size());
+    const std::vector<uint32_t> expected = {
+        0, 1, 4, 6, 7, 8, 10, 14, 15, 17, 22, 24, 31, 33, 36, 37, 41 };
+    BOOST_CHECK_EQUAL_COLLECTIONS(
+        index.offsets().begin(), index.offsets().end(),
+        expected.begin(), expected.end());
+  });
+}
+
+BOOST_AUTO_TEST_CASE(json_structural_index_should_handle_empty_input) {
+  for_each_instruction_set([] {
+    const structural_index index(nullptr, nullptr);
+    BOOST_CHECK(index.offsets().empty());
+  });
+}
+
+BOOST_AUTO_TEST_CASE(json_structural_index_should_carry_state_across_blocks) {
+  for_each_instruction_set([] {
+    for (auto n = 0; n < 140; n++) {
+      check_offsets(std::string(n, ' ') + R"(["a b", "\\\\", "\\\"", {"x": 12345}])");
+      check_offsets("\"" + std::string(n, 'a') + R"(\\\"\\" , 1, "1,2")");
+      check_offsets("\"" + std::string(n, '\\') + "\" ,[1]\"");
+      check_offsets(std::string(n, '1') + " , " + std::string(n, '"') + " x");
+    }
+  });
+}
+
+BOOST_AUTO_TEST_CASE(json_structural_index_should_match_reference_on_random_input) {
+  std::mt19937 random;
+  const std::string alphabet = "\"\\ \n{}[]:,a1\xFF";
+  std::uniform_int_distribution<size_t> character(0, alphabet.size() - 1);
+  std::uniform_int_distribution<size_t> length(0, 300);
+  for (auto i = 0; i < 500; i++) {
+    std::string json(length(random), ' ');
+    for (auto &c : json) {
+      c = alphabet[character(random)];
+    }
+    for_each_instruction_set([&] { check_offsets(json); });
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_structural_index_should_grow_for_dense_input) {
+  for_each_instruction_set([] {
+    check_offsets(std::string(10000, ','));
+    check_offsets("[" + std::string(20000, '[') + std::string(20000, ']') + "]");
+  });
+}
+
+BOOST_AUTO_TEST_CASE(json_structural_index_should_use_memory_per_token) {
+  const auto json = "[" + std::string(1 << 20, ' ') + "1, 2]";
+  const structural_index index(json.data(), json.data() + json.size());
+  BOOST_CHECK_EQUAL(index.offsets().size(), 5);
+  BOOST_CHECK_LE(index.offsets().capacity(), 2 * index.offsets().size() + 128);
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // detail
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
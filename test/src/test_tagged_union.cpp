@@ -0,0 +1,271 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/codec/object.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/codec/tagged_union.hpp>
+#include <spotify/json/decode.hpp>
+#include <spotify/json/decode_exception.hpp>
+#include <spotify/json/encode.hpp>
+#include <spotify/json/encode_exception.hpp>
+
+#include <spotify/json/test/exceptions.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+BOOST_AUTO_TEST_SUITE(codec)
+
+namespace {
+
+struct media {
+  virtual ~media() = default;
+  std::string name;
+};
+
+struct track : media {
+  int duration = 0;
+};
+
+struct episode : media {
+  std::string show;
+};
+
+struct silence : media {};
+
+struct unregistered : media {};
+
+template <typename pointer_type>
+tagged_union_t<pointer_type> media_codec() {
+  auto track_codec = object<track>();
+  track_codec.optional("name", &track::name);
+  track_codec.optional("duration", &track::duration);
+
+  auto episode_codec = object<episode>();
+  episode_codec.optional("name", &episode::name);
+  episode_codec.optional("show", &episode::show);
+
+  auto codec = tagged_union<pointer_type>("type");
+  codec.add("track", track_codec);
+  codec.add("episode", episode_codec);
+  codec.add("silence", object<silence>());
+  return codec;
+}
+
+/**
+ * An object codec without decode_after_first_key, which tagged_union_t has to
+ * give the whole object.
+ */
+struct opaque_track_codec_t final {
+  using object_type = track;
+
+  opaque_track_codec_t() {
+    _codec.optional("name", &track::name);
+    _codec.optional("duration", &track::duration);
+  }
+
+  object_type decode(decode_context &context) const {
+    return _codec.decode(context);
+  }
+
+  void encode(encode_context &context, const object_type &value) const {
+    _codec.encode(context, value);
+  }
+
+ private:
+  object_t<track> _codec;
+};
+
+template <typename codec_type>
+typename codec_type::object_type test_decode(const codec_type &codec, const std::string &json) {
+  decode_context c(json.c_str(), json.c_str() + json.size());
+  auto obj = codec.decode(c);
+  BOOST_CHECK_EQUAL(c.position, c.end);
+  return obj;
+}
+
+template <typename codec_type>
+void test_decode_fail(
+    const codec_type &codec,
+    const std::string &json,
+    const std::string &error,
+    const size_t offset) {
+  decode_context c(json.c_str(), json.c_str() + json.size());
+  c.throw_on_failure = false;
+  codec.decode(c);
+  BOOST_CHECK(c.has_failed());
+  BOOST_CHECK_EQUAL(c.error(), error);
+  BOOST_CHECK_EQUAL(c.error_offset(), offset);
+}
+
+}  // namespace
+
+/*
+ * Decoding
+ */
+
+BOOST_AUTO_TEST_CASE(json_codec_tagged_union_should_decode_with_discriminator_first) {
+  const auto value = test_decode(
+      media_codec<std::shared_ptr<media>>(),
+      R"({"type":"track","name":"a","duration":5})");
+  const auto decoded = std::dynamic_pointer_cast<track>(value);
+  BOOST_REQUIRE(decoded);
+  BOOST_CHECK_EQUAL(decoded->name, "a");
+  BOOST_CHECK_EQUAL(decoded->duration, 5);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_tagged_union_should_decode_with_discriminator_last) {
+  const auto value = test_decode(
+      media_codec<std::shared_ptr<media>>(),
+      R"({ "name" : "b", "extra": [{"type":"track"}, "}"], "show":"c", "type" : "episode" })");
+  const auto decoded = std::dynamic_pointer_cast<episode>(value);
+  BOOST_REQUIRE(decoded);
+  BOOST_CHECK_EQUAL(decoded->name, "b");
+  BOOST_CHECK_EQUAL(decoded->show, "c");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_tagged_union_should_decode_with_discriminator_first_and_whitespace) {
+  const auto value = test_decode(
+      media_codec<std::shared_ptr<media>>(),
+      R"({ "type" : "episode" , "show" : "c" , "name" : "b" })");
+  const auto decoded = std::dynamic_pointer_cast<episode>(value);
+  BOOST_REQUIRE(decoded);
+  BOOST_CHECK_EQUAL(decoded->name, "b");
+  BOOST_CHECK_EQUAL(decoded->show, "c");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_tagged_union_should_decode_discriminator_field_of_class) {
+  struct tagged : media {
+    std::string type;
+  };
+
+  auto tagged_codec = object<tagged>();
+  tagged_codec.required("type", &tagged::type);
+  tagged_codec.optional("name", &tagged::name);
+  auto codec = tagged_union<std::shared_ptr<media>>("type");
+  codec.add("tagged", tagged_codec);
+
+  const auto first = std::dynamic_pointer_cast<tagged>(
+      test_decode(codec, R"({"type":"tagged","name":"a"})"));
+  BOOST_REQUIRE(first);
+  BOOST_CHECK_EQUAL(first->type, "tagged");
+  BOOST_CHECK_EQUAL(first->name, "a");
+
+  const auto last = std::dynamic_pointer_cast<tagged>(
+      test_decode(codec, R"({"name":"a","type":"tagged"})"));
+  BOOST_REQUIRE(last);
+  BOOST_CHECK_EQUAL(last->type, "tagged");
+  BOOST_CHECK_EQUAL(last->name, "a");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_tagged_union_should_decode_with_codec_without_decode_after_first_key) {
+  auto codec = tagged_union<std::shared_ptr<media>>("type");
+  codec.add("track", opaque_track_codec_t());
+  const auto decoded = std::dynamic_pointer_cast<track>(
+      test_decode(codec, R"({"type":"track","name":"a","duration":5})"));
+  BOOST_REQUIRE(decoded);
+  BOOST_CHECK_EQUAL(decoded->name, "a");
+  BOOST_CHECK_EQUAL(decoded->duration, 5);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_tagged_union_should_decode_escaped_discriminator) {
+  const auto value = test_decode(
+      media_codec<std::shared_ptr<media>>(),
+      R"({"ty\u0070e":"tr\u0061ck"})");
+  BOOST_CHECK(std::dynamic_pointer_cast<track>(value));
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_tagged_union_should_decode_unique_ptr) {
+  const auto value = test_decode(media_codec<std::unique_ptr<media>>(), R"({"type":"silence"})");
+  BOOST_CHECK(dynamic_cast<silence *>(value.get()));
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_tagged_union_should_decode_array_of_objects) {
+  const auto codec = array<std::vector<std::shared_ptr<media>>>(media_codec<std::shared_ptr<media>>());
+  const auto values = test_decode(codec, R"([{"type":"track"},{"type":"episode"}])");
+  BOOST_REQUIRE_EQUAL(values.size(), 2);
+  BOOST_CHECK(std::dynamic_pointer_cast<track>(values[0]));
+  BOOST_CHECK(std::dynamic_pointer_cast<episode>(values[1]));
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_tagged_union_should_not_decode_invalid_objects) {
+  const auto codec = media_codec<std::shared_ptr<media>>();
+  test_decode_fail(codec, R"({"type":"album"})", "Unknown discriminator value", 8);
+  test_decode_fail(codec, R"({"name":"a"})", "Missing discriminator field", 11);
+  test_decode_fail(codec, R"({})", "Missing discriminator field", 1);
+  test_decode_fail(codec, R"({"type":1})", "Unexpected input", 8);
+  test_decode_fail(codec, R"({"name":"a" "type":"track"})", "Unexpected input", 12);
+  test_decode_fail(codec, R"({"type":"track","duration":"a"})", "Invalid integer", 28);
+  test_decode_fail(codec, R"({"type":"track" "duration":5})", "Unexpected input", 16);
+  test_decode_fail(codec, R"({"type":"track",})", "Unexpected input", 16);
+  test_decode_fail(codec, R"({"type":"track")", "Unexpected end of input", 15);
+  test_decode_fail(codec, R"([])", "Unexpected input", 0);
+  test_decode_fail(codec, R"({"name":)", "Unexpected EOF", 8);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_tagged_union_should_throw_when_decoding_invalid_objects) {
+  BOOST_CHECK_THROW(
+      decode(media_codec<std::shared_ptr<media>>(), R"({"type":"album"})"),
+      decode_exception);
+}
+
+/*
+ * Encoding
+ */
+
+BOOST_AUTO_TEST_CASE(json_codec_tagged_union_should_encode_discriminator_first) {
+  auto value = std::make_shared<track>();
+  value->name = "a";
+  value->duration = 5;
+  BOOST_CHECK_EQUAL(
+      encode(media_codec<std::shared_ptr<media>>(), value),
+      R"({"type":"track","name":"a","duration":5})");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_tagged_union_should_encode_empty_object) {
+  const std::shared_ptr<media> value = std::make_shared<silence>();
+  BOOST_CHECK_EQUAL(encode(media_codec<std::shared_ptr<media>>(), value), R"({"type":"silence"})");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_tagged_union_should_encode_array_of_objects) {
+  const auto codec = array<std::vector<std::shared_ptr<media>>>(media_codec<std::shared_ptr<media>>());
+  const std::vector<std::shared_ptr<media>> values{
+      std::make_shared<episode>(), std::make_shared<silence>() };
+  BOOST_CHECK_EQUAL(
+      encode(codec, values),
+      R"([{"type":"episode","name":"","show":""},{"type":"silence"}])");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_tagged_union_should_not_encode_unregistered_type) {
+  const std::shared_ptr<media> value = std::make_shared<unregistered>();
+  BOOST_CHECK_THROW(encode(media_codec<std::shared_ptr<media>>(), value), encode_exception);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_tagged_union_should_not_encode_null) {
+  const std::shared_ptr<media> value;
+  BOOST_CHECK_THROW(encode(media_codec<std::shared_ptr<media>>(), value), encode_exception);
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // codec
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
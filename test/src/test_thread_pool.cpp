@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/thread_pool.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+
+namespace {
+
+/**
+ * Boost.Test is not thread safe, so this checks nothing itself, and can be
+ * called from any thread.
+ */
+bool covers_each_index_once(thread_pool &pool, const size_t count) {
+  std::vector<std::atomic<int>> calls(count);
+  for (auto &c : calls) {
+    c = 0;
+  }
+  std::atomic<bool> had_empty_range(false);
+  pool.parallel_for(count, [&](const size_t begin, const size_t end) {
+    if (begin >= end) {
+      had_empty_range = true;
+    }
+    for (auto i = begin; i < end; i++) {
+      calls[i]++;
+    }
+  });
+
+  for (size_t i = 0; i < count; i++) {
+    if (calls[i] != 1) {
+      return false;
+    }
+  }
+  return !had_empty_range;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(json_thread_pool_should_count_calling_thread) {
+  BOOST_CHECK_EQUAL(thread_pool(1).size(), 1);
+  BOOST_CHECK_EQUAL(thread_pool(4).size(), 4);
+  BOOST_CHECK_EQUAL(thread_pool(0).size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(json_thread_pool_should_call_each_index_once) {
+  for (const auto threads : { 1, 2, 3, 8 }) {
+    thread_pool pool(threads);
+    for (const auto count : { 0, 1, 2, 7, 100, 10000 }) {
+      BOOST_CHECK(covers_each_index_once(pool, count));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_thread_pool_should_steal_work) {
+  thread_pool pool(4);
+  std::atomic<size_t> threads_used(0);
+  pool.parallel_for(64, [&](const size_t begin, const size_t end) {
+    static thread_local bool counted = false;
+    if (!counted) {
+      counted = true;
+      threads_used++;
+    }
+    // The first quarter of the items, which is all in the part of the calling
+    // thread, is slow, so the other threads have to steal it to finish.
+    if (begin < 16) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(end - begin));
+    }
+  });
+  BOOST_CHECK_GT(threads_used, 1);
+}
+
+BOOST_AUTO_TEST_CASE(json_thread_pool_should_run_calls_from_several_threads) {
+  thread_pool pool(3);
+  std::atomic<int> failures(0);
+  std::vector<std::thread> callers;
+  for (auto i = 0; i < 4; i++) {
+    callers.emplace_back([&] {
+      for (auto j = 0; j < 20; j++) {
+        failures += !covers_each_index_once(pool, 500);
+      }
+    });
+  }
+  for (auto &caller : callers) {
+    caller.join();
+  }
+  BOOST_CHECK_EQUAL(failures, 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
@@ -80,6 +80,8 @@ BOOST_AUTO_TEST_CASE(json_codec_transform_should_decode) {
   BOOST_CHECK_EQUAL(result.value, "A");
 }
 
+#if json_has_exceptions
+
 BOOST_AUTO_TEST_CASE(json_codec_transform_should_update_offset_when_throwing_exception) {
   try {
     const auto fail = [](const std::string &) { throw decode_exception("test"); return my_type(); };
@@ -91,6 +93,21 @@ BOOST_AUTO_TEST_CASE(json_codec_transform_should_update_offset_when_throwing_exc
   }
 }
 
+BOOST_AUTO_TEST_CASE(json_codec_transform_should_record_exception_when_not_throwing) {
+  const auto fail = [](const std::string &) { throw decode_exception("test"); return my_type(); };
+  const auto codec = transform(&encodeTransform, fail);
+  const std::string json = " \"A\"";
+  decode_context c(json.data(), json.size());
+  c.throw_on_failure = false;
+  c.position++;
+  codec.decode(c);
+  BOOST_CHECK(c.has_failed());
+  BOOST_CHECK_EQUAL(c.error(), std::string("test"));
+  BOOST_CHECK_EQUAL(c.error_offset(), 1);
+}
+
+#endif  // json_has_exceptions
+
 /*
  * Encoding
  */
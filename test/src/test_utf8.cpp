@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/detail/utf8.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+BOOST_AUTO_TEST_SUITE(detail)
+
+namespace {
+
+size_t invalid_offset(const std::string &string) {
+  return find_invalid_utf8(string.data(), string.data() + string.size()) - string.data();
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(json_find_invalid_utf8_should_accept_valid_utf8) {
+  for (const auto &string : std::vector<std::string>{
+      "",
+      "abc",
+      u8"åäö",
+      u8"鸡 and €",
+      u8"\U0001F600",
+      "\x7F\xC2\x80\xDF\xBF\xE0\xA0\x80\xED\x9F\xBF\xEE\x80\x80\xF0\x90\x80\x80\xF4\x8F\xBF\xBF",
+      std::string(100, 'a') + u8"\U0010FFFF" + std::string(7, 'b') }) {
+    BOOST_CHECK_EQUAL(invalid_offset(string), string.size());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_find_invalid_utf8_should_find_invalid_sequences) {
+  BOOST_CHECK_EQUAL(invalid_offset("\x80"), 0);  // Continuation byte without lead byte
+  BOOST_CHECK_EQUAL(invalid_offset("a\xC0\x80"), 1);  // Overlong
+  BOOST_CHECK_EQUAL(invalid_offset("ab\xC1\xBF"), 2);  // Overlong
+  BOOST_CHECK_EQUAL(invalid_offset("\xE0\x9F\xBF"), 0);  // Overlong
+  BOOST_CHECK_EQUAL(invalid_offset("\xF0\x8F\xBF\xBF"), 0);  // Overlong
+  BOOST_CHECK_EQUAL(invalid_offset("\xED\xA0\x80"), 0);  // Surrogate
+  BOOST_CHECK_EQUAL(invalid_offset("\xF4\x90\x80\x80"), 0);  // Above U+10FFFF
+  BOOST_CHECK_EQUAL(invalid_offset("\xF5\x80\x80\x80"), 0);
+  BOOST_CHECK_EQUAL(invalid_offset("\xFF"), 0);
+  BOOST_CHECK_EQUAL(invalid_offset("\xC2" "a"), 0);  // Missing continuation byte
+  BOOST_CHECK_EQUAL(invalid_offset("\xE2\x82" "a"), 0);
+  BOOST_CHECK_EQUAL(invalid_offset("\xF0\x9F\x98" "a"), 0);
+}
+
+BOOST_AUTO_TEST_CASE(json_find_invalid_utf8_should_find_truncated_sequences) {
+  for (const std::string sequence : { "\xC3\xA5", "\xE2\x82\xAC", "\xF0\x9F\x98\x80" }) {
+    for (size_t n = 1; n < sequence.size(); n++) {
+      const auto string = std::string(n * 5, 'a') + sequence.substr(0, n);
+      BOOST_CHECK_EQUAL(invalid_offset(string), n * 5);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_find_invalid_utf8_should_find_invalid_byte_after_ascii) {
+  for (size_t n = 0; n < 40; n++) {
+    const auto string = std::string(n, 'a') + "\xFE" + std::string(n, 'b');
+    BOOST_CHECK_EQUAL(invalid_offset(string), n);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // detail
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify